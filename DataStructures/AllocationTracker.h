@@ -0,0 +1,277 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/// <summary>
+///     .     operator new,    malloc.
+/// </summary>
+struct AllocationStats
+{
+	/// <summary>
+	/// false       operator new (. DS_DEFINE_ALLOCATION_HOOKS),   .
+	/// </summary>
+	bool tracked = false;
+	size_t allocations = 0;
+	size_t deallocations = 0;
+	size_t bytes_allocated = 0;
+	/// <summary>
+	///        .
+	/// </summary>
+	size_t peak_bytes = 0;
+	/// <summary>
+	/// ,        (   ).
+	/// </summary>
+	size_t footprint_bytes = 0;
+	/// <summary>
+	/// false  footprint_bytes  :          .
+	/// </summary>
+	bool footprint_measured = false;
+};
+
+/// <summary>
+///    .    operator new/delete,  
+///      :
+/// <code>
+/// #define DS_DEFINE_ALLOCATION_HOOKS
+/// #include "AllocationTracker.h"
+/// </code>
+///   installed()  false    .
+/// </summary>
+/// <remarks>
+///       ;       .
+/// </remarks>
+class AllocationTracker
+{
+public:
+	/// <summary>
+	///  .
+	/// </summary>
+	struct Snapshot
+	{
+		size_t allocations = 0;
+		size_t deallocations = 0;
+		size_t bytes_allocated = 0;
+		size_t live_bytes = 0;
+		size_t peak_live_bytes = 0;
+	};
+
+private:
+	static inline std::atomic<bool> installed_{ false };
+	static inline std::atomic<size_t> allocations_{ 0 };
+	static inline std::atomic<size_t> deallocations_{ 0 };
+	static inline std::atomic<size_t> bytes_allocated_{ 0 };
+	static inline std::atomic<size_t> live_bytes_{ 0 };
+	static inline std::atomic<size_t> peak_live_bytes_{ 0 };
+
+public:
+	static bool installed()
+	{
+		return installed_.load(std::memory_order_relaxed);
+	}
+	static Snapshot snapshot()
+	{
+		Snapshot result;
+		result.allocations = allocations_.load(std::memory_order_relaxed);
+		result.deallocations = deallocations_.load(std::memory_order_relaxed);
+		result.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+		result.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+		result.peak_live_bytes = peak_live_bytes_.load(std::memory_order_relaxed);
+		return result;
+	}
+	/// <summary>
+	///         .
+	/// </summary>
+	static void reset_peak()
+	{
+		peak_live_bytes_.store(live_bytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	///   :        .
+	/// </summary>
+	static AllocationStats between(const Snapshot& before, const Snapshot& after)
+	{
+		AllocationStats stats;
+		stats.tracked = installed();
+		stats.allocations = after.allocations - before.allocations;
+		stats.deallocations = after.deallocations - before.deallocations;
+		stats.bytes_allocated = after.bytes_allocated - before.bytes_allocated;
+		stats.peak_bytes = after.peak_live_bytes > before.live_bytes ? after.peak_live_bytes - before.live_bytes : 0;
+		return stats;
+	}
+
+	static void on_allocate(size_t bytes)
+	{
+		allocations_.fetch_add(1, std::memory_order_relaxed);
+		bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+		size_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		size_t peak = peak_live_bytes_.load(std::memory_order_relaxed);
+		while (live > peak && !peak_live_bytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+	}
+	static void on_deallocate(size_t bytes)
+	{
+		deallocations_.fetch_add(1, std::memory_order_relaxed);
+		live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+	static void mark_installed()
+	{
+		installed_.store(true, std::memory_order_relaxed);
+	}
+};
+
+#if defined(DS_DEFINE_ALLOCATION_HOOKS)
+namespace allocation_hooks
+{
+	//      : operator delete    
+	//  live_bytes.   ,    .
+	inline size_t header_size(size_t alignment)
+	{
+		return alignment > alignof(std::max_align_t) ? alignment : alignof(std::max_align_t);
+	}
+
+	inline void* allocate(size_t size, size_t alignment, bool aligned) noexcept
+	{
+		size_t header = header_size(alignment);
+		//   size + header    aligned_alloc      .
+		if (size > static_cast<size_t>(PTRDIFF_MAX) - header)
+			return nullptr;
+		size_t total = size + header;
+#if defined(_MSC_VER)
+		void* base = aligned ? _aligned_malloc(total, alignment) : std::malloc(total);
+#else
+		void* base = aligned ? std::aligned_alloc(alignment, (total + alignment - 1) / alignment * alignment) : std::malloc(total);
+#endif
+		if (!base)
+			return nullptr;
+		char* user = static_cast<char*>(base) + header;
+		reinterpret_cast<size_t*>(user)[-1] = size;
+		AllocationTracker::on_allocate(size);
+		return user;
+	}
+	inline void deallocate(void* pointer, size_t alignment, bool aligned) noexcept
+	{
+		if (!pointer)
+			return;
+		char* user = static_cast<char*>(pointer);
+		AllocationTracker::on_deallocate(reinterpret_cast<size_t*>(user)[-1]);
+		void* base = user - header_size(alignment);
+#if defined(_MSC_VER)
+		if (aligned)
+			_aligned_free(base);
+		else
+			std::free(base);
+#else
+		(void)aligned;
+		std::free(base);
+#endif
+	}
+	inline void* allocate_or_throw(size_t size, size_t alignment, bool aligned)
+	{
+		for (;;)
+		{
+			if (void* pointer = allocate(size, alignment, aligned))
+				return pointer;
+			std::new_handler handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	struct Installer
+	{
+		Installer()
+		{
+			AllocationTracker::mark_installed();
+		}
+	};
+	inline Installer installer;
+}
+
+void* operator new(size_t size)
+{
+	return allocation_hooks::allocate_or_throw(size, 0, false);
+}
+void* operator new[](size_t size)
+{
+	return allocation_hooks::allocate_or_throw(size, 0, false);
+}
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return allocation_hooks::allocate_or_throw(size, static_cast<size_t>(alignment), true);
+}
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return allocation_hooks::allocate_or_throw(size, static_cast<size_t>(alignment), true);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocation_hooks::allocate(size, 0, false);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocation_hooks::allocate(size, 0, false);
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocation_hooks::allocate(size, static_cast<size_t>(alignment), true);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocation_hooks::allocate(size, static_cast<size_t>(alignment), true);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	allocation_hooks::deallocate(pointer, 0, false);
+}
+void operator delete[](void* pointer) noexcept
+{
+	allocation_hooks::deallocate(pointer, 0, false);
+}
+void operator delete(void* pointer, size_t) noexcept
+{
+	allocation_hooks::deallocate(pointer, 0, false);
+}
+void operator delete[](void* pointer, size_t) noexcept
+{
+	allocation_hooks::deallocate(pointer, 0, false);
+}
+void operator delete(void* pointer, std::align_val_t alignment) noexcept
+{
+	allocation_hooks::deallocate(pointer, static_cast<size_t>(alignment), true);
+}
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+	allocation_hooks::deallocate(pointer, static_cast<size_t>(alignment), true);
+}
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+	allocation_hooks::deallocate(pointer, static_cast<size_t>(alignment), true);
+}
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+	allocation_hooks::deallocate(pointer, static_cast<size_t>(alignment), true);
+}
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	allocation_hooks::deallocate(pointer, 0, false);
+}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	allocation_hooks::deallocate(pointer, 0, false);
+}
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	allocation_hooks::deallocate(pointer, static_cast<size_t>(alignment), true);
+}
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	allocation_hooks::deallocate(pointer, static_cast<size_t>(alignment), true);
+}
+#endif
@@ -0,0 +1,159 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/// <summary>
+///      B-   .    T  operator&lt;.
+/// </summary>
+/// <typeparam name="T">  .</typeparam>
+template<class T>
+struct BinaryKeySearch
+{
+	/// <summary>
+	///   ,   value.
+	/// </summary>
+	static size_t lower_bound(const T* keys, size_t count, const T& value)
+	{
+		return std::lower_bound(keys, keys + count, value) - keys;
+	}
+	/// <summary>
+	///   ,   value.
+	/// </summary>
+	static size_t upper_bound(const T* keys, size_t count, const T& value)
+	{
+		return std::upper_bound(keys, keys + count, value) - keys;
+	}
+};
+
+/// <summary>
+///      :       
+///   -,         ( ) value.
+///    AVX2     int32_t, int64_t, float  double;  
+///    ,     .
+/// </summary>
+/// <typeparam name="T">  .</typeparam>
+template<class T>
+struct SimdKeySearch
+{
+	static_assert(std::is_arithmetic_v<T>, "SimdKeySearch requires an arithmetic key type");
+
+	/// <summary>
+	///   ( ),       .
+	/// </summary>
+	static constexpr size_t block = 128 / sizeof(T) > 4 ? 128 / sizeof(T) : 4;
+
+	/// <summary>
+	/// true    T    AVX2 (  -mavx2  -march  AVX2).
+	/// </summary>
+#if defined(__AVX2__)
+	static constexpr bool vectorized = (std::is_integral_v<T> && std::is_signed_v<T> && (sizeof(T) == 4 || sizeof(T) == 8))
+		|| std::is_same_v<T, double> || std::is_same_v<T, float>;
+#else
+	static constexpr bool vectorized = false;
+#endif
+
+	/// <summary>
+	///   ,   value.
+	/// </summary>
+	static size_t lower_bound(const T* keys, size_t count, const T& value)
+	{
+		const T* first = keys;
+		while (count > block)
+		{
+			size_t half = count / 2;
+			first = (first[half - 1] < value) ? first + half : first;
+			count -= half;
+		}
+		return (first - keys) + count_less(first, count, value);
+	}
+	/// <summary>
+	///   ,   value.
+	/// </summary>
+	static size_t upper_bound(const T* keys, size_t count, const T& value)
+	{
+		const T* first = keys;
+		while (count > block)
+		{
+			size_t half = count / 2;
+			first = !(value < first[half - 1]) ? first + half : first;
+			count -= half;
+		}
+		return (first - keys) + count_less_equal(first, count, value);
+	}
+
+	/// <summary>
+	///  ,   value.
+	/// </summary>
+	static size_t count_less(const T* keys, size_t count, T value)
+	{
+		size_t result = 0;
+		size_t i = 0;
+#if defined(__AVX2__)
+		if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8)
+		{
+			__m256i needle = _mm256_set1_epi64x(static_cast<long long>(value));
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+				result += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, v)))));
+			}
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4)
+		{
+			__m256i needle = _mm256_set1_epi32(static_cast<int>(value));
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+				result += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, v)))));
+			}
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			__m256d needle = _mm256_set1_pd(value);
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256d v = _mm256_loadu_pd(keys + i);
+				result += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(v, needle, _CMP_LT_OQ))));
+			}
+		}
+		else if constexpr (std::is_same_v<T, float>)
+		{
+			__m256 needle = _mm256_set1_ps(value);
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 v = _mm256_loadu_ps(keys + i);
+				result += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, needle, _CMP_LT_OQ))));
+			}
+		}
+#endif
+		for (; i < count; ++i)
+			result += keys[i] < value;
+		return result;
+	}
+	/// <summary>
+	///  ,   value.
+	/// </summary>
+	static size_t count_less_equal(const T* keys, size_t count, T value)
+	{
+		if constexpr (std::is_integral_v<T>)
+		{
+			if (value == std::numeric_limits<T>::max())
+				return count;
+			return count_less(keys, count, static_cast<T>(value + 1));
+		}
+		else
+		{
+			size_t result = 0;
+			for (size_t i = 0; i < count; ++i)
+				result += !(value < keys[i]);
+			return result;
+		}
+	}
+};
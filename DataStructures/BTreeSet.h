@@ -0,0 +1,891 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+#include "BTreeKeySearch.h"
+
+/// <summary>
+///     B+    .      ,
+///            ,   - .
+///   RBTree,    .
+/// </summary>
+/// <typeparam name="T"> ;     ,     operator&lt;.</typeparam>
+/// <typeparam name="NodeBytes">      (, 256  4096).</typeparam>
+/// <typeparam name="KeySearch">      (. BTreeKeySearch.h).</typeparam>
+template <class T, size_t NodeBytes = 256, class KeySearch = BinaryKeySearch<T>>
+class BTreeSet
+{
+private:
+    /// <summary>
+    ///     .         .
+    /// </summary>
+    static constexpr size_t fit(size_t slot_bytes)
+    {
+        constexpr size_t header_bytes = 40;
+        return NodeBytes > header_bytes + 4 * slot_bytes ? (NodeBytes - header_bytes) / slot_bytes - 1 : 3;
+    }
+
+public:
+    /// <summary>
+    ///     .
+    /// </summary>
+    static constexpr size_t leaf_capacity = fit(sizeof(T));
+    /// <summary>
+    ///      .
+    /// </summary>
+    static constexpr size_t inner_capacity = fit(sizeof(T) + sizeof(void*));
+
+private:
+    static constexpr size_t leaf_min = leaf_capacity / 2;
+    static constexpr size_t inner_min = inner_capacity / 2;
+
+    /// <summary>
+    ///   :     .
+    /// </summary>
+    struct Node
+    {
+        uint32_t count;
+        bool is_leaf;
+
+        explicit Node(bool leaf) : count(0), is_leaf(leaf) {}
+    };
+    /// <summary>
+    /// :           .
+    /// </summary>
+    struct Leaf : Node
+    {
+        Leaf* prev;
+        Leaf* next;
+        T keys[leaf_capacity + 1];
+
+        Leaf() : Node(true), prev(nullptr), next(nullptr) {}
+    };
+    /// <summary>
+    ///  :  keys[i] ,    children[i]  keys[i],    children[i + 1]   keys[i].
+    /// </summary>
+    struct Inner : Node
+    {
+        T keys[inner_capacity + 1];
+        Node* children[inner_capacity + 2];
+
+        Inner() : Node(false) {}
+    };
+
+    Node* root;
+    Leaf* first_leaf;
+    Leaf* last_leaf;
+    size_t tree_size;
+
+    /// <summary>
+    ///   :        , end()   .
+    /// </summary>
+    class iterator_base
+    {
+    protected:
+        Leaf* leaf;
+        size_t index;
+        const BTreeSet* tree;
+
+        iterator_base(Leaf* l, size_t i, const BTreeSet* t) : leaf(l), index(i), tree(t) {}
+
+    public:
+        iterator_base() : leaf(nullptr), index(0), tree(nullptr) {}
+
+        bool operator==(const iterator_base& other) const
+        {
+            return leaf == other.leaf && index == other.index;
+        }
+
+        bool operator!=(const iterator_base& other) const
+        {
+            return !(*this == other);
+        }
+
+        iterator_base& increment()
+        {
+            if (!leaf) return *this;
+
+            if (++index == leaf->count)
+            {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        iterator_base& decrement()
+        {
+            if (!leaf)
+            {
+                leaf = tree ? tree->last_leaf : nullptr;
+                index = leaf ? leaf->count - 1 : 0;
+                return *this;
+            }
+
+            if (index > 0)
+            {
+                --index;
+            }
+            else
+            {
+                leaf = leaf->prev;
+                index = leaf ? leaf->count - 1 : 0;
+            }
+            return *this;
+        }
+    };
+public:
+    /// <summary>
+    ///        .
+    /// </summary>
+    class iterator : public iterator_base
+    {
+        friend class BTreeSet;
+    public:
+        iterator() = default;
+        iterator(Leaf* l, size_t i, const BTreeSet* t) : iterator_base(l, i, t) {}
+
+        T& operator*() const
+        {
+            return this->leaf->keys[this->index];
+        }
+        T* operator->() const
+        {
+            return &this->leaf->keys[this->index];
+        }
+        iterator& operator++()
+        {
+            this->increment();
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            this->increment();
+            return tmp;
+        }
+        iterator& operator--()
+        {
+            this->decrement();
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator tmp = *this;
+            this->decrement();
+            return tmp;
+        }
+    };
+    /// <summary>
+    ///         .
+    /// </summary>
+    class const_iterator : public iterator_base
+    {
+        friend class BTreeSet;
+    public:
+        const_iterator() = default;
+        const_iterator(Leaf* l, size_t i, const BTreeSet* t) : iterator_base(l, i, t) {}
+        const_iterator(const iterator& it) : iterator_base(it.leaf, it.index, it.tree) {}
+
+        const T& operator*() const
+        {
+            return this->leaf->keys[this->index];
+        }
+        const T* operator->() const
+        {
+            return &this->leaf->keys[this->index];
+        }
+        const_iterator& operator++()
+        {
+            this->increment();
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            this->increment();
+            return tmp;
+        }
+        const_iterator& operator--()
+        {
+            this->decrement();
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator tmp = *this;
+            this->decrement();
+            return tmp;
+        }
+    };
+
+    /// <summary>
+    ///   .   .
+    /// </summary>
+    BTreeSet() : root(nullptr), first_leaf(nullptr), last_leaf(nullptr), tree_size(0) {}
+    /// <summary>
+    ///  :    other.
+    /// </summary>
+    BTreeSet(const BTreeSet& other) : BTreeSet()
+    {
+        for (const auto& value : other)
+            insert(value);
+    }
+    /// <summary>
+    ///  :   other,   .
+    /// </summary>
+    BTreeSet(BTreeSet&& other) noexcept
+        : root(other.root), first_leaf(other.first_leaf), last_leaf(other.last_leaf), tree_size(other.tree_size)
+    {
+        other.root = nullptr;
+        other.first_leaf = other.last_leaf = nullptr;
+        other.tree_size = 0;
+    }
+    /// <summary>
+    ///     .
+    /// </summary>
+    BTreeSet(std::initializer_list<T> init_list) : BTreeSet()
+    {
+        for (const auto& value : init_list)
+            insert(value);
+    }
+    /// <summary>
+    ///     [first, last).
+    /// </summary>
+    template<class It>
+    BTreeSet(It first, It last) : BTreeSet()
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+    /// <summary>
+    /// :   .
+    /// </summary>
+    ~BTreeSet()
+    {
+        clear();
+    }
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    size_t size() const
+    {
+        return tree_size;
+    }
+    /// <summary>
+    /// ,   .
+    /// </summary>
+    bool empty() const
+    {
+        return tree_size == 0;
+    }
+    /// <summary>
+    ///      .
+    /// </summary>
+    void clear()
+    {
+        destroy(root);
+        root = nullptr;
+        first_leaf = last_leaf = nullptr;
+        tree_size = 0;
+    }
+    /// <summary>
+    /// ,     .
+    /// </summary>
+    bool contains(const T& value) const
+    {
+        return find(value) != cend();
+    }
+
+    /// <summary>
+    ///  ,      .
+    /// </summary>
+    /// <param name="value"> .</param>
+    void insert(const T& value)
+    {
+        insert_it(value);
+    }
+    /// <summary>
+    ///      .
+    /// </summary>
+    /// <param name="value"> .</param>
+    /// <returns>        true,   .</returns>
+    std::pair<iterator, bool> insert_it(const T& value)
+    {
+        if (!root)
+        {
+            Leaf* leaf = new Leaf();
+            leaf->keys[0] = value;
+            leaf->count = 1;
+            root = first_leaf = last_leaf = leaf;
+            tree_size = 1;
+            return { iterator(leaf, 0, this), true };
+        }
+
+        Node* split_right = nullptr;
+        T split_key{};
+        Leaf* pos_leaf = nullptr;
+        size_t pos_index = 0;
+        bool inserted = insert_rec(root, value, split_right, split_key, pos_leaf, pos_index);
+
+        if (split_right)
+        {
+            Inner* new_root = new Inner();
+            new_root->count = 1;
+            new_root->keys[0] = split_key;
+            new_root->children[0] = root;
+            new_root->children[1] = split_right;
+            root = new_root;
+        }
+        if (inserted)
+            ++tree_size;
+
+        return { iterator(pos_leaf, pos_index, this), inserted };
+    }
+    /// <summary>
+    ///    ,      .
+    /// </summary>
+    /// <param name="value"> .</param>
+    /// <returns>true -  , false -   .</returns>
+    bool erase(const T& value)
+    {
+        if (!root || !erase_rec(root, value))
+            return false;
+
+        --tree_size;
+        if (root->is_leaf && root->count == 0)
+        {
+            destroy(root);
+            root = nullptr;
+            first_leaf = last_leaf = nullptr;
+        }
+        else if (!root->is_leaf && root->count == 0)
+        {
+            Inner* old_root = static_cast<Inner*>(root);
+            root = old_root->children[0];
+            delete old_root;
+        }
+        return true;
+    }
+    /// <summary>
+    ///  ,    .
+    /// </summary>
+    /// <param name="it">   .  it  end(),   .</param>
+    /// <returns>  ,   .</returns>
+    iterator erase(iterator it)
+    {
+        if (it == end())
+            return it;
+
+        T value = *it;
+        erase(value);
+        return lower_bound(value);
+    }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    /// <returns>     end().</returns>
+    iterator find(const T& value)
+    {
+        iterator it = lower_bound(value);
+        if (it != end() && !(value < *it))
+            return it;
+        return end();
+    }
+    /// <summary>
+    ///    .
+    /// </summary>
+    /// <returns>      cend().</returns>
+    const_iterator find(const T& value) const
+    {
+        const_iterator it = lower_bound(value);
+        if (it != cend() && !(value < *it))
+            return it;
+        return cend();
+    }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    iterator begin()
+    {
+        return first_leaf ? iterator(first_leaf, 0, this) : end();
+    }
+    /// <summary>
+    ///      .
+    /// </summary>
+    iterator end()
+    {
+        return iterator(nullptr, 0, this);
+    }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+    /// <summary>
+    ///     .
+    /// </summary>
+    const_iterator cbegin() const
+    {
+        return first_leaf ? const_iterator(first_leaf, 0, this) : cend();
+    }
+    /// <summary>
+    ///       .
+    /// </summary>
+    const_iterator cend() const
+    {
+        return const_iterator(nullptr, 0, this);
+    }
+
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    iterator lower_bound(const T& value)
+    {
+        auto [leaf, index] = bound(value, false);
+        return iterator(leaf, index, this);
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    const_iterator lower_bound(const T& value) const
+    {
+        auto [leaf, index] = bound(value, false);
+        return const_iterator(leaf, index, this);
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    iterator upper_bound(const T& value)
+    {
+        auto [leaf, index] = bound(value, true);
+        return iterator(leaf, index, this);
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    const_iterator upper_bound(const T& value) const
+    {
+        auto [leaf, index] = bound(value, true);
+        return const_iterator(leaf, index, this);
+    }
+    /// <summary>
+    ///   [lower_bound(value), upper_bound(value)).
+    /// </summary>
+    std::pair<iterator, iterator> equal_range(const T& value)
+    {
+        return { lower_bound(value), upper_bound(value) };
+    }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    void swap(BTreeSet& other) noexcept
+    {
+        std::swap(root, other.root);
+        std::swap(first_leaf, other.first_leaf);
+        std::swap(last_leaf, other.last_leaf);
+        std::swap(tree_size, other.tree_size);
+    }
+    /// <summary>
+    ///    std::cout  .
+    /// </summary>
+    void print() const
+    {
+        for (auto it = cbegin(); it != cend(); ++it)
+            std::cout << *it << " ";
+    }
+
+    /// <summary>
+    ///   :  ,  ,  ,
+    ///   ,     .
+    /// </summary>
+    /// <returns>true,   .</returns>
+    bool validate() const
+    {
+        if (!root)
+            return tree_size == 0 && !first_leaf && !last_leaf;
+
+        int leaf_depth = -1;
+        size_t counted = 0;
+        if (!validate_node(root, nullptr, nullptr, 0, leaf_depth, counted))
+            return false;
+        if (counted != tree_size)
+            return false;
+
+        size_t chained = 0;
+        const Leaf* prev = nullptr;
+        for (const Leaf* leaf = first_leaf; leaf; leaf = leaf->next)
+        {
+            if (leaf->prev != prev)
+                return false;
+            if (prev && !(prev->keys[prev->count - 1] < leaf->keys[0]))
+                return false;
+            chained += leaf->count;
+            prev = leaf;
+        }
+        return prev == last_leaf && chained == tree_size;
+    }
+
+    BTreeSet& operator=(const BTreeSet& other)
+    {
+        if (this == &other) return *this;
+        clear();
+        for (const auto& value : other)
+            insert(value);
+        return *this;
+    }
+    BTreeSet& operator=(BTreeSet&& other) noexcept
+    {
+        if (this == &other) return *this;
+        clear();
+        swap(other);
+        return *this;
+    }
+    bool operator==(const BTreeSet& other) const
+    {
+        if (size() != other.size()) return false;
+        return std::equal(begin(), end(), other.begin());
+    }
+
+private:
+    /// <summary>
+    ///    ,   value.
+    /// </summary>
+    static size_t key_lower_bound(const T* keys, size_t count, const T& value)
+    {
+        return KeySearch::lower_bound(keys, count, value);
+    }
+    /// <summary>
+    ///    ,   value.
+    /// </summary>
+    static size_t key_upper_bound(const T* keys, size_t count, const T& value)
+    {
+        return KeySearch::upper_bound(keys, count, value);
+    }
+
+    /// <summary>
+    ///   ,    value,        .
+    ///      ,      .
+    /// </summary>
+    std::pair<Leaf*, size_t> bound(const T& value, bool upper) const
+    {
+        if (!root) return { nullptr, 0 };
+
+        Node* node = root;
+        while (!node->is_leaf)
+        {
+            Inner* inner = static_cast<Inner*>(node);
+            node = inner->children[key_upper_bound(inner->keys, inner->count, value)];
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+        size_t index = upper
+            ? key_upper_bound(leaf->keys, leaf->count, value)
+            : key_lower_bound(leaf->keys, leaf->count, value);
+        if (index == leaf->count)
+            return { leaf->next, 0 };
+        return { leaf, index };
+    }
+
+    /// <summary>
+    ///     node.
+    /// </summary>
+    /// <param name="split_right"> node         .</param>
+    /// <param name="split_key">  node  split_right.</param>
+    /// <param name="pos_leaf">,       .</param>
+    /// <param name="pos_index">   pos_leaf.</param>
+    /// <returns>true,    .</returns>
+    bool insert_rec(Node* node, const T& value, Node*& split_right, T& split_key, Leaf*& pos_leaf, size_t& pos_index)
+    {
+        if (node->is_leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t i = key_lower_bound(leaf->keys, leaf->count, value);
+            pos_leaf = leaf;
+            pos_index = i;
+            if (i < leaf->count && !(value < leaf->keys[i]))
+                return false;
+
+            std::move_backward(leaf->keys + i, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            leaf->keys[i] = value;
+            ++leaf->count;
+
+            if (leaf->count > leaf_capacity)
+            {
+                Leaf* right = split_leaf(leaf);
+                split_right = right;
+                split_key = right->keys[0];
+                if (i >= leaf->count)
+                {
+                    pos_leaf = right;
+                    pos_index = i - leaf->count;
+                }
+            }
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        size_t idx = key_upper_bound(inner->keys, inner->count, value);
+        Node* child_split = nullptr;
+        T child_key{};
+        bool inserted = insert_rec(inner->children[idx], value, child_split, child_key, pos_leaf, pos_index);
+
+        if (child_split)
+        {
+            std::move_backward(inner->keys + idx, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::move_backward(inner->children + idx + 1, inner->children + inner->count + 1, inner->children + inner->count + 2);
+            inner->keys[idx] = child_key;
+            inner->children[idx + 1] = child_split;
+            ++inner->count;
+
+            if (inner->count > inner_capacity)
+                split_right = split_inner(inner, split_key);
+        }
+        return inserted;
+    }
+    /// <summary>
+    ///           .
+    /// </summary>
+    Leaf* split_leaf(Leaf* leaf)
+    {
+        Leaf* right = new Leaf();
+        size_t keep = leaf->count / 2;
+        std::move(leaf->keys + keep, leaf->keys + leaf->count, right->keys);
+        right->count = leaf->count - keep;
+        leaf->count = static_cast<uint32_t>(keep);
+
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next)
+            leaf->next->prev = right;
+        else
+            last_leaf = right;
+        leaf->next = right;
+        return right;
+    }
+    /// <summary>
+    ///    :       split_key.
+    /// </summary>
+    Inner* split_inner(Inner* inner, T& split_key)
+    {
+        Inner* right = new Inner();
+        size_t mid = inner->count / 2;
+        split_key = inner->keys[mid];
+
+        std::move(inner->keys + mid + 1, inner->keys + inner->count, right->keys);
+        std::copy(inner->children + mid + 1, inner->children + inner->count + 1, right->children);
+        right->count = inner->count - static_cast<uint32_t>(mid) - 1;
+        inner->count = static_cast<uint32_t>(mid);
+        return right;
+    }
+
+    /// <summary>
+    ///     node;      .
+    /// </summary>
+    bool erase_rec(Node* node, const T& value)
+    {
+        if (node->is_leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t i = key_lower_bound(leaf->keys, leaf->count, value);
+            if (i == leaf->count || value < leaf->keys[i])
+                return false;
+
+            std::move(leaf->keys + i + 1, leaf->keys + leaf->count, leaf->keys + i);
+            --leaf->count;
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        size_t idx = key_upper_bound(inner->keys, inner->count, value);
+        if (!erase_rec(inner->children[idx], value))
+            return false;
+
+        if (inner->children[idx]->count < min_count(inner->children[idx]))
+            rebalance(inner, idx);
+        return true;
+    }
+    static size_t min_count(const Node* node)
+    {
+        return node->is_leaf ? leaf_min : inner_min;
+    }
+    /// <summary>
+    ///    parent->children[idx]:        .
+    /// </summary>
+    void rebalance(Inner* parent, size_t idx)
+    {
+        if (idx > 0 && parent->children[idx - 1]->count > min_count(parent->children[idx - 1]))
+            borrow_from_left(parent, idx);
+        else if (idx < parent->count && parent->children[idx + 1]->count > min_count(parent->children[idx + 1]))
+            borrow_from_right(parent, idx);
+        else if (idx > 0)
+            merge(parent, idx - 1);
+        else
+            merge(parent, idx);
+    }
+    void borrow_from_left(Inner* parent, size_t idx)
+    {
+        Node* left_node = parent->children[idx - 1];
+        Node* right_node = parent->children[idx];
+
+        if (right_node->is_leaf)
+        {
+            Leaf* left = static_cast<Leaf*>(left_node);
+            Leaf* right = static_cast<Leaf*>(right_node);
+            std::move_backward(right->keys, right->keys + right->count, right->keys + right->count + 1);
+            right->keys[0] = left->keys[left->count - 1];
+            --left->count;
+            ++right->count;
+            parent->keys[idx - 1] = right->keys[0];
+        }
+        else
+        {
+            Inner* left = static_cast<Inner*>(left_node);
+            Inner* right = static_cast<Inner*>(right_node);
+            std::move_backward(right->keys, right->keys + right->count, right->keys + right->count + 1);
+            std::move_backward(right->children, right->children + right->count + 1, right->children + right->count + 2);
+            right->keys[0] = parent->keys[idx - 1];
+            right->children[0] = left->children[left->count];
+            parent->keys[idx - 1] = left->keys[left->count - 1];
+            --left->count;
+            ++right->count;
+        }
+    }
+    void borrow_from_right(Inner* parent, size_t idx)
+    {
+        Node* left_node = parent->children[idx];
+        Node* right_node = parent->children[idx + 1];
+
+        if (left_node->is_leaf)
+        {
+            Leaf* left = static_cast<Leaf*>(left_node);
+            Leaf* right = static_cast<Leaf*>(right_node);
+            left->keys[left->count] = right->keys[0];
+            ++left->count;
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            --right->count;
+            parent->keys[idx] = right->keys[0];
+        }
+        else
+        {
+            Inner* left = static_cast<Inner*>(left_node);
+            Inner* right = static_cast<Inner*>(right_node);
+            left->keys[left->count] = parent->keys[idx];
+            left->children[left->count + 1] = right->children[0];
+            ++left->count;
+            parent->keys[idx] = right->keys[0];
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::move(right->children + 1, right->children + right->count + 1, right->children);
+            --right->count;
+        }
+    }
+    /// <summary>
+    ///  parent->children[i + 1]  parent->children[i]    keys[i]  parent.
+    /// </summary>
+    void merge(Inner* parent, size_t i)
+    {
+        Node* left_node = parent->children[i];
+        Node* right_node = parent->children[i + 1];
+
+        if (left_node->is_leaf)
+        {
+            Leaf* left = static_cast<Leaf*>(left_node);
+            Leaf* right = static_cast<Leaf*>(right_node);
+            std::move(right->keys, right->keys + right->count, left->keys + left->count);
+            left->count += right->count;
+
+            left->next = right->next;
+            if (right->next)
+                right->next->prev = left;
+            else
+                last_leaf = left;
+            delete right;
+        }
+        else
+        {
+            Inner* left = static_cast<Inner*>(left_node);
+            Inner* right = static_cast<Inner*>(right_node);
+            left->keys[left->count] = parent->keys[i];
+            std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+            std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+            left->count += right->count + 1;
+            delete right;
+        }
+
+        std::move(parent->keys + i + 1, parent->keys + parent->count, parent->keys + i);
+        std::move(parent->children + i + 2, parent->children + parent->count + 1, parent->children + i + 1);
+        --parent->count;
+    }
+
+    /// <summary>
+    ///   node.
+    /// </summary>
+    static void destroy(Node* node)
+    {
+        if (!node) return;
+        if (node->is_leaf)
+        {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        for (size_t i = 0; i <= inner->count; ++i)
+            destroy(inner->children[i]);
+        delete inner;
+    }
+
+    /// <summary>
+    ///   : ,  ,    [low, high)   .
+    /// </summary>
+    bool validate_node(const Node* node, const T* low, const T* high, int depth, int& leaf_depth, size_t& counted) const
+    {
+        size_t capacity = node->is_leaf ? leaf_capacity : inner_capacity;
+        if (node->count > capacity)
+            return false;
+        if (node != root && node->count < min_count(node))
+            return false;
+        if (node->count == 0)
+            return false;
+
+        const T* keys = node->is_leaf ? static_cast<const Leaf*>(node)->keys : static_cast<const Inner*>(node)->keys;
+        for (size_t i = 1; i < node->count; ++i)
+        {
+            if (!(keys[i - 1] < keys[i]))
+                return false;
+        }
+        if (low && keys[0] < *low)
+            return false;
+        if (high && !(keys[node->count - 1] < *high))
+            return false;
+
+        if (node->is_leaf)
+        {
+            if (leaf_depth == -1)
+                leaf_depth = depth;
+            counted += node->count;
+            return leaf_depth == depth;
+        }
+
+        const Inner* inner = static_cast<const Inner*>(node);
+        for (size_t i = 0; i <= inner->count; ++i)
+        {
+            const T* child_low = i == 0 ? low : &inner->keys[i - 1];
+            const T* child_high = i == inner->count ? high : &inner->keys[i];
+            if (!validate_node(inner->children[i], child_low, child_high, depth + 1, leaf_depth, counted))
+                return false;
+        }
+        return true;
+    }
+};
+
+/// <summary>
+/// BTreeSet         (SimdKeySearch).
+///     find/lower_bound,    RBTree&lt;int64_t&gt;.
+/// </summary>
+template <class T, size_t NodeBytes = 256>
+using SimdBTreeSet = BTreeSet<T, NodeBytes, SimdKeySearch<T>>;
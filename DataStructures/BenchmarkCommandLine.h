@@ -0,0 +1,621 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "BenchmarkRegistry.h"
+#include "BenchmarkReport.h"
+
+/// <summary>
+///      (. usage()).
+/// </summary>
+struct BenchmarkCommandLine
+{
+	BenchmarkFilter filter;
+	std::vector<size_t> sizes{ 1'000'000 };
+	bool list = false;
+	bool help = false;
+	/// <summary>
+	///        :  ,     
+	///     .
+	/// </summary>
+	bool isolate = false;
+	/// <summary>
+	///    :       .
+	/// </summary>
+	std::optional<size_t> run_index;
+	BenchmarkOptions options;
+	std::vector<std::string> outputs;
+	std::string baseline;
+	BenchmarkCompareOptions compare_options;
+	/// <summary>
+	///    , CSV  :      .
+	/// </summary>
+	std::vector<std::pair<std::string, std::string>> variants;
+	/// <summary>
+	///   (BenchmarkRegistry::Mode);     .
+	/// </summary>
+	std::string mode;
+	/// <summary>
+	///  --threads, --trace, --bytes, --budget  --temp-dir  .     16  
+	///   ,  external-sort        .
+	/// </summary>
+	size_t threads = 0;
+	std::string trace;
+	std::vector<uint64_t> bytes{ 1'000'000'000 };
+	size_t budget = 64'000'000;
+	std::string temp_directory;
+	/// <summary>
+	///         .
+	/// </summary>
+	std::vector<std::string> forwarded;
+
+	static const char* usage()
+	{
+		return
+			"usage: DataStructures [options]\n"
+			"  --list                   print the selected benchmarks and exit\n"
+			"  --suite REGEX            select suites (list, tree, map, frozen, ...)\n"
+			"  --scenario REGEX         select scenarios (insert, find, ...)\n"
+			"  --container REGEX        select container implementations\n"
+			"  --n LIST                 sizes, comma separated, with optional K/M/G suffix (default 1M)\n"
+			"  --sweep FROM:TO[:FACTOR] geometric sizes, e.g. 1K:100M (factor 10 by default)\n"
+			"  --isolate                run every benchmark and size in a fresh process\n"
+			"  --repetitions K          repetitions per measurement\n"
+			"  --min-time-ms T          minimum measured time per repetition\n"
+			"  --warmup-ms T            warmup time before measuring\n"
+			"  --no-counters            do not open hardware performance counters\n"
+			"  --json FILE, --csv FILE  save results\n"
+			"  --baseline FILE.csv      compare with a baseline, exit code 1 on regression\n"
+			"  --threshold FRACTION     relative slowdown treated as a regression (default 0.05)\n"
+			"  --variant NAME=FILE.csv  results of one build variant; with two or more, print the variant table and exit\n"
+			"  --mode NAME              run a comparison mode instead of the suites (--suite and --container select pairs):\n"
+			"                           concurrent, latency, ycsb, trace, warm-start, external-sort\n"
+			"  --threads N              concurrent: largest thread count of the sweep (default: hardware threads)\n"
+			"  --trace FILE             trace: operation trace to replay (format of Workload::save_trace)\n"
+			"  --bytes LIST             external-sort: input sizes, e.g. 1G,10G,100G (default 1G)\n"
+			"  --budget SIZE            external-sort: memory budget; larger inputs are spilled as runs (default 64M)\n"
+			"  --temp-dir DIR           external-sort: directory of run files (default: system temporary directory)\n"
+			"allocation counts and footprint are printed only by a build with DS_DEFINE_ALLOCATION_HOOKS (ds_bench_memory)\n";
+	}
+
+	/// <summary>
+	///  .
+	/// </summary>
+	/// <exception cref="std::invalid_argument">    .</exception>
+	/// <exception cref="std::out_of_range">    size_t.</exception>
+	static BenchmarkCommandLine parse(int argc, const char* const argv[])
+	{
+		BenchmarkCommandLine result;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string option = argv[i];
+			auto value = [&]() -> std::string
+				{
+					if (i + 1 >= argc)
+						throw std::invalid_argument(option + " requires a value");
+					return argv[++i];
+				};
+			auto forward = [&](const std::string& text)
+				{
+					result.forwarded.push_back(option);
+					result.forwarded.push_back(text);
+				};
+
+			if (option == "--help" || option == "-h")
+				result.help = true;
+			else if (option == "--list")
+				result.list = true;
+			else if (option == "--isolate")
+				result.isolate = true;
+			else if (option == "--suite")
+				result.filter.suite = value();
+			else if (option == "--scenario")
+				result.filter.scenario = value();
+			else if (option == "--container")
+				result.filter.container = value();
+			else if (option == "--n")
+				result.sizes = parse_size_list(value());
+			else if (option == "--sweep")
+				result.sizes = parse_sweep(value());
+			else if (option == "--run-index")
+				result.run_index = parse_size(value());
+			else if (option == "--repetitions")
+			{
+				std::string text = value();
+				result.options.repetitions = parse_size(text);
+				forward(text);
+			}
+			else if (option == "--min-time-ms")
+			{
+				std::string text = value();
+				result.options.min_sample_time = std::chrono::milliseconds(parse_size(text));
+				forward(text);
+			}
+			else if (option == "--warmup-ms")
+			{
+				std::string text = value();
+				result.options.warmup = std::chrono::milliseconds(parse_size(text));
+				forward(text);
+			}
+			else if (option == "--no-counters")
+			{
+				result.options.hardware_counters = false;
+				result.forwarded.push_back(option);
+			}
+			else if (option == "--json" || option == "--csv")
+				result.outputs.push_back(value());
+			else if (option == "--baseline")
+				result.baseline = value();
+			else if (option == "--threshold")
+				result.compare_options.threshold = parse_double(value(), option);
+			else if (option == "--variant")
+			{
+				std::string text = value();
+				size_t separator = text.find('=');
+				if (separator == 0 || separator == std::string::npos || separator + 1 == text.size())
+					throw std::invalid_argument("--variant expects NAME=FILE.csv");
+				result.variants.emplace_back(text.substr(0, separator), text.substr(separator + 1));
+			}
+			else if (option == "--mode")
+				result.mode = value();
+			else if (option == "--threads")
+				result.threads = parse_size(value());
+			else if (option == "--trace")
+				result.trace = value();
+			else if (option == "--bytes")
+			{
+				std::vector<size_t> sizes = parse_size_list(value());
+				result.bytes.assign(sizes.begin(), sizes.end());
+			}
+			else if (option == "--budget")
+			{
+				result.budget = parse_size(value());
+				if (result.budget == 0)
+					throw std::invalid_argument("--budget must be positive");
+			}
+			else if (option == "--temp-dir")
+				result.temp_directory = value();
+			else
+				throw std::invalid_argument("unknown option " + option);
+		}
+		if (result.mode == "trace" && result.trace.empty())
+			throw std::invalid_argument("--mode trace requires --trace FILE");
+		return result;
+	}
+
+	/// <summary>
+	///     : 1000, 10K, 100M, 1G.
+	/// </summary>
+	/// <exception cref="std::out_of_range">       size_t.</exception>
+	static size_t parse_size(const std::string& text)
+	{
+		size_t digits = 0;
+		while (digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits])))
+			++digits;
+		if (digits == 0 || digits + 1 < text.size())
+			throw std::invalid_argument("invalid size '" + text + "'");
+		size_t multiplier = 1;
+		if (digits < text.size())
+		{
+			switch (std::toupper(static_cast<unsigned char>(text[digits])))
+			{
+			case 'K': multiplier = 1'000; break;
+			case 'M': multiplier = 1'000'000; break;
+			case 'G': multiplier = 1'000'000'000; break;
+			default: throw std::invalid_argument("invalid size suffix in '" + text + "'");
+			}
+		}
+		unsigned long long value = std::stoull(text.substr(0, digits));
+		if (value > std::numeric_limits<size_t>::max() / multiplier)
+			throw std::out_of_range("size '" + text + "' does not fit in size_t");
+		return static_cast<size_t>(value) * multiplier;
+	}
+
+	/// <summary>
+	///  from, from * factor, ...   to.
+	/// </summary>
+	static std::vector<size_t> geometric_sizes(size_t from, size_t to, double factor)
+	{
+		if (from == 0 || to < from || !(factor > 1))
+			throw std::invalid_argument("sweep needs 0 < FROM <= TO and FACTOR > 1");
+		std::vector<size_t> sizes;
+		for (double value = static_cast<double>(from); value <= to * (1 + 1e-9); value *= factor)
+		{
+			size_t size = static_cast<size_t>(std::llround(value));
+			if (sizes.empty() || size != sizes.back())
+				sizes.push_back(size);
+		}
+		return sizes;
+	}
+
+private:
+	static std::vector<size_t> parse_size_list(const std::string& text)
+	{
+		std::vector<size_t> sizes;
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end = text.find(',', start);
+			if (end == std::string::npos)
+				end = text.size();
+			sizes.push_back(parse_size(text.substr(start, end - start)));
+			start = end + 1;
+		}
+		return sizes;
+	}
+
+	static std::vector<size_t> parse_sweep(const std::string& text)
+	{
+		size_t first = text.find(':');
+		if (first == std::string::npos)
+			throw std::invalid_argument("--sweep expects FROM:TO[:FACTOR]");
+		size_t second = text.find(':', first + 1);
+		size_t from = parse_size(text.substr(0, first));
+		size_t to = parse_size(text.substr(first + 1, second == std::string::npos ? std::string::npos : second - first - 1));
+		double factor = second == std::string::npos ? 10 : parse_double(text.substr(second + 1), "--sweep");
+		return geometric_sizes(from, to, factor);
+	}
+
+	static double parse_double(const std::string& text, const std::string& option)
+	{
+		size_t used = 0;
+		double value = 0;
+		try
+		{
+			value = std::stod(text, &used);
+		}
+		catch (const std::exception&)
+		{
+			used = 0;
+		}
+		if (used == 0 || used != text.size())
+			throw std::invalid_argument("invalid number '" + text + "' for " + option);
+		return value;
+	}
+};
+
+/// <summary>
+///    :          ,
+///       .
+/// </summary>
+class BenchmarkDriver
+{
+private:
+	BenchmarkCommandLine command_line_;
+	std::string program_;
+	BenchmarkRegistry& registry_;
+	BenchmarkReporter reporter_;
+
+public:
+	/// <param name="program">    (argv[0])     .</param>
+	BenchmarkDriver(BenchmarkCommandLine command_line, std::string program, BenchmarkRegistry& registry = BenchmarkRegistry::instance())
+		: command_line_(std::move(command_line)), program_(std::move(program)), registry_(registry) {}
+
+	const BenchmarkReporter& reporter() const
+	{
+		return reporter_;
+	}
+
+	/// <summary>
+	///  : 0  , 1     , 2     .
+	/// </summary>
+	int run()
+	{
+		if (command_line_.help)
+		{
+			std::cout << BenchmarkCommandLine::usage();
+			return 0;
+		}
+		if (!command_line_.variants.empty())
+			return print_variants();
+		if (!command_line_.mode.empty())
+			return run_modes();
+
+		std::vector<size_t> selected;
+		if (command_line_.run_index)
+		{
+			if (*command_line_.run_index >= registry_.entries().size())
+			{
+				std::cerr << "no benchmark with index " << *command_line_.run_index << "\n";
+				return 2;
+			}
+			selected.push_back(*command_line_.run_index);
+		}
+		else
+		{
+			try
+			{
+				selected = registry_.select(command_line_.filter);
+			}
+			catch (const std::regex_error& error)
+			{
+				std::cerr << "invalid regular expression: " << error.what() << "\n";
+				return 2;
+			}
+		}
+
+		if (command_line_.list)
+		{
+			for (size_t index : selected)
+			{
+				const BenchmarkRegistry::Entry& entry = registry_.entries()[index];
+				std::cout << entry.suite << "/" << entry.scenario << "  " << entry.container << "\n";
+			}
+			return 0;
+		}
+		if (selected.empty())
+		{
+			std::cerr << "no benchmarks match the filter\n";
+			return 2;
+		}
+
+		bool failed = false;
+		for (const std::vector<size_t>& group : group_by_scenario(selected))
+			for (size_t n : command_line_.sizes)
+			{
+				const BenchmarkRegistry::Entry& first = registry_.entries()[group.front()];
+				if (!command_line_.run_index)
+					std::cout << first.suite << "/" << first.scenario << ", n = " << n << ":\n";
+				for (size_t index : group)
+					failed |= command_line_.isolate && !command_line_.run_index ? !run_isolated(index, n) : !run_here(index, n);
+				if (!command_line_.run_index)
+					std::cout << "\n";
+			}
+		return finish(failed);
+	}
+
+private:
+	/// <summary>
+	///       ;    run().
+	/// </summary>
+	int finish(bool failed)
+	{
+		try
+		{
+			for (const std::string& path : command_line_.outputs)
+				reporter_.save(path);
+			if (!command_line_.baseline.empty())
+			{
+				std::vector<BenchmarkRecord> baseline = BenchmarkReporter::load_csv(command_line_.baseline);
+				std::cout << "compared with " << command_line_.baseline << ":\n";
+				if (print_comparison(compare_with_baseline(baseline, reporter_.records(), command_line_.compare_options)) > 0)
+					return 1;
+			}
+		}
+		catch (const std::exception& error)
+		{
+			std::cerr << error.what() << "\n";
+			return 2;
+		}
+		return failed ? 2 : 0;
+	}
+
+	/// <summary>
+	///  --mode:       .
+	/// </summary>
+	int run_modes()
+	{
+		const std::vector<BenchmarkRegistry::Mode>& modes = registry_.modes();
+		if (std::none_of(modes.begin(), modes.end(), [&](const BenchmarkRegistry::Mode& mode) { return mode.mode == command_line_.mode; }))
+		{
+			std::cerr << "unknown mode " << command_line_.mode << "\n";
+			return 2;
+		}
+		std::vector<size_t> selected;
+		try
+		{
+			selected = registry_.select_modes(command_line_.mode, command_line_.filter);
+		}
+		catch (const std::regex_error& error)
+		{
+			std::cerr << "invalid regular expression: " << error.what() << "\n";
+			return 2;
+		}
+
+		if (command_line_.list)
+		{
+			for (size_t index : selected)
+				std::cout << modes[index].mode << " " << modes[index].suite << "  " << modes[index].containers << "\n";
+			return 0;
+		}
+		if (selected.empty())
+		{
+			std::cerr << "no " << command_line_.mode << " mode matches the filter\n";
+			return 2;
+		}
+
+		BenchmarkModeArgs args;
+		args.options = command_line_.options;
+		args.threads = command_line_.threads;
+		args.trace = command_line_.trace;
+		args.bytes = command_line_.bytes;
+		args.budget = command_line_.budget;
+		args.temp_directory = command_line_.temp_directory;
+		bool failed = false;
+		for (size_t index : selected)
+		{
+			const BenchmarkRegistry::Mode& mode = modes[index];
+			std::vector<size_t> sizes = mode.sized ? command_line_.sizes : std::vector<size_t>{ 0 };
+			for (size_t n : sizes)
+			{
+				std::cout << mode.mode << " " << mode.suite << ": " << mode.containers;
+				if (mode.sized)
+					std::cout << ", n = " << n;
+				std::cout << "\n\n";
+				args.n = n;
+				try
+				{
+					mode.run(args, reporter_);
+				}
+				catch (const std::exception& error)
+				{
+					std::cerr << "  " << mode.containers << ": " << error.what() << "\n";
+					failed = true;
+				}
+			}
+		}
+		return finish(failed);
+	}
+
+	/// <summary>
+	///  --variant:        .
+	/// </summary>
+	int print_variants() const
+	{
+		if (command_line_.variants.size() < 2)
+		{
+			std::cerr << "--variant needs at least two variants to compare\n";
+			return 2;
+		}
+		std::vector<BenchmarkVariant> variants;
+		try
+		{
+			for (const auto& [name, path] : command_line_.variants)
+				variants.push_back({ name, BenchmarkReporter::load_csv(path) });
+		}
+		catch (const std::exception& error)
+		{
+			std::cerr << error.what() << "\n";
+			return 2;
+		}
+		print_variant_table(std::cout, variants);
+		return 0;
+	}
+
+	/// <summary>
+	/// ,     ,    :   
+	///  .
+	/// </summary>
+	std::vector<std::vector<size_t>> group_by_scenario(const std::vector<size_t>& selected) const
+	{
+		std::vector<std::vector<size_t>> groups;
+		for (size_t index : selected)
+		{
+			const BenchmarkRegistry::Entry& entry = registry_.entries()[index];
+			auto same = [&](const std::vector<size_t>& group)
+				{
+					const BenchmarkRegistry::Entry& other = registry_.entries()[group.front()];
+					return other.suite == entry.suite && other.scenario == entry.scenario;
+				};
+			auto group = std::find_if(groups.begin(), groups.end(), same);
+			if (group == groups.end())
+				groups.push_back({ index });
+			else
+				group->push_back(index);
+		}
+		return groups;
+	}
+
+	bool run_here(size_t index, size_t n)
+	{
+		const BenchmarkRegistry::Entry& entry = registry_.entries()[index];
+		try
+		{
+			BenchmarkCase benchmark = registry_.make_case(index, n, command_line_.options);
+			BenchmarkStats stats = benchmark.measure();
+			print_stats(entry.container, stats);
+			reporter_.add(entry.suite, entry.container, entry.scenario, benchmark.n, stats);
+			return true;
+		}
+		catch (const std::exception& error)
+		{
+			std::cerr << "  " << entry.container << ": " << error.what() << "\n";
+			return false;
+		}
+	}
+
+	/// <summary>
+	///      --run-index      CSV.
+	/// </summary>
+	bool run_isolated(size_t index, size_t n)
+	{
+		std::random_device random;
+		std::filesystem::path output = std::filesystem::temp_directory_path()
+			/ ("ds_bench_" + std::to_string(random()) + "_" + std::to_string(index) + ".csv");
+		std::vector<std::string> args = { program_, "--run-index", std::to_string(index), "--n", std::to_string(n),
+			"--csv", output.string() };
+		args.insert(args.end(), command_line_.forwarded.begin(), command_line_.forwarded.end());
+
+		std::cout.flush();
+		int status = std::system(shell_command(args).c_str());
+		std::error_code ignored;
+		if (status != 0 || !std::filesystem::exists(output))
+		{
+			std::cerr << "  " << registry_.entries()[index].container << ": benchmark process failed (status " << status << ")\n";
+			std::filesystem::remove(output, ignored);
+			return false;
+		}
+		std::vector<BenchmarkRecord> records;
+		try
+		{
+			records = BenchmarkReporter::load_csv(output.string());
+		}
+		catch (const std::exception& error)
+		{
+			std::cerr << "  " << registry_.entries()[index].container << ": " << error.what() << "\n";
+		}
+		std::filesystem::remove(output, ignored);
+		for (const BenchmarkRecord& record : records)
+			reporter_.add(record.suite, record.container, record.scenario, record.n, record.stats);
+		return !records.empty();
+	}
+
+	static std::string shell_command(const std::vector<std::string>& args)
+	{
+		std::string command;
+		for (const std::string& arg : args)
+		{
+			if (!command.empty())
+				command += ' ';
+#if defined(_WIN32)
+			command += '"';
+			for (char c : arg)
+				command += c == '"' ? std::string("\\\"") : std::string(1, c);
+			command += '"';
+#else
+			command += '\'';
+			for (char c : arg)
+				command += c == '\'' ? std::string("'\\''") : std::string(1, c);
+			command += '\'';
+#endif
+		}
+#if defined(_WIN32)
+		// cmd /c   ,     .
+		command = '"' + command + '"';
+#endif
+		return command;
+	}
+};
+
+/// <summary>
+///    :     BenchmarkDriver.
+/// </summary>
+inline int run_benchmark_command_line(int argc, char* argv[])
+{
+	BenchmarkCommandLine command_line;
+	try
+	{
+		command_line = BenchmarkCommandLine::parse(argc, argv);
+	}
+	catch (const std::logic_error& error)
+	{
+		std::cerr << error.what() << "\n\n" << BenchmarkCommandLine::usage();
+		return 2;
+	}
+	return BenchmarkDriver(std::move(command_line), argc > 0 ? argv[0] : "").run();
+}
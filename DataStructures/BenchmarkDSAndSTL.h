@@ -1,210 +1,278 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <iterator>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "BenchmarkRegistry.h"
+#include "BenchmarkReport.h"
+#include "ConcurrentBenchmark.h"
+#include "ForkJoinPool.h"
+#include "MappedHashMap.h"
+#include "Workload.h"
 using namespace std;
-using Clock = chrono::high_resolution_clock;
 
 template<typename MyList, typename StdList>
 class ListBenchmark
 {
 private:
 	size_t n_;
+	BenchmarkRunner runner_;
+	BenchmarkReporter* reporter_ = nullptr;
 public:
-	explicit ListBenchmark(size_t n) : n_(n) {}
+	explicit ListBenchmark(size_t n, BenchmarkOptions options = {}) : n_(n), runner_(options) {}
 
-	void run_all()
+	void set_reporter(BenchmarkReporter& reporter)
 	{
-		run("push_back",
-			[&] { return push_back<MyList>(n_); },
-			[&] { return push_back<StdList>(n_); });
-
-		run("push_front",
-			[&] { return push_front<MyList>(n_); },
-			[&] { return push_front<StdList>(n_); });
-
-		run("pop_back",
-			[&] { return pop_back<MyList>(n_); },
-			[&] { return pop_back<StdList>(n_); });
-
-		run("pop_front",
-			[&] { return pop_front<MyList>(n_); },
-			[&] { return pop_front<StdList>(n_); });
+		reporter_ = &reporter;
+	}
 
-		run("insert_middle",
-			[&] { return insert_middle<MyList>(n_); },
-			[&] { return insert_middle<StdList>(n_); });
+	void run_all()
+	{
+		vector<BenchmarkCase> mine = cases<MyList>();
+		vector<BenchmarkCase> stl = cases<StdList>();
+		for (size_t i = 0; i < mine.size(); ++i)
+			run(mine[i].scenario, mine[i].n, mine[i].measure, stl[i].measure);
+	}
 
-		run("erase_middle",
-			[&] { return erase_middle<MyList>(n_); },
-			[&] { return erase_middle<StdList>(n_); });
+	/// <summary>
+	///  run_all    (  ).       100'000 .
+	/// </summary>
+	template<typename ListType>
+	vector<BenchmarkCase> cases()
+	{
+		string name = benchmark_type_name<ListType>();
+		size_t sort_n = std::min<size_t>(n_, 100'000);
+		return {
+			{ "push_back", name, n_, [this] { return push_back<ListType>(n_); } },
+			{ "push_front", name, n_, [this] { return push_front<ListType>(n_); } },
+			{ "pop_back", name, n_, [this] { return pop_back<ListType>(n_); } },
+			{ "pop_front", name, n_, [this] { return pop_front<ListType>(n_); } },
+			{ "insert_middle", name, n_, [this] { return insert_middle<ListType>(n_); } },
+			{ "erase_middle", name, n_, [this] { return erase_middle<ListType>(n_); } },
+			{ "clear", name, n_, [this] { return clear<ListType>(n_); } },
+			{ "sort", name, sort_n, [this, sort_n] { return sort<ListType>(sort_n); } }
+		};
+	}
 
-		run("clear",
-			[&] { return clear<MyList>(n_); },
-			[&] { return clear<StdList>(n_); });
+	/// <summary>
+	/// : n    threads ,   push_back,   pop_front.
+	///     .
+	/// </summary>
+	void run_concurrent(size_t threads, ContainerSharing sharing = ContainerSharing::shared)
+	{
+		run_concurrent(string("concurrent_queue_") + sharing_name(sharing) + "_t" + to_string(threads),
+			[&] { return concurrent_queue<MyList>(n_, threads, sharing); },
+			[&] { return concurrent_queue<StdList>(n_, threads, sharing); });
+	}
 
-		run("sort",
-			[&] { return sort<MyList>(100'000); },
-			[&] { return sort<StdList>(100'000); });
+	void run_concurrent_sweep(size_t max_threads = 0)
+	{
+		for (ContainerSharing sharing : { ContainerSharing::shared, ContainerSharing::per_thread })
+			for (size_t threads : ConcurrentBenchmark<MyList>::thread_counts(max_threads))
+				run_concurrent(threads, sharing);
 	}
 
 private:
 	template<typename F1, typename F2>
 	void run(const string& name, F1 my, F2 stl)
 	{
-		long long my_time = my();
-		long long stl_time = stl();
-		print(name, my_time, stl_time);
+		run(name, n_, my, stl);
 	}
 
-	template<typename Func>
-	long long benchmark(Func f)
+	template<typename F1, typename F2>
+	void run(const string& name, size_t n, F1 my, F2 stl)
 	{
-		auto start = Clock::now();
-		f();
-		auto end = Clock::now();
-		return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		BenchmarkStats my_stats = my();
+		BenchmarkStats stl_stats = stl();
+		print(name, my_stats, stl_stats);
+		report(name, n, my_stats, stl_stats);
+	}
+
+	template<typename F1, typename F2>
+	void run_concurrent(const string& name, F1 my, F2 stl)
+	{
+		ConcurrentStats my_stats = my();
+		ConcurrentStats stl_stats = stl();
+		cout << name << ":\n";
+		print_concurrent(benchmark_type_name<MyList>(), my_stats);
+		print_concurrent(benchmark_type_name<StdList>(), stl_stats);
+		cout << "\n";
+		if (reporter_)
+		{
+			reporter_->add("list", benchmark_type_name<MyList>(), name, n_, my_stats.per_op);
+			reporter_->add("list", benchmark_type_name<StdList>(), name, n_, stl_stats.per_op);
+			reporter_->add_latency("list", benchmark_type_name<MyList>(), name, n_, my_stats.latency);
+			reporter_->add_latency("list", benchmark_type_name<StdList>(), name, n_, stl_stats.latency);
+		}
 	}
 
 	template<typename ListType>
-	long long push_back(size_t n)
+	struct MiddleState
 	{
-		ListType List;
+		ListType list;
+		typename ListType::iterator it;
+	};
 
-		return benchmark([&]()
+	template<typename ListType>
+	static void fill(ListType& list, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			list.push_back(i);
+		}
+	}
+
+	template<typename ListType>
+	static void fill_to_middle(MiddleState<ListType>& state, size_t n)
+	{
+		fill(state.list, n);
+		state.it = state.list.begin();
+		for (size_t i = 0; i < n / 2; ++i)
+		{
+			++state.it;
+		}
+	}
+
+	template<typename ListType>
+	BenchmarkStats push_back(size_t n)
+	{
+		return runner_.measure_fresh<ListType>([](ListType&) {}, [&](ListType& list)
 			{
 				for (size_t i = 0; i < n; ++i)
 				{
-					List.push_back(i);
+					list.push_back(i);
 				}
-			});
+			}, n);
 	}
 
 	template<typename ListType>
-	long long push_front(size_t n)
+	BenchmarkStats push_front(size_t n)
 	{
-		ListType List;
-
-		return benchmark([&]()
+		return runner_.measure_fresh<ListType>([](ListType&) {}, [&](ListType& list)
 			{
 				for (size_t i = 0; i < n; ++i)
 				{
-					List.push_front(i);
+					list.push_front(i);
 				}
-			});
+			}, n);
 	}
 
 	template<typename ListType>
-	long long pop_back(size_t n)
+	BenchmarkStats pop_back(size_t n)
 	{
-		ListType List;
-		for (size_t i = 0; i < n; ++i)
-		{
-			List.push_back(i);
-		}
-
-		return benchmark([&]()
+		return runner_.measure_fresh<ListType>([&](ListType& list) { fill(list, n); }, [](ListType& list)
 			{
-				while (!List.empty())
+				while (!list.empty())
 				{
-					List.pop_back();
+					list.pop_back();
 				}
-			});
+			}, n);
 	}
 
 	template<typename ListType>
-	long long pop_front(size_t n)
+	BenchmarkStats pop_front(size_t n)
 	{
-		ListType List;
-		for (size_t i = 0; i < n; ++i)
-		{
-			List.push_back(i);
-		}
-
-		return benchmark([&]()
+		return runner_.measure_fresh<ListType>([&](ListType& list) { fill(list, n); }, [](ListType& list)
 			{
-				while (!List.empty())
+				while (!list.empty())
 				{
-					List.pop_front();
+					list.pop_front();
 				}
-			});
+			}, n);
 	}
 
 	template<typename ListType>
-	long long insert_middle(size_t n)
+	BenchmarkStats insert_middle(size_t n)
 	{
-		ListType List;
-		for (size_t i = 0; i < n; ++i)
-		{
-			List.push_back(i);
-		}
-
-		auto it = List.begin();
-
-		for (size_t i = 0; i < n / 2; ++i)
-		{
-			++it;
-		}
-
-		return benchmark([&]()
+		return runner_.measure_fresh<MiddleState<ListType>>([&](MiddleState<ListType>& state) { fill_to_middle(state, n); },
+			[&](MiddleState<ListType>& state)
 			{
-				List.insert(it, -1);
-			});
+				for (size_t i = 0; i < n; ++i)
+				{
+					state.list.insert(state.it, -1);
+				}
+			}, n);
 	}
 
 	template<typename ListType>
-	long long erase_middle(size_t n)
+	BenchmarkStats erase_middle(size_t n)
 	{
-		ListType List;
-		for (size_t i = 0; i < n; ++i)
-		{
-			List.push_back(i);
-		}
-
-		auto it = List.begin();
-
-		for (size_t i = 0; i < n / 2; ++i)
-		{
-			++it;
-		}
-
-		return benchmark([&]()
+		return runner_.measure_fresh<MiddleState<ListType>>([&](MiddleState<ListType>& state) { fill_to_middle(state, n); },
+			[&](MiddleState<ListType>& state)
 			{
-				List.erase(it);
-			});
+				for (size_t i = 0; i < n / 2; ++i)
+				{
+					state.it = state.list.erase(state.it);
+				}
+			}, n / 2);
 	}
 
 	template<typename ListType>
-	long long clear(size_t n)
+	BenchmarkStats clear(size_t n)
 	{
-		ListType List;
-		for (size_t i = 0; i < n; ++i)
-			List.push_back(i);
+		return runner_.measure_fresh<ListType>([&](ListType& list) { fill(list, n); }, [](ListType& list)
+			{
+				list.clear();
+			}, n);
+	}
 
-		return benchmark([&]()
+	template<typename ListType>
+	BenchmarkStats sort(size_t n)
+	{
+		return runner_.measure_fresh<ListType>([&](ListType& list)
 			{
-				List.clear();
-			});
+				mt19937 rng(42);
+				for (size_t i = 0; i < n; ++i)
+					list.push_back(static_cast<int>(rng()));
+			}, [](ListType& list)
+			{
+				list.sort();
+			}, n);
 	}
 
 	template<typename ListType>
-	long long sort(size_t n)
+	ConcurrentStats concurrent_queue(size_t n, size_t threads, ContainerSharing sharing)
 	{
-		ListType list;
-		for (size_t i = 0; i < n; ++i)
-			list.push_back(rand());
+		ConcurrentOptions options;
+		options.ops_per_thread = std::max<size_t>(n / threads, 1);
+		options.repetitions = runner_.options().repetitions;
 
-		return benchmark([&]()
+		return ConcurrentBenchmark<ListType, MutexPolicy>(options).run(threads, sharing, [](ListType&) {},
+			[](auto& access, size_t, size_t i)
 			{
-				list.sort();
+				access.write([&](ListType& list)
+					{
+						if (i % 2 == 0)
+							list.push_back(static_cast<int>(i));
+						else if (!list.empty())
+							list.pop_front();
+					});
 			});
 	}
 
-	void print(const string name, long long my, long long stl)
+	void print(const string name, const BenchmarkStats& my, const BenchmarkStats& stl)
 	{
 		cout << name << ":\n";
-		cout << "  MyList   = " << my << " ms\n";
-		cout << "  std::list= " << stl << " ms\n\n";
+		print_stats(benchmark_type_name<MyList>(), my);
+		print_stats(benchmark_type_name<StdList>(), stl);
+		cout << "\n";
+	}
+
+	void report(const string& name, size_t n, const BenchmarkStats& my, const BenchmarkStats& stl)
+	{
+		if (!reporter_)
+			return;
+		reporter_->add("list", benchmark_type_name<MyList>(), name, n, my);
+		reporter_->add("list", benchmark_type_name<StdList>(), name, n, stl);
 	}
 };
 
@@ -212,201 +280,558 @@ template<typename MyRBTree, typename StdSet>
 class RBTreeBenchmark
 {
 private:
+	enum class InsertPattern
+	{
+		ascending,
+		descending,
+		jittered
+	};
+
 	size_t n_;
+	BenchmarkRunner runner_;
+	BenchmarkReporter* reporter_ = nullptr;
 public:
-	explicit RBTreeBenchmark(size_t n) : n_(n) {}
+	explicit RBTreeBenchmark(size_t n, BenchmarkOptions options = {}) : n_(n), runner_(options) {}
+
+	void set_reporter(BenchmarkReporter& reporter)
+	{
+		reporter_ = &reporter;
+	}
 
 	void run_all()
 	{
-		run("insert",
-			[&] { return insert<MyRBTree>(n_); },
-			[&] { return insert<StdSet>(n_); });
+		vector<BenchmarkCase> mine = cases<MyRBTree>();
+		vector<BenchmarkCase> stl = cases<StdSet>();
+		for (size_t i = 0; i < mine.size(); ++i)
+			run(mine[i].scenario, mine[i].measure, stl[i].measure);
+	}
+
+	/// <summary>
+	///  run_all    (  ).
+	/// </summary>
+	template<typename TreeType>
+	vector<BenchmarkCase> cases()
+	{
+		string name = benchmark_type_name<TreeType>();
+		vector<BenchmarkCase> result;
+		result.push_back({ "insert", name, n_, [this] { return insert<TreeType>(n_); } });
+
+		for (InsertPattern pattern : { InsertPattern::ascending, InsertPattern::descending, InsertPattern::jittered })
+		{
+			result.push_back({ string("insert_") + pattern_name(pattern), name, n_,
+				[this, pattern] { return insert_pattern<TreeType>(n_, pattern, false); } });
+			result.push_back({ string("insert_hint_") + pattern_name(pattern), name, n_,
+				[this, pattern] { return insert_pattern<TreeType>(n_, pattern, true); } });
+		}
+
+		result.push_back({ "duplicate_insert", name, n_, [this] { return duplicate_insert<TreeType>(n_); } });
+		result.push_back({ "erase", name, n_, [this] { return erase<TreeType>(n_); } });
+		result.push_back({ "erase_random", name, n_, [this] { return erase_random<TreeType>(n_); } });
+		result.push_back({ "clear", name, n_, [this] { return clear<TreeType>(n_); } });
+		result.push_back({ "find", name, n_, [this] { return find<TreeType>(n_); } });
+		result.push_back({ "lower_upper", name, n_, [this] { return lower_upper<TreeType>(n_); } });
+		result.push_back({ "iteration", name, n_, [this] { return iteration<TreeType>(n_); } });
+		result.push_back({ "range_scan", name, n_, [this] { return range_scan<TreeType>(n_); } });
+		result.push_back({ "union", name, n_, [this] { return set_union<TreeType>(n_); } });
+		result.push_back({ "union_parallel", name, n_, [this] { return set_union<TreeType>(n_, std::thread::hardware_concurrency()); } });
+		result.push_back({ "insert_bulk", name, n_, [this] { return insert_bulk<TreeType>(n_); } });
+		result.push_back({ "intersect", name, n_, [this] { return set_intersect<TreeType>(n_); } });
+		result.push_back({ "difference", name, n_, [this] { return set_difference<TreeType>(n_); } });
+		return result;
+	}
+
+	/// <summary>
+	/// n    threads : read_percent   ,     .
+	///    SharedMutexPolicy,    thread_safe.
+	/// </summary>
+	void run_concurrent(size_t threads, unsigned read_percent, ContainerSharing sharing = ContainerSharing::shared)
+	{
+		run_concurrent(string("concurrent_") + sharing_name(sharing) + "_t" + to_string(threads) + "_r" + to_string(read_percent),
+			[&] { return concurrent<MyRBTree>(n_, threads, read_percent, sharing); },
+			[&] { return concurrent<StdSet>(n_, threads, read_percent, sharing); });
+	}
 
-		run("duplicate_insert",
-			[&] { return duplicate_insert<MyRBTree>(n_); },
-			[&] { return duplicate_insert<StdSet>(n_); });
+	void run_concurrent_sweep(size_t max_threads = 0)
+	{
+		for (ContainerSharing sharing : { ContainerSharing::shared, ContainerSharing::per_thread })
+			for (unsigned read_percent : { 50u, 90u, 99u })
+				for (size_t threads : ConcurrentBenchmark<MyRBTree>::thread_counts(max_threads))
+					run_concurrent(threads, read_percent, sharing);
+	}
 
-		run("erase",
-			[&] { return erase<MyRBTree>(n_); },
-			[&] { return erase<StdSet>(n_); });
+	/// <summary>
+	///    :    ,    .
+	/// </summary>
+	void run_latency(size_t batch = 1)
+	{
+		run_latency("insert_latency",
+			[&] { return insert_latency<MyRBTree>(n_, batch); },
+			[&] { return insert_latency<StdSet>(n_, batch); });
 
-		run("erase_random",
-			[&] { return erase_random<MyRBTree>(n_); },
-			[&] { return erase_random<StdSet>(n_); });
+		run_latency("erase_latency",
+			[&] { return erase_latency<MyRBTree>(n_, batch); },
+			[&] { return erase_latency<StdSet>(n_, batch); });
+	}
 
-		run("clear",
-			[&] { return clear<MyRBTree>(n_); },
-			[&] { return clear<StdSet>(n_); });
+	/// <summary>
+	///  YCSB AF: n  ,  n .
+	/// </summary>
+	void run_ycsb()
+	{
+		for (char letter : { 'A', 'B', 'C', 'D', 'E', 'F' })
+			run_workload(WorkloadSpec::ycsb(letter));
+	}
 
-		run("find",
-			[&] { return find<MyRBTree>(n_); },
-			[&] { return find<StdSet>(n_); });
+	void run_workload(const WorkloadSpec& spec)
+	{
+		run_workload(Workload::generate(spec, n_, n_));
+	}
 
-		run("lower_upper",
-			[&] { return lower_upper<MyRBTree>(n_); },
-			[&] { return lower_upper<StdSet>(n_); });
+	void run_workload(const Workload& workload)
+	{
+		run(workload.name,
+			[&] { return workload_mix<MyRBTree>(workload); },
+			[&] { return workload_mix<StdSet>(workload); });
+	}
 
-		run("iteration",
-			[&] { return iteration<MyRBTree>(n_); },
-			[&] { return iteration<StdSet>(n_); });
+	/// <summary>
+	///      (  Workload::save_trace).
+	/// </summary>
+	void run_trace(const string& path)
+	{
+		run_workload(Workload::load_trace(path));
 	}
 
 private:
 	template<typename F1, typename F2>
 	void run(const string& name, F1 my, F2 stl)
 	{
-		long long my_time = my();
-		long long stl_time = stl();
-		print(name, my_time, stl_time);
+		BenchmarkStats my_stats = my();
+		BenchmarkStats stl_stats = stl();
+		print(name, my_stats, stl_stats);
+		report(name, n_, my_stats, stl_stats);
+	}
+
+	template<typename TreeType>
+	struct TreePair
+	{
+		TreeType a;
+		TreeType b;
+	};
+
+
+	template<typename TreeType>
+	static void fill(TreeType& tree, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			tree.insert(i);
+		}
 	}
 
-	template<typename Func>
-	long long benchmark(Func f)
+	static vector<int> shuffled_keys(size_t n)
 	{
-		auto start = Clock::now();
-		f();
-		auto end = Clock::now();
-		return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		vector<int> keys(n);
+		for (size_t i = 0; i < n; ++i)
+			keys[i] = static_cast<int>(i);
+
+		mt19937 gen(42);
+		std::shuffle(keys.begin(), keys.end(), gen);
+		return keys;
+	}
+
+	template<typename F1, typename F2>
+	void run_latency(const string& name, F1 my, F2 stl)
+	{
+		LatencyStats my_stats = my();
+		LatencyStats stl_stats = stl();
+		cout << name << ":\n";
+		print_latency(benchmark_type_name<MyRBTree>(), my_stats);
+		print_latency(benchmark_type_name<StdSet>(), stl_stats);
+		cout << "\n";
+		if (reporter_)
+		{
+			reporter_->add_latency("tree", benchmark_type_name<MyRBTree>(), name, n_, my_stats);
+			reporter_->add_latency("tree", benchmark_type_name<StdSet>(), name, n_, stl_stats);
+		}
+	}
+
+	template<typename F1, typename F2>
+	void run_concurrent(const string& name, F1 my, F2 stl)
+	{
+		ConcurrentStats my_stats = my();
+		ConcurrentStats stl_stats = stl();
+		cout << name << ":\n";
+		print_concurrent(benchmark_type_name<MyRBTree>(), my_stats);
+		print_concurrent(benchmark_type_name<StdSet>(), stl_stats);
+		cout << "\n";
+		if (reporter_)
+		{
+			reporter_->add("tree", benchmark_type_name<MyRBTree>(), name, n_, my_stats.per_op);
+			reporter_->add("tree", benchmark_type_name<StdSet>(), name, n_, stl_stats.per_op);
+			reporter_->add_latency("tree", benchmark_type_name<MyRBTree>(), name, n_, my_stats.latency);
+			reporter_->add_latency("tree", benchmark_type_name<StdSet>(), name, n_, stl_stats.latency);
+		}
 	}
 
 	template<typename TreeType>
-	long long insert(size_t n)
+	BenchmarkStats workload_mix(const Workload& workload)
 	{
-		TreeType tree;
+		return runner_.measure_fresh<TreeType>([&](TreeType& tree) { preload_workload<int>(tree, workload.records); }, [&](TreeType& tree)
+			{
+				size_t hits = 0;
+				for (const WorkloadOp& op : workload.ops)
+					hits += apply_workload_op<int>(tree, op);
+				do_not_optimize(hits);
+			}, workload.ops.size());
+	}
 
-		return benchmark([&]()
+	template<typename TreeType>
+	LatencyStats insert_latency(size_t n, size_t batch)
+	{
+		vector<int> keys = shuffled_keys(n);
+		return runner_.measure_latency<TreeType>([](TreeType&) {}, [&](TreeType& tree, size_t i) { tree.insert(keys[i]); }, n, batch);
+	}
+
+	template<typename TreeType>
+	LatencyStats erase_latency(size_t n, size_t batch)
+	{
+		vector<int> keys = shuffled_keys(n);
+		return runner_.measure_latency<TreeType>([&](TreeType& tree) { fill(tree, n); }, [&](TreeType& tree, size_t i) { tree.erase(keys[i]); }, n, batch);
+	}
+
+	template<typename TreeType>
+	BenchmarkStats insert(size_t n)
+	{
+		return runner_.measure_fresh<TreeType>([](TreeType&) {}, [&](TreeType& tree)
 			{
 				for (size_t i = 0; i < n; ++i)
 				{
 					tree.insert(i);
 				}
-			});
+			}, n);
+	}
+
+	static const char* pattern_name(InsertPattern pattern)
+	{
+		switch (pattern)
+		{
+		case InsertPattern::ascending: return "ascending";
+		case InsertPattern::descending: return "descending";
+		default: return "jittered";
+		}
 	}
 
 	template<typename TreeType>
-	long long duplicate_insert(size_t n)
+	BenchmarkStats insert_pattern(size_t n, InsertPattern pattern, bool hinted)
 	{
-		TreeType tree;
+		vector<long long> keys(n);
+		mt19937 rng(7);
 		for (size_t i = 0; i < n; ++i)
 		{
-			tree.insert(i);
+			long long key = static_cast<long long>(i);
+			if (pattern == InsertPattern::descending)
+				key = static_cast<long long>(n - i);
+			else if (pattern == InsertPattern::jittered)
+				key = key * 4 + rng() % 16;
+			keys[i] = key;
 		}
-		return benchmark([&]()
+
+		return runner_.measure_fresh<TreeType>([](TreeType&) {}, [&](TreeType& tree)
 			{
-				for (size_t i = 0; i < n; ++i)
+				if constexpr (requires { tree.insert(tree.end(), 0); })
 				{
-					tree.insert(i);
+					if (hinted)
+					{
+						auto hint = tree.end();
+						for (long long key : keys)
+							hint = tree.insert(hint, static_cast<int>(key));
+						return;
+					}
 				}
-			});
+				for (long long key : keys)
+					tree.insert(static_cast<int>(key));
+			}, n);
 	}
+
 	template<typename TreeType>
-	long long erase(size_t n)
+	BenchmarkStats duplicate_insert(size_t n)
 	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		TreeType tree;
-		for (size_t i = 0; i < n; ++i)
-		{
-			tree.insert(i);
-		}
+		fill(tree, n);
+		return runner_.measure([&]()
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					tree.insert(i);
+				}
+			}, n, prepared_from);
+	}
 
-		return benchmark([&]()
+	template<typename TreeType>
+	BenchmarkStats erase(size_t n)
+	{
+		return runner_.measure_fresh<TreeType>([&](TreeType& tree) { fill(tree, n); }, [](TreeType& tree)
 			{
 				int i = 0;
 				while (!tree.empty())
 				{
 					tree.erase(i++);
 				}
-			});
+			}, n);
 	}
 
 	template<typename TreeType>
-	long long erase_random(size_t n)
+	BenchmarkStats erase_random(size_t n)
 	{
-		TreeType tree;
-		std::vector<int> keys(n);
+		vector<int> keys = shuffled_keys(n);
 
-		for (size_t i = 0; i < n; ++i)
-		{
-			keys[i] = i;
-			tree.insert(i);
-		}
+		return runner_.measure_fresh<TreeType>([&](TreeType& tree) { fill(tree, n); }, [&](TreeType& tree)
+			{
+				for (int k : keys)
+				{
+					tree.erase(k);
+				}
+			}, n);
+	}
 
-		std::mt19937 gen(42);
-		std::shuffle(keys.begin(), keys.end(), gen);
+	template<typename TreeType>
+	BenchmarkStats find(size_t n)
+	{
+		vector<int> keys = shuffled_keys(n);
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
+		TreeType tree;
+		fill(tree, n);
 
-		return benchmark([&]
-		{
-			for (int k : keys)
+		return runner_.measure([&]()
 			{
-				tree.erase(k);
-			}
-		});
+				for (int k : keys)
+				{
+					do_not_optimize(tree.find(k));
+				}
+			}, n, prepared_from);
 	}
 
 	template<typename TreeType>
-	long long find(size_t n)
+	BenchmarkStats clear(size_t n)
 	{
-		TreeType tree;
-		
-		return benchmark([&]()
-		{
-			for (size_t i = 0; i < n; ++i)
+		return runner_.measure_fresh<TreeType>([&](TreeType& tree) { fill(tree, n); }, [](TreeType& tree)
 			{
-				tree.insert(i);
-				tree.find(i);
-			}
-		});
+				tree.clear();
+			}, n);
 	}
 
 	template<typename TreeType>
-	long long clear(size_t n)
+	BenchmarkStats iteration(size_t n)
 	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		TreeType tree;
-		for (size_t i = 0; i < n; ++i)
-			tree.insert(i);
+		fill(tree, n);
 
-		return benchmark([&]()
+		return runner_.measure([&]
 			{
-				tree.clear();
-			});
+				size_t sum = 0;
+				for (auto x : tree)
+					sum += x;
+				do_not_optimize(sum);
+			}, n, prepared_from);
 	}
 
 	template<typename TreeType>
-	long long iteration(size_t n)
+	BenchmarkStats range_scan(size_t n)
 	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		TreeType tree;
-		for (size_t i = 0; i < n; ++i)
-			tree.insert(i);
+		fill(tree, n);
 
-		volatile size_t sum = 0;
+		const size_t window = 64;
+		size_t windows = n >= window ? (n - window) / (window / 4) + 1 : 0;
 
-		return benchmark([&]
-		{
-			for (auto x : tree)
-				sum += x;
-		});
+		return runner_.measure([&]
+			{
+				size_t local = 0;
+				for (size_t lo = 0; lo + window <= n; lo += window / 4)
+				{
+					int from = static_cast<int>(lo);
+					int to = static_cast<int>(lo + window - 1);
+					if constexpr (requires { tree.for_each_in_range(from, to, [](const int&) {}); })
+					{
+						tree.for_each_in_range(from, to, [&](const int& x) { local += x; });
+					}
+					else
+					{
+						for (auto it = tree.lower_bound(from), last = tree.upper_bound(to); it != last; ++it)
+							local += *it;
+					}
+				}
+				do_not_optimize(local);
+			}, windows, prepared_from);
 	}
 
 	template<typename TreeType>
-	long long lower_upper(size_t n)
+	BenchmarkStats lower_upper(size_t n)
 	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		TreeType tree;
-		for (size_t i = 0; i < n; ++i)
-			tree.insert(i);
-		return benchmark([&]()
+		fill(tree, n);
+		return runner_.measure([&]()
 			{
 				for (size_t i = 0; i < n; ++i)
 				{
-					tree.lower_bound(i);
-					tree.upper_bound(i);
+					do_not_optimize(tree.lower_bound(i));
+					do_not_optimize(tree.upper_bound(i));
+				}
+			}, 2 * n, prepared_from);
+	}
+
+	template<typename TreeType>
+	static void fill_overlapping(TreePair<TreeType>& trees, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			trees.a.insert(i * 2);
+			trees.b.insert(i * 3);
+		}
+	}
+
+	template<typename TreeType, typename SetAlgorithm>
+	static void std_set_operation(TreeType& a, TreeType& b, SetAlgorithm algorithm)
+	{
+		TreeType out;
+		if constexpr (requires { out.insert(out.end(), *a.begin()); })
+		{
+			algorithm(a.begin(), a.end(), b.begin(), b.end(), std::inserter(out, out.end()));
+		}
+		else
+		{
+			std::vector<std::decay_t<decltype(*a.begin())>> values;
+			algorithm(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+			for (const auto& v : values)
+				out.insert(v);
+		}
+		a.swap(out);
+	}
+
+	/// <summary>
+	///      :     ,        .
+	///  ,  threads   1     ForkJoinPool.
+	/// </summary>
+	template<typename TreeType>
+	static void start_pool(std::optional<ForkJoinPool>& pool, size_t threads)
+	{
+		if constexpr (requires (TreeType& tree, ForkJoinPool& p) { tree.union_with(tree, p); })
+			if (threads > 1)
+				pool.emplace(threads);
+	}
+
+	template<typename TreeType>
+	BenchmarkStats set_union(size_t n, size_t threads = 1)
+	{
+		std::optional<ForkJoinPool> pool;
+		start_pool<TreeType>(pool, threads);
+		return runner_.measure_fresh<TreePair<TreeType>>([&](TreePair<TreeType>& trees) { fill_overlapping(trees, n); },
+			[&](TreePair<TreeType>& trees)
+			{
+				if constexpr (requires { trees.a.union_with(trees.b, *pool); })
+				{
+					if (pool)
+						trees.a.union_with(trees.b, *pool);
+					else
+						trees.a.union_with(trees.b);
+				}
+				else
+					std_set_operation(trees.a, trees.b, [](auto... args) { return std::set_union(args...); });
+			}, 2 * n);
+	}
+
+	template<typename TreeType>
+	BenchmarkStats insert_bulk(size_t n)
+	{
+		vector<int> keys = shuffled_keys(n);
+		std::optional<ForkJoinPool> pool;
+		start_pool<TreeType>(pool, std::thread::hardware_concurrency());
+
+		return runner_.measure_fresh<TreeType>([](TreeType&) {}, [&](TreeType& tree)
+			{
+				if constexpr (requires { tree.insert_bulk(keys.begin(), keys.end(), *pool); })
+				{
+					if (pool)
+						tree.insert_bulk(keys.begin(), keys.end(), *pool);
+					else
+						tree.insert_bulk(keys.begin(), keys.end());
 				}
+				else
+					for (int k : keys)
+						tree.insert(k);
+			}, n);
+	}
+
+	template<typename TreeType>
+	BenchmarkStats set_intersect(size_t n)
+	{
+		return runner_.measure_fresh<TreePair<TreeType>>([&](TreePair<TreeType>& trees) { fill_overlapping(trees, n); },
+			[](TreePair<TreeType>& trees)
+			{
+				if constexpr (requires { trees.a.intersect(trees.b); })
+					trees.a.intersect(trees.b);
+				else
+					std_set_operation(trees.a, trees.b, [](auto... args) { return std::set_intersection(args...); });
+			}, 2 * n);
+	}
+
+	template<typename TreeType>
+	BenchmarkStats set_difference(size_t n)
+	{
+		return runner_.measure_fresh<TreePair<TreeType>>([&](TreePair<TreeType>& trees) { fill_overlapping(trees, n); },
+			[](TreePair<TreeType>& trees)
+			{
+				if constexpr (requires { trees.a.difference(trees.b); })
+					trees.a.difference(trees.b);
+				else
+					std_set_operation(trees.a, trees.b, [](auto... args) { return std::set_difference(args...); });
+			}, 2 * n);
+	}
+
+	template<typename TreeType>
+	ConcurrentStats concurrent(size_t n, size_t threads, unsigned read_percent, ContainerSharing sharing)
+	{
+		ConcurrentOptions options;
+		options.ops_per_thread = std::max<size_t>(n / threads, 1);
+		options.repetitions = runner_.options().repetitions;
+		size_t records = sharing == ContainerSharing::shared ? n : std::max<size_t>(n / threads, 1);
+
+		return ConcurrentBenchmark<TreeType>(options).run(threads, sharing,
+			[&](TreeType& tree) { preload_workload<int>(tree, records); },
+			[&](auto& access, size_t thread, size_t i) -> size_t
+			{
+				uint64_t draw = workload_mix64((static_cast<uint64_t>(thread) << 40) ^ i);
+				WorkloadOp op;
+				op.id = (draw >> 8) % (records * 2);
+				if (draw % 100 < read_percent)
+				{
+					op.type = WorkloadOpType::read;
+					return access.read([&](TreeType& tree) { return apply_workload_op<int>(tree, op); });
+				}
+				op.type = (i & 1) ? WorkloadOpType::erase : WorkloadOpType::insert;
+				return access.write([&](TreeType& tree) { return apply_workload_op<int>(tree, op); });
 			});
 	}
 
-	void print(const string name, long long my, long long stl)
+	void print(const string name, const BenchmarkStats& my, const BenchmarkStats& stl)
 	{
 		cout << name << ":\n";
-		cout << "  MyTree   = " << my << " ms\n";
-		cout << "  std::set= " << stl << " ms\n\n";
+		print_stats(benchmark_type_name<MyRBTree>(), my);
+		print_stats(benchmark_type_name<StdSet>(), stl);
+		cout << "\n";
+	}
+
+	void report(const string& name, size_t n, const BenchmarkStats& my, const BenchmarkStats& stl)
+	{
+		if (!reporter_)
+			return;
+		reporter_->add("tree", benchmark_type_name<MyRBTree>(), name, n, my);
+		reporter_->add("tree", benchmark_type_name<StdSet>(), name, n, stl);
 	}
 };
 
@@ -415,175 +840,629 @@ class MapBenchmark
 {
 private:
 	size_t n_;
+	BenchmarkRunner runner_;
+	BenchmarkReporter* reporter_ = nullptr;
 public:
-	explicit MapBenchmark(size_t n) : n_(n) {}
+	explicit MapBenchmark(size_t n, BenchmarkOptions options = {}) : n_(n), runner_(options) {}
+
+	void set_reporter(BenchmarkReporter& reporter)
+	{
+		reporter_ = &reporter;
+	}
 
+	/// <summary>
+	/// ,      (lower_upper    ).
+	/// </summary>
 	void run_all()
 	{
-		run("emplace",
-			[&] { return emplace<MyHashTable>(n_); },
-			[&] { return emplace<StdMap>(n_); });
+		vector<BenchmarkCase> mine = cases<MyHashTable>();
+		vector<BenchmarkCase> stl = cases<StdMap>();
+		for (const BenchmarkCase& my : mine)
+			for (const BenchmarkCase& other : stl)
+				if (my.scenario == other.scenario)
+					run(my.scenario, my.measure, other.measure);
+	}
+
+	/// <summary>
+	///  run_all    (  ).
+	/// </summary>
+	template<typename MapType>
+	vector<BenchmarkCase> cases()
+	{
+		string name = benchmark_type_name<MapType>();
+		vector<BenchmarkCase> result;
+		result.push_back({ "emplace", name, n_, [this] { return emplace<MapType>(n_); } });
+		result.push_back({ "duplicate_emplace", name, n_, [this] { return duplicate_emplace<MapType>(n_); } });
+		result.push_back({ "erase", name, n_, [this] { return erase<MapType>(n_); } });
+		result.push_back({ "erase_random", name, n_, [this] { return erase_random<MapType>(n_); } });
+		result.push_back({ "clear", name, n_, [this] { return clear<MapType>(n_); } });
+		result.push_back({ "iteration", name, n_, [this] { return iteration<MapType>(n_); } });
+		if constexpr (requires(MapType& map) { map.lower_bound(0); map.upper_bound(0); })
+			result.push_back({ "lower_upper", name, n_, [this] { return lower_upper<MapType>(n_); } });
+		return result;
+	}
+
+	void run_warm_start(const string& path)
+	{
+		{
+			MyHashTable map;
+			for (size_t i = 0; i < n_; ++i)
+				map.emplace(i, i);
+			map.save(path);
+		}
+
+		run("warm_start_open",
+			[&] { return warm_start<MyHashTable>(path, false); },
+			[&] { return warm_start<StdMap>(path, false); });
+
+		run("warm_start_lookup_all",
+			[&] { return warm_start<MyHashTable>(path, true); },
+			[&] { return warm_start<StdMap>(path, true); });
+	}
+
+	/// <summary>
+	///    :    ,    .
+	/// </summary>
+	void run_latency(size_t batch = 1)
+	{
+		run_latency("emplace_latency",
+			[&] { return emplace_latency<MyHashTable>(n_, batch); },
+			[&] { return emplace_latency<StdMap>(n_, batch); });
 
-		run("duplicate_emplace",
-			[&] { return duplicate_emplace<MyHashTable>(n_); },
-			[&] { return duplicate_emplace<StdMap>(n_); });
+		run_latency("erase_latency",
+			[&] { return erase_latency<MyHashTable>(n_, batch); },
+			[&] { return erase_latency<StdMap>(n_, batch); });
+	}
 
-		run("erase",
-			[&] { return erase<MyHashTable>(n_); },
-			[&] { return erase<StdMap>(n_); });
+	/// <summary>
+	/// n    threads : read_percent   ,    .
+	/// </summary>
+	void run_concurrent(size_t threads, unsigned read_percent, ContainerSharing sharing = ContainerSharing::shared)
+	{
+		run_concurrent(string("concurrent_") + sharing_name(sharing) + "_t" + to_string(threads) + "_r" + to_string(read_percent),
+			[&] { return concurrent<MyHashTable>(n_, threads, read_percent, sharing); },
+			[&] { return concurrent<StdMap>(n_, threads, read_percent, sharing); });
+	}
 
-		run("erase_random",
-			[&] { return erase_random<MyHashTable>(n_); },
-			[&] { return erase_random<StdMap>(n_); });
+	void run_concurrent_sweep(size_t max_threads = 0)
+	{
+		for (ContainerSharing sharing : { ContainerSharing::shared, ContainerSharing::per_thread })
+			for (unsigned read_percent : { 50u, 90u, 99u })
+				for (size_t threads : ConcurrentBenchmark<MyHashTable>::thread_counts(max_threads))
+					run_concurrent(threads, read_percent, sharing);
+	}
+
+	/// <summary>
+	///  YCSB AF: n  ,  n .
+	/// </summary>
+	void run_ycsb()
+	{
+		for (char letter : { 'A', 'B', 'C', 'D', 'E', 'F' })
+			run_workload(WorkloadSpec::ycsb(letter));
+	}
+
+	void run_workload(const WorkloadSpec& spec)
+	{
+		run_workload(Workload::generate(spec, n_, n_));
+	}
 
-		run("clear",
-			[&] { return clear<MyHashTable>(n_); },
-			[&] { return clear<StdMap>(n_); });
+	void run_workload(const Workload& workload)
+	{
+		run(workload.name,
+			[&] { return workload_mix<MyHashTable>(workload); },
+			[&] { return workload_mix<StdMap>(workload); });
+	}
 
-		run("iteration",
-			[&] { return iteration<MyHashTable>(n_); },
-			[&] { return iteration<StdMap>(n_); });
+	/// <summary>
+	///      (  Workload::save_trace).
+	/// </summary>
+	void run_trace(const string& path)
+	{
+		run_workload(Workload::load_trace(path));
 	}
 
 private:
 	template<typename F1, typename F2>
 	void run(const string& name, F1 my, F2 stl)
 	{
-		long long my_time = my();
-		long long stl_time = stl();
-		print(name, my_time, stl_time);
+		BenchmarkStats my_stats = my();
+		BenchmarkStats stl_stats = stl();
+		print(name, my_stats, stl_stats);
+		report(name, n_, my_stats, stl_stats);
 	}
 
-	template<typename Func>
-	long long benchmark(Func f)
+	template<typename MapType>
+	static void fill(MapType& map, size_t n)
 	{
-		auto start = Clock::now();
-		f();
-		auto end = Clock::now();
-		return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		for (size_t i = 0; i < n; ++i)
+		{
+			map.emplace(i, i);
+		}
 	}
 
-	template<typename MapType>
-	long long emplace(size_t n)
+	template<typename F1, typename F2>
+	void run_latency(const string& name, F1 my, F2 stl)
 	{
-		MapType map;
+		LatencyStats my_stats = my();
+		LatencyStats stl_stats = stl();
+		cout << name << ":\n";
+		print_latency(benchmark_type_name<MyHashTable>(), my_stats);
+		print_latency(benchmark_type_name<StdMap>(), stl_stats);
+		cout << "\n";
+		if (reporter_)
+		{
+			reporter_->add_latency("map", benchmark_type_name<MyHashTable>(), name, n_, my_stats);
+			reporter_->add_latency("map", benchmark_type_name<StdMap>(), name, n_, stl_stats);
+		}
+	}
 
-		return benchmark([&]()
+	template<typename F1, typename F2>
+	void run_concurrent(const string& name, F1 my, F2 stl)
+	{
+		ConcurrentStats my_stats = my();
+		ConcurrentStats stl_stats = stl();
+		cout << name << ":\n";
+		print_concurrent(benchmark_type_name<MyHashTable>(), my_stats);
+		print_concurrent(benchmark_type_name<StdMap>(), stl_stats);
+		cout << "\n";
+		if (reporter_)
+		{
+			reporter_->add("map", benchmark_type_name<MyHashTable>(), name, n_, my_stats.per_op);
+			reporter_->add("map", benchmark_type_name<StdMap>(), name, n_, stl_stats.per_op);
+			reporter_->add_latency("map", benchmark_type_name<MyHashTable>(), name, n_, my_stats.latency);
+			reporter_->add_latency("map", benchmark_type_name<StdMap>(), name, n_, stl_stats.latency);
+		}
+	}
+
+	template<typename MapType>
+	ConcurrentStats concurrent(size_t n, size_t threads, unsigned read_percent, ContainerSharing sharing)
+	{
+		using Key = typename MapType::key_type;
+		ConcurrentOptions options;
+		options.ops_per_thread = std::max<size_t>(n / threads, 1);
+		options.repetitions = runner_.options().repetitions;
+		size_t records = sharing == ContainerSharing::shared ? n : std::max<size_t>(n / threads, 1);
+
+		return ConcurrentBenchmark<MapType>(options).run(threads, sharing,
+			[&](MapType& map) { preload_workload<Key>(map, records); },
+			[&](auto& access, size_t thread, size_t i) -> size_t
 			{
-				for (size_t i = 0; i < n; ++i)
+				uint64_t draw = workload_mix64((static_cast<uint64_t>(thread) << 40) ^ i);
+				WorkloadOp op;
+				op.id = (draw >> 8) % records;
+				if (draw % 100 < read_percent)
 				{
-					map.emplace(i, i);
+					op.type = WorkloadOpType::read;
+					return access.read([&](MapType& map) { return apply_workload_op<Key>(map, op); });
 				}
+				op.type = WorkloadOpType::update;
+				return access.write([&](MapType& map) { return apply_workload_op<Key>(map, op); });
 			});
 	}
 
 	template<typename MapType>
-	long long duplicate_emplace(size_t n)
+	BenchmarkStats workload_mix(const Workload& workload)
 	{
-		MapType map;
+		return runner_.measure_fresh<MapType>([&](MapType& map) { preload_workload<typename MapType::key_type>(map, workload.records); }, [&](MapType& map)
+			{
+				size_t hits = 0;
+				for (const WorkloadOp& op : workload.ops)
+					hits += apply_workload_op<typename MapType::key_type>(map, op);
+				do_not_optimize(hits);
+			}, workload.ops.size());
+	}
+
+	template<typename MapType>
+	LatencyStats emplace_latency(size_t n, size_t batch)
+	{
+		return runner_.measure_latency<MapType>([](MapType&) {}, [](MapType& map, size_t i) { map.emplace(i, i); }, n, batch);
+	}
+
+	template<typename MapType>
+	LatencyStats erase_latency(size_t n, size_t batch)
+	{
+		std::vector<int> keys(n);
 		for (size_t i = 0; i < n; ++i)
-		{
-			map.emplace(i, i);
-		}
-		return benchmark([&]()
+			keys[i] = i;
+		std::mt19937 gen(42);
+		std::shuffle(keys.begin(), keys.end(), gen);
+
+		return runner_.measure_latency<MapType>([&](MapType& map) { fill(map, n); }, [&](MapType& map, size_t i) { map.erase(keys[i]); }, n, batch);
+	}
+
+	template<typename MapType>
+	BenchmarkStats emplace(size_t n)
+	{
+		return runner_.measure_fresh<MapType>([](MapType&) {}, [&](MapType& map)
 			{
 				for (size_t i = 0; i < n; ++i)
 				{
 					map.emplace(i, i);
 				}
-			});
+			}, n);
 	}
 
 	template<typename MapType>
-	long long erase(size_t n)
+	BenchmarkStats duplicate_emplace(size_t n)
 	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		MapType map;
-		for (size_t i = 0; i < n; ++i)
-		{
-			map.emplace(i, i);
-		}
+		fill(map, n);
+		return runner_.measure([&]()
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					map.emplace(i, i);
+				}
+			}, n, prepared_from);
+	}
 
-		return benchmark([&]()
+	template<typename MapType>
+	BenchmarkStats erase(size_t n)
+	{
+		return runner_.measure_fresh<MapType>([&](MapType& map) { fill(map, n); }, [&](MapType& map)
 			{
-				int i = 0;
 				for (size_t i = 0; i < n; ++i)
 					map.erase(i);
-			});
+			}, n);
 	}
 
 	template<typename MapType>
-	long long erase_random(size_t n)
+	BenchmarkStats erase_random(size_t n)
 	{
-		MapType map;
 		std::vector<int> keys(n);
-
 		for (size_t i = 0; i < n; ++i)
-		{
 			keys[i] = i;
-			map.emplace(i, i);
-		}
 
 		std::mt19937 gen(42);
 		std::shuffle(keys.begin(), keys.end(), gen);
 
-		return benchmark([&]
+		return runner_.measure_fresh<MapType>([&](MapType& map) { fill(map, n); }, [&](MapType& map)
 			{
 				for (int k : keys)
 				{
 					map.erase(k);
 				}
-			});
+			}, n);
 	}
 
 	template<typename MapType>
-	long long clear(size_t n)
+	BenchmarkStats clear(size_t n)
 	{
-		MapType map;
-		for (size_t i = 0; i < n; ++i)
-			map.emplace(i, i);
-
-		return benchmark([&]()
+		return runner_.measure_fresh<MapType>([&](MapType& map) { fill(map, n); }, [](MapType& map)
 			{
 				map.clear();
-			});
+			}, n);
 	}
 
 	template<typename MapType>
-	long long iteration(size_t n)
+	BenchmarkStats iteration(size_t n)
 	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		MapType map;
-		for (size_t i = 0; i < n; ++i)
-			map.emplace(i, i);
-
-		volatile size_t sum = 0;
+		fill(map, n);
 
-		return benchmark([&]
+		return runner_.measure([&]
 			{
+				size_t sum = 0;
 				for (auto& [k, v] : map)
 					sum += k;
-			});
+				do_not_optimize(sum);
+			}, n, prepared_from);
 	}
 
 	template<typename MapType>
-	long long lower_upper(size_t n)
+	BenchmarkStats warm_start(const string& path, bool lookup_all)
 	{
+		//     measure_fresh,  footprint ,     .
+		if constexpr (requires { MapType::open_mmap(path); })
+		{
+			using Opened = decltype(MapType::open_mmap(path));
+			return runner_.measure_fresh<std::optional<Opened>>([](std::optional<Opened>&) {}, [&](std::optional<Opened>& map)
+				{
+					map.emplace(MapType::open_mmap(path));
+					size_t local = 0;
+					if (lookup_all)
+						for (size_t i = 0; i < n_; ++i)
+							local += map->at(i);
+					do_not_optimize(local);
+				}, lookup_all ? n_ : 1);
+		}
+		else
+		{
+			return runner_.measure_fresh<MapType>([](MapType&) {}, [&](MapType& map)
+				{
+					fill(map, n_);
+					size_t local = 0;
+					if (lookup_all)
+						for (size_t i = 0; i < n_; ++i)
+							local += map.at(i);
+					do_not_optimize(local);
+				}, lookup_all ? n_ : 1);
+		}
+	}
+
+	template<typename MapType>
+	BenchmarkStats lower_upper(size_t n)
+	{
+		AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
 		MapType map;
-		for (size_t i = 0; i < n; ++i)
-			map.emplace(i,i);
-		return benchmark([&]()
+		fill(map, n);
+		return runner_.measure([&]()
 			{
 				for (size_t i = 0; i < n; ++i)
 				{
-					map.lower_bound(i);
-					map.upper_bound(i);
+					do_not_optimize(map.lower_bound(i));
+					do_not_optimize(map.upper_bound(i));
 				}
-			});
+			}, 2 * n, prepared_from);
+	}
+
+	void print(const string name, const BenchmarkStats& my, const BenchmarkStats& stl)
+	{
+		cout << name << ":\n";
+		print_stats(benchmark_type_name<MyHashTable>(), my);
+		print_stats(benchmark_type_name<StdMap>(), stl);
+		cout << "\n";
+	}
+
+	void report(const string& name, size_t n, const BenchmarkStats& my, const BenchmarkStats& stl)
+	{
+		if (!reporter_)
+			return;
+		reporter_->add("map", benchmark_type_name<MyHashTable>(), name, n, my);
+		reporter_->add("map", benchmark_type_name<StdMap>(), name, n, stl);
+	}
+};
+template<typename MyRBTree, typename MyNode>
+class FrozenLayoutBenchmark
+{
+private:
+	using FrozenType = decltype(declval<MyRBTree&>().freeze());
+
+	size_t n_;
+	vector<int> keys_;
+	vector<int> queries_;
+	optional<MyRBTree> tree_;
+	optional<FrozenType> frozen_;
+	vector<int> sorted_;
+	BenchmarkRunner runner_;
+	BenchmarkReporter* reporter_ = nullptr;
+public:
+	explicit FrozenLayoutBenchmark(size_t n, BenchmarkOptions options = {}) : n_(n), runner_(options)
+	{
+		mt19937 rng(42);
+		for (size_t i = 0; i < n_; ++i)
+			keys_.push_back(static_cast<int>(i * 2));
+		for (size_t i = 0; i < n_; ++i)
+			queries_.push_back(static_cast<int>(rng() % (n_ * 2 + 1)));
+	}
+
+	void set_reporter(BenchmarkReporter& reporter)
+	{
+		reporter_ = &reporter;
+	}
+
+	void run_all()
+	{
+		vector<BenchmarkCase> all = cases();
+		for (size_t i = 0; i + 2 < all.size(); i += 3)
+			run(all[i].scenario, all[i].measure, all[i + 1].measure, all[i + 2].measure);
+
+		cout << "bytes per element:\n";
+		cout << "  RBTree node  = " << sizeof(MyNode) << "\n";
+		cout << "  sorted array = " << sizeof(int) << "\n";
+		cout << "  Eytzinger    = " << static_cast<double>(frozen_->memory_bytes()) / n_ << "\n\n";
+	}
+
+	/// <summary>
+	///  run_all : ,  ,  .  
+	///   .
+	/// </summary>
+	vector<BenchmarkCase> cases()
+	{
+		string tree = benchmark_type_name<MyRBTree>();
+		string sorted = "sorted " + benchmark_type_name<vector<int>>();
+		string eytzinger = benchmark_type_name<FrozenType>();
+		return {
+			{ "lower_bound", tree, n_, [this] { build_layouts(); return lower_bound_tree(*tree_); } },
+			{ "lower_bound", sorted, n_, [this] { build_layouts(); return lower_bound_sorted(sorted_); } },
+			{ "lower_bound", eytzinger, n_, [this] { build_layouts(); return lower_bound_tree(*frozen_); } },
+			{ "find", tree, n_, [this] { build_layouts(); return find_tree(*tree_); } },
+			{ "find", sorted, n_, [this] { build_layouts(); return find_sorted(sorted_); } },
+			{ "find", eytzinger, n_, [this] { build_layouts(); return find_tree(*frozen_); } },
+			{ "iteration", tree, n_, [this] { build_layouts(); return iteration(*tree_); } },
+			{ "iteration", sorted, n_, [this] { build_layouts(); return iteration(sorted_); } },
+			{ "iteration", eytzinger, n_, [this] { build_layouts(); return iteration(*frozen_); } }
+		};
+	}
+
+private:
+	void build_layouts()
+	{
+		if (tree_)
+			return;
+		tree_.emplace();
+		for (int key : keys_)
+			tree_->insert(key);
+		frozen_.emplace(tree_->freeze());
+		sorted_ = keys_;
+	}
+
+	template<typename F1, typename F2, typename F3>
+	void run(const string& name, F1 tree, F2 sorted, F3 eytzinger)
+	{
+		BenchmarkStats tree_stats = tree();
+		BenchmarkStats sorted_stats = sorted();
+		BenchmarkStats eytzinger_stats = eytzinger();
+		print(name, tree_stats, sorted_stats, eytzinger_stats);
+		report(name, tree_stats, sorted_stats, eytzinger_stats);
 	}
 
-	void print(const string name, long long my, long long stl)
+	template<typename TreeType>
+	BenchmarkStats lower_bound_tree(TreeType& tree)
+	{
+		return runner_.measure([&]
+			{
+				size_t hits = 0;
+				for (int q : queries_)
+					hits += tree.lower_bound(q) != tree.end();
+				do_not_optimize(hits);
+			}, queries_.size());
+	}
+
+	BenchmarkStats lower_bound_sorted(const vector<int>& sorted)
+	{
+		return runner_.measure([&]
+			{
+				size_t hits = 0;
+				for (int q : queries_)
+					hits += std::lower_bound(sorted.begin(), sorted.end(), q) != sorted.end();
+				do_not_optimize(hits);
+			}, queries_.size());
+	}
+
+	template<typename TreeType>
+	BenchmarkStats find_tree(TreeType& tree)
+	{
+		return runner_.measure([&]
+			{
+				size_t hits = 0;
+				for (int q : queries_)
+					hits += tree.find(q) != tree.end();
+				do_not_optimize(hits);
+			}, queries_.size());
+	}
+
+	BenchmarkStats find_sorted(const vector<int>& sorted)
+	{
+		return runner_.measure([&]
+			{
+				size_t hits = 0;
+				for (int q : queries_)
+					hits += std::binary_search(sorted.begin(), sorted.end(), q);
+				do_not_optimize(hits);
+			}, queries_.size());
+	}
+
+	template<typename Container>
+	BenchmarkStats iteration(const Container& container)
+	{
+		return runner_.measure([&]
+			{
+				size_t sum = 0;
+				for (auto x : container)
+					sum += x;
+				do_not_optimize(sum);
+			}, n_);
+	}
+
+	void print(const string name, const BenchmarkStats& tree, const BenchmarkStats& sorted, const BenchmarkStats& eytzinger)
 	{
 		cout << name << ":\n";
-		cout << "  MyHashTable                   = " << my << " ms\n";
-		cout << "  std::unordered_map / std::map = " << stl << " ms\n\n";
+		print_stats(benchmark_type_name<MyRBTree>(), tree);
+		print_stats("sorted " + benchmark_type_name<vector<int>>(), sorted);
+		print_stats(benchmark_type_name<FrozenType>(), eytzinger);
+		cout << "\n";
 	}
-};
\ No newline at end of file
+
+	void report(const string& name, const BenchmarkStats& tree, const BenchmarkStats& sorted, const BenchmarkStats& eytzinger)
+	{
+		if (!reporter_)
+			return;
+		reporter_->add("frozen", benchmark_type_name<MyRBTree>(), name, n_, tree);
+		reporter_->add("frozen", "sorted " + benchmark_type_name<vector<int>>(), name, n_, sorted);
+		reporter_->add("frozen", benchmark_type_name<FrozenType>(), name, n_, eytzinger);
+	}
+};
+
+template<typename MySorter>
+class ExternalSortBenchmark
+{
+private:
+	struct SortState
+	{
+		optional<MySorter> sorter;
+	};
+
+	size_t memory_budget_;
+	string directory_;
+	BenchmarkRunner runner_;
+	BenchmarkReporter* reporter_ = nullptr;
+public:
+	ExternalSortBenchmark(size_t memory_budget, const string& directory, BenchmarkOptions options = single_shot())
+		: memory_budget_(memory_budget), directory_(directory), runner_(options) {}
+
+	void set_reporter(BenchmarkReporter& reporter)
+	{
+		reporter_ = &reporter;
+	}
+
+	static BenchmarkOptions single_shot()
+	{
+		BenchmarkOptions options;
+		options.warmup = chrono::nanoseconds(0);
+		options.min_sample_time = chrono::nanoseconds(0);
+		options.repetitions = 1;
+		return options;
+	}
+
+	void run_all(const vector<uint64_t>& input_bytes)
+	{
+		for (uint64_t bytes : input_bytes)
+			run(bytes);
+	}
+
+private:
+	void push_all(SortState& state, uint64_t n)
+	{
+		state.sorter.emplace(memory_budget_, directory_);
+		mt19937_64 rng(n);
+		for (uint64_t i = 0; i < n; ++i)
+			state.sorter->push(rng());
+	}
+
+	void run(uint64_t bytes)
+	{
+		uint64_t n = bytes / sizeof(uint64_t);
+		size_t runs = 0;
+
+		BenchmarkStats spill = runner_.measure_fresh<SortState>([](SortState&) {}, [&](SortState& state)
+			{
+				push_all(state, n);
+				runs = state.sorter->run_count();
+			}, n);
+
+		bool ok = true;
+		BenchmarkStats merge = runner_.measure_fresh<SortState>([&](SortState& state) { push_all(state, n); }, [&](SortState& state)
+			{
+				uint64_t previous = 0;
+				uint64_t count = 0;
+				bool sorted = true;
+				for (auto it = state.sorter->begin(); it != state.sorter->end(); ++it)
+				{
+					sorted &= previous <= *it;
+					previous = *it;
+					++count;
+				}
+				ok &= sorted && count == n;
+			}, n);
+
+		print(bytes, runs, spill, merge, ok);
+		if (reporter_)
+		{
+			reporter_->add("external_sort", benchmark_type_name<MySorter>(), "run_generation", n, spill);
+			reporter_->add("external_sort", benchmark_type_name<MySorter>(), "merge", n, merge);
+		}
+	}
+
+	void print(uint64_t bytes, size_t runs, const BenchmarkStats& spill, const BenchmarkStats& merge, bool ok)
+	{
+		double megabytes = static_cast<double>(bytes) / (1 << 20);
+		double seconds = (spill.median + merge.median) * (bytes / sizeof(uint64_t)) / 1e9;
+		cout << "external_sort " << megabytes << " MB, budget " << static_cast<double>(memory_budget_) / (1 << 20) << " MB, " << runs << " runs:\n";
+		print_stats("run generation", spill);
+		print_stats("merge", merge);
+		cout << "  throughput = " << (seconds > 0 ? megabytes / seconds : 0) << " MB/s" << (ok ? "" : "  [NOT SORTED]") << "\n\n";
+	}
+};
@@ -0,0 +1,243 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BenchmarkReport.h"
+#include "BenchmarkRunner.h"
+
+/// <summary>
+///     : measure()  .
+/// </summary>
+struct BenchmarkCase
+{
+	std::string scenario;
+	std::string container;
+	/// <summary>
+	/// ,     (    ,    ).
+	/// </summary>
+	size_t n = 0;
+	std::function<BenchmarkStats()> measure;
+};
+
+/// <summary>
+///      n.       
+/// (. owned_benchmark_cases).
+/// </summary>
+using BenchmarkFactory = std::function<std::vector<BenchmarkCase>(size_t n, const BenchmarkOptions& options)>;
+
+/// <summary>
+///     (--mode): ,    ,   .
+/// </summary>
+struct BenchmarkModeArgs
+{
+	size_t n = 0;
+	BenchmarkOptions options;
+	/// <summary>
+	///     concurrent; 0    .
+	/// </summary>
+	size_t threads = 0;
+	/// <summary>
+	///    trace ( Workload::save_trace).
+	/// </summary>
+	std::string trace;
+	/// <summary>
+	///    external-sort  .
+	/// </summary>
+	std::vector<uint64_t> bytes;
+	/// <summary>
+	///   external-sort  :       .
+	/// </summary>
+	size_t budget = 0;
+	/// <summary>
+	///    external-sort;   std::filesystem::temp_directory_path().
+	/// </summary>
+	std::string temp_directory;
+};
+
+/// <summary>
+///  :       reporter.
+/// </summary>
+using BenchmarkModeRun = std::function<void(const BenchmarkModeArgs& args, BenchmarkReporter& reporter)>;
+
+/// <summary>
+///     ( ,  ECMAScript);    .
+/// </summary>
+struct BenchmarkFilter
+{
+	std::string suite;
+	std::string scenario;
+	std::string container;
+};
+
+/// <summary>
+///    .      main
+/// (register_benchmark_suite),   ,    .
+/// </summary>
+class BenchmarkRegistry
+{
+public:
+	struct Entry
+	{
+		std::string suite;
+		std::string scenario;
+		std::string container;
+		BenchmarkFactory factory;
+	};
+	/// <summary>
+	///     ,       (, ,
+	///  , ).  --mode,   --suite  --container.
+	/// </summary>
+	struct Mode
+	{
+		std::string mode;
+		std::string suite;
+		/// <summary>
+		///  ,  "ConcurrentSkipListSet&lt;int&gt; vs RBTree&lt;int&gt;".
+		/// </summary>
+		std::string containers;
+		/// <summary>
+		/// false      --n    .
+		/// </summary>
+		bool sized = true;
+		BenchmarkModeRun run;
+	};
+
+private:
+	std::vector<Entry> entries_;
+	std::vector<Mode> modes_;
+
+public:
+	static BenchmarkRegistry& instance()
+	{
+		static BenchmarkRegistry registry;
+		return registry;
+	}
+
+	/// <summary>
+	///  .       n = 0,     
+	///    .    .
+	/// </summary>
+	size_t add_suite(const std::string& suite, BenchmarkFactory factory)
+	{
+		std::vector<BenchmarkCase> cases = factory(0, BenchmarkOptions{});
+		for (const BenchmarkCase& benchmark : cases)
+			entries_.push_back({ suite, benchmark.scenario, benchmark.container, factory });
+		return cases.size();
+	}
+
+	const std::vector<Entry>& entries() const
+	{
+		return entries_;
+	}
+
+	/// <summary>
+	///  .  1       .
+	/// </summary>
+	size_t add_mode(Mode mode)
+	{
+		modes_.push_back(std::move(mode));
+		return 1;
+	}
+
+	const std::vector<Mode>& modes() const
+	{
+		return modes_;
+	}
+
+	/// <summary>
+	///     mode,   filter.suite  filter.container,   .
+	/// </summary>
+	/// <exception cref="std::regex_error"> .</exception>
+	std::vector<size_t> select_modes(const std::string& mode, const BenchmarkFilter& filter) const
+	{
+		std::regex suite(filter.suite);
+		std::regex containers(filter.container);
+		std::vector<size_t> result;
+		for (size_t i = 0; i < modes_.size(); ++i)
+			if (modes_[i].mode == mode && std::regex_search(modes_[i].suite, suite) && std::regex_search(modes_[i].containers, containers))
+				result.push_back(i);
+		return result;
+	}
+
+	/// <summary>
+	///      .
+	/// </summary>
+	/// <exception cref="std::regex_error"> .</exception>
+	std::vector<size_t> select(const BenchmarkFilter& filter) const
+	{
+		std::regex suite(filter.suite);
+		std::regex scenario(filter.scenario);
+		std::regex container(filter.container);
+		std::vector<size_t> result;
+		for (size_t i = 0; i < entries_.size(); ++i)
+			if (std::regex_search(entries_[i].suite, suite) && std::regex_search(entries_[i].scenario, scenario)
+				&& std::regex_search(entries_[i].container, container))
+				result.push_back(i);
+		return result;
+	}
+
+	/// <summary>
+	///    index   n.
+	/// </summary>
+	BenchmarkCase make_case(size_t index, size_t n, const BenchmarkOptions& options) const
+	{
+		const Entry& entry = entries_.at(index);
+		for (BenchmarkCase& benchmark : entry.factory(n, options))
+			if (benchmark.scenario == entry.scenario && benchmark.container == entry.container)
+				return std::move(benchmark);
+		throw std::logic_error("benchmark factory no longer provides " + entry.suite + "/" + entry.scenario + "/" + entry.container);
+	}
+};
+
+/// <summary>
+///        :      this.
+/// </summary>
+template<class Suite>
+std::vector<BenchmarkCase> owned_benchmark_cases(std::shared_ptr<Suite> suite, std::vector<BenchmarkCase> cases)
+{
+	for (BenchmarkCase& benchmark : cases)
+		benchmark.measure = [suite, measure = std::move(benchmark.measure)] { return measure(); };
+	return cases;
+}
+
+/// <summary>
+///    Suite&lt;Mine, Std&gt; (ListBenchmark, RBTreeBenchmark, MapBenchmark)  
+///  :   Container   Suite&lt;Container, Container&gt;::cases&lt;Container&gt;().
+/// <code>
+/// static const size_t tree_benchmarks = register_benchmark_suite&lt;RBTreeBenchmark, RBTree&lt;int&gt;, std::set&lt;int&gt;&gt;("tree");
+/// </code>
+/// </summary>
+template<template<class, class> class Suite, class... Containers>
+size_t register_benchmark_suite(const std::string& suite, BenchmarkRegistry& registry = BenchmarkRegistry::instance())
+{
+	return (registry.add_suite(suite, [](size_t n, const BenchmarkOptions& options)
+		{
+			auto benchmark = std::make_shared<Suite<Containers, Containers>>(n, options);
+			return owned_benchmark_cases(benchmark, benchmark->template cases<Containers>());
+		}) + ...);
+}
+
+/// <summary>
+///     Suite&lt;Mine, Other&gt;: run(benchmark, args)    run_*.
+/// <code>
+/// static const size_t latency_modes = register_benchmark_mode&lt;MapBenchmark, HashMapChaining&lt;int, int&gt;, std::unordered_map&lt;int, int&gt;&gt;(
+/// 	"latency", "map", [](auto&amp; benchmark, const BenchmarkModeArgs&amp;) { benchmark.run_latency(); });
+/// </code>
+/// </summary>
+template<template<class, class> class Suite, class Mine, class Other, class Run>
+size_t register_benchmark_mode(const std::string& mode, const std::string& suite, Run run, BenchmarkRegistry& registry = BenchmarkRegistry::instance())
+{
+	return registry.add_mode({ mode, suite, benchmark_type_name<Mine>() + " vs " + benchmark_type_name<Other>(), true,
+		[run](const BenchmarkModeArgs& args, BenchmarkReporter& reporter)
+		{
+			Suite<Mine, Other> benchmark(args.n, args.options);
+			benchmark.set_reporter(reporter);
+			run(benchmark, args);
+		} });
+}
@@ -0,0 +1,767 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "BenchmarkRunner.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// <summary>
+///     ,     ,  "List&lt;int&gt;".
+/// </summary>
+template<class T>
+std::string benchmark_type_name()
+{
+#if defined(_MSC_VER)
+	std::string signature = __FUNCSIG__;
+	size_t start = signature.find("benchmark_type_name<") + sizeof("benchmark_type_name<") - 1;
+	size_t end = signature.rfind(">(void)");
+	std::string name = signature.substr(start, end - start);
+	for (const char* keyword : { "class ", "struct " })
+	{
+		for (size_t pos = name.find(keyword); pos != std::string::npos; pos = name.find(keyword))
+			name.erase(pos, std::char_traits<char>::length(keyword));
+	}
+	return name;
+#else
+	std::string signature = __PRETTY_FUNCTION__;
+	size_t start = signature.find("T = ") + 4;
+	size_t end = signature.find(';', start);
+	if (end == std::string::npos)
+		end = signature.rfind(']');
+	return signature.substr(start, end - start);
+#endif
+}
+
+/// <summary>
+/// ,    :         .
+/// </summary>
+struct BenchmarkEnvironment
+{
+	std::string compiler;
+	std::string cpu;
+	unsigned threads = 0;
+	/// <summary>
+	/// "release"  "debug" ( NDEBUG).
+	/// </summary>
+	std::string build;
+	/// <summary>
+	///    UTC, ISO 8601.
+	/// </summary>
+	std::string timestamp;
+
+	static BenchmarkEnvironment current()
+	{
+		BenchmarkEnvironment environment;
+#if defined(__clang__)
+		environment.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+		environment.compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		environment.compiler = "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+		environment.compiler = "unknown";
+#endif
+		environment.cpu = cpu_name();
+		environment.threads = std::thread::hardware_concurrency();
+#if defined(NDEBUG)
+		environment.build = "release";
+#else
+		environment.build = "debug";
+#endif
+
+		std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+		std::tm utc{};
+#if defined(_MSC_VER)
+		gmtime_s(&utc, &now);
+#else
+		gmtime_r(&now, &utc);
+#endif
+		char buffer[32];
+		std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+		environment.timestamp = buffer;
+		return environment;
+	}
+
+private:
+	static std::string cpu_name()
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int registers[4];
+		__cpuid(registers, 0x80000000);
+		if (static_cast<unsigned>(registers[0]) >= 0x80000004)
+		{
+			char brand[49] = {};
+			for (int i = 0; i < 3; ++i)
+			{
+				__cpuid(registers, 0x80000002 + i);
+				std::memcpy(brand + 16 * i, registers, sizeof(registers));
+			}
+			return trim(brand);
+		}
+#else
+		std::ifstream cpuinfo("/proc/cpuinfo");
+		std::string line;
+		while (std::getline(cpuinfo, line))
+		{
+			if (line.rfind("model name", 0) == 0)
+			{
+				size_t colon = line.find(':');
+				if (colon != std::string::npos)
+					return trim(line.substr(colon + 1));
+			}
+		}
+#endif
+		return "unknown";
+	}
+	static std::string trim(const std::string& text)
+	{
+		size_t first = text.find_first_not_of(" \t");
+		size_t last = text.find_last_not_of(" \t");
+		return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+	}
+};
+
+/// <summary>
+///   :  ,   ,       .
+/// </summary>
+struct BenchmarkRecord
+{
+	/// <summary>
+	///  : list, tree, map, frozen, external_sort.
+	/// </summary>
+	std::string suite;
+	std::string container;
+	std::string scenario;
+	size_t n = 0;
+	BenchmarkStats stats;
+	BenchmarkEnvironment environment;
+
+	/// <summary>
+	/// ,        .
+	/// </summary>
+	std::tuple<std::string, std::string, std::string, size_t> key() const
+	{
+		return { suite, container, scenario, n };
+	}
+};
+
+/// <summary>
+///      (. BenchmarkRunner::measure_latency).
+/// </summary>
+struct LatencyRecord
+{
+	std::string suite;
+	std::string container;
+	std::string scenario;
+	size_t n = 0;
+	LatencyStats stats;
+};
+
+/// <summary>
+///        JSON  CSV.
+/// </summary>
+/// <remarks>
+/// CSV     : load_csv        .
+///      JSON.
+/// </remarks>
+class BenchmarkReporter
+{
+private:
+	BenchmarkEnvironment environment_;
+	std::vector<BenchmarkRecord> records_;
+	std::vector<LatencyRecord> latency_records_;
+
+public:
+	BenchmarkReporter() : environment_(BenchmarkEnvironment::current()) {}
+
+	void add(const std::string& suite, const std::string& container, const std::string& scenario, size_t n, const BenchmarkStats& stats)
+	{
+		records_.push_back({ suite, container, scenario, n, stats, environment_ });
+	}
+
+	void add_latency(const std::string& suite, const std::string& container, const std::string& scenario, size_t n, const LatencyStats& stats)
+	{
+		latency_records_.push_back({ suite, container, scenario, n, stats });
+	}
+
+	const std::vector<BenchmarkRecord>& records() const
+	{
+		return records_;
+	}
+	const std::vector<LatencyRecord>& latency_records() const
+	{
+		return latency_records_;
+	}
+	const BenchmarkEnvironment& environment() const
+	{
+		return environment_;
+	}
+
+	void write_json(std::ostream& out) const
+	{
+		out << "{\n  \"environment\": {\"compiler\": " << json_string(environment_.compiler)
+			<< ", \"cpu\": " << json_string(environment_.cpu)
+			<< ", \"threads\": " << environment_.threads
+			<< ", \"build\": " << json_string(environment_.build)
+			<< ", \"timestamp\": " << json_string(environment_.timestamp) << "},\n  \"benchmarks\": [";
+		for (size_t i = 0; i < records_.size(); ++i)
+		{
+			const BenchmarkRecord& record = records_[i];
+			out << (i ? ",\n" : "\n") << "    {\"suite\": " << json_string(record.suite)
+				<< ", \"container\": " << json_string(record.container)
+				<< ", \"scenario\": " << json_string(record.scenario)
+				<< ", \"n\": " << record.n
+				<< ", \"median_ns\": " << number(record.stats.median)
+				<< ", \"mean_ns\": " << number(record.stats.mean)
+				<< ", \"stddev_ns\": " << number(record.stats.stddev)
+				<< ", \"min_ns\": " << number(record.stats.min)
+				<< ", \"iterations\": " << record.stats.iterations
+				<< ", \"repetitions\": " << record.stats.repetitions
+				<< ", \"samples_ns\": [";
+			for (size_t s = 0; s < record.stats.samples.size(); ++s)
+				out << (s ? ", " : "") << number(record.stats.samples[s]);
+			const PerfCounterValues& counters = record.stats.counters;
+			out << "], \"counters_per_op\": {\"cycles\": " << number(counters.cycles)
+				<< ", \"instructions\": " << number(counters.instructions)
+				<< ", \"ipc\": " << number(counters.ipc())
+				<< ", \"l1d_misses\": " << number(counters.l1d_misses)
+				<< ", \"llc_misses\": " << number(counters.llc_misses)
+				<< ", \"branch_misses\": " << number(counters.branch_misses)
+				<< ", \"dtlb_misses\": " << number(counters.dtlb_misses) << "}";
+			const AllocationStats& memory = record.stats.memory;
+			out << ", \"operations\": " << record.stats.operations;
+			if (memory.tracked)
+				out << ", \"memory_per_run\": {\"allocations\": " << memory.allocations
+					<< ", \"deallocations\": " << memory.deallocations
+					<< ", \"bytes_allocated\": " << memory.bytes_allocated
+					<< ", \"peak_bytes\": " << memory.peak_bytes
+					<< ", \"footprint_bytes\": " << (memory.footprint_measured ? std::to_string(memory.footprint_bytes) : "null") << "}";
+			out << "}";
+		}
+		out << "\n  ],\n  \"latency\": [";
+		for (size_t i = 0; i < latency_records_.size(); ++i)
+		{
+			const LatencyRecord& record = latency_records_[i];
+			out << (i ? ",\n" : "\n") << "    {\"suite\": " << json_string(record.suite)
+				<< ", \"container\": " << json_string(record.container)
+				<< ", \"scenario\": " << json_string(record.scenario)
+				<< ", \"n\": " << record.n
+				<< ", \"p50_ns\": " << number(record.stats.p50)
+				<< ", \"p90_ns\": " << number(record.stats.p90)
+				<< ", \"p99_ns\": " << number(record.stats.p99)
+				<< ", \"p999_ns\": " << number(record.stats.p999)
+				<< ", \"max_ns\": " << number(record.stats.max)
+				<< ", \"mean_ns\": " << number(record.stats.mean)
+				<< ", \"count\": " << record.stats.count
+				<< ", \"batch\": " << record.stats.batch
+				<< ", \"timer_overhead_ns\": " << number(record.stats.timer_overhead) << "}";
+		}
+		out << "\n  ]\n}\n";
+	}
+
+	void write_csv(std::ostream& out) const
+	{
+		out << "suite,container,scenario,n,median_ns,mean_ns,stddev_ns,min_ns,iterations,repetitions,samples_ns,compiler,cpu,threads,build,timestamp,"
+			"cycles,instructions,l1d_misses,llc_misses,branch_misses,dtlb_misses,"
+			"operations,allocations,deallocations,bytes_allocated,peak_bytes,footprint_bytes\n";
+		for (const BenchmarkRecord& record : records_)
+		{
+			std::string samples;
+			for (size_t s = 0; s < record.stats.samples.size(); ++s)
+				samples += (s ? ";" : "") + number(record.stats.samples[s]);
+			const PerfCounterValues& counters = record.stats.counters;
+			const AllocationStats& memory = record.stats.memory;
+			auto memory_field = [&](size_t value) { return memory.tracked ? std::to_string(value) : std::string(); };
+
+			out << csv_field(record.suite) << ',' << csv_field(record.container) << ',' << csv_field(record.scenario) << ','
+				<< record.n << ',' << number(record.stats.median) << ',' << number(record.stats.mean) << ','
+				<< number(record.stats.stddev) << ',' << number(record.stats.min) << ','
+				<< record.stats.iterations << ',' << record.stats.repetitions << ',' << samples << ','
+				<< csv_field(record.environment.compiler) << ',' << csv_field(record.environment.cpu) << ','
+				<< record.environment.threads << ',' << record.environment.build << ',' << record.environment.timestamp << ','
+				<< number(counters.cycles) << ',' << number(counters.instructions) << ',' << number(counters.l1d_misses) << ','
+				<< number(counters.llc_misses) << ',' << number(counters.branch_misses) << ',' << number(counters.dtlb_misses) << ','
+				<< record.stats.operations << ',' << memory_field(memory.allocations) << ',' << memory_field(memory.deallocations) << ','
+				<< memory_field(memory.bytes_allocated) << ',' << memory_field(memory.peak_bytes) << ','
+				<< (memory.footprint_measured ? memory_field(memory.footprint_bytes) : std::string()) << '\n';
+		}
+	}
+
+	/// <summary>
+	///  ;    : .json  .csv.
+	/// </summary>
+	/// <exception cref="std::runtime_error">     .</exception>
+	void save(const std::string& path) const
+	{
+		bool json = ends_with(path, ".json");
+		if (!json && !ends_with(path, ".csv"))
+			throw std::runtime_error("BenchmarkReporter: unknown report format " + path);
+
+		std::ofstream out(path);
+		if (!out)
+			throw std::runtime_error("BenchmarkReporter: cannot open " + path);
+		if (json)
+			write_json(out);
+		else
+			write_csv(out);
+	}
+
+	/// <summary>
+	///  CSV,  write_csv.     .
+	/// </summary>
+	/// <exception cref="std::runtime_error">     .</exception>
+	static std::vector<BenchmarkRecord> load_csv(std::istream& in)
+	{
+		std::vector<BenchmarkRecord> records;
+		std::string line;
+		if (!std::getline(in, line) || line.rfind("suite,container,scenario,n,", 0) != 0)
+			throw std::runtime_error("BenchmarkReporter: not a benchmark CSV");
+
+		while (std::getline(in, line))
+		{
+			if (line.empty())
+				continue;
+			std::vector<std::string> fields = split_csv(line);
+			if (fields.size() != 16 && fields.size() != 22 && fields.size() != 28)
+				throw std::runtime_error("BenchmarkReporter: malformed CSV row: " + line);
+
+			BenchmarkRecord record;
+			record.suite = fields[0];
+			record.container = fields[1];
+			record.scenario = fields[2];
+			record.n = std::stoull(fields[3]);
+			record.stats.median = std::stod(fields[4]);
+			record.stats.mean = std::stod(fields[5]);
+			record.stats.stddev = std::stod(fields[6]);
+			record.stats.min = std::stod(fields[7]);
+			record.stats.iterations = std::stoull(fields[8]);
+			record.stats.repetitions = std::stoull(fields[9]);
+			std::istringstream samples(fields[10]);
+			for (std::string sample; std::getline(samples, sample, ';');)
+				record.stats.samples.push_back(std::stod(sample));
+			record.environment.compiler = fields[11];
+			record.environment.cpu = fields[12];
+			record.environment.threads = static_cast<unsigned>(std::stoul(fields[13]));
+			record.environment.build = fields[14];
+			record.environment.timestamp = fields[15];
+			if (fields.size() >= 22)
+			{
+				PerfCounterValues& counters = record.stats.counters;
+				counters.cycles = parse_number(fields[16]);
+				counters.instructions = parse_number(fields[17]);
+				counters.l1d_misses = parse_number(fields[18]);
+				counters.llc_misses = parse_number(fields[19]);
+				counters.branch_misses = parse_number(fields[20]);
+				counters.dtlb_misses = parse_number(fields[21]);
+			}
+			if (fields.size() >= 28)
+			{
+				AllocationStats& memory = record.stats.memory;
+				record.stats.operations = std::stoull(fields[22]);
+				memory.tracked = !fields[23].empty();
+				if (memory.tracked)
+				{
+					memory.allocations = std::stoull(fields[23]);
+					memory.deallocations = std::stoull(fields[24]);
+					memory.bytes_allocated = std::stoull(fields[25]);
+					memory.peak_bytes = std::stoull(fields[26]);
+					memory.footprint_measured = !fields[27].empty();
+					if (memory.footprint_measured)
+						memory.footprint_bytes = std::stoull(fields[27]);
+				}
+			}
+			records.push_back(std::move(record));
+		}
+		return records;
+	}
+	static std::vector<BenchmarkRecord> load_csv(const std::string& path)
+	{
+		std::ifstream in(path);
+		if (!in)
+			throw std::runtime_error("BenchmarkReporter: cannot open " + path);
+		return load_csv(in);
+	}
+
+private:
+	static bool ends_with(const std::string& text, const std::string& suffix)
+	{
+		return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+	static std::string number(double value)
+	{
+		if (!std::isfinite(value))
+			return "null";
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+		return buffer;
+	}
+	static double parse_number(const std::string& text)
+	{
+		return text == "null" || text.empty() ? PerfCounterValues::unavailable : std::stod(text);
+	}
+	static std::string json_string(const std::string& text)
+	{
+		std::string result = "\"";
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				result += '\\';
+				result += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char buffer[8];
+				std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+				result += buffer;
+			}
+			else
+				result += c;
+		}
+		return result + "\"";
+	}
+	/// <summary>
+	///  CSV  RFC 4180:     ("BTreeSet&lt;int, 256&gt;"),    .
+	/// </summary>
+	static std::string csv_field(const std::string& text)
+	{
+		if (text.find_first_of(",\"\n") == std::string::npos)
+			return text;
+		std::string result = "\"";
+		for (char c : text)
+		{
+			if (c == '"')
+				result += '"';
+			result += c;
+		}
+		return result + "\"";
+	}
+	static std::vector<std::string> split_csv(const std::string& line)
+	{
+		std::vector<std::string> fields(1);
+		bool quoted = false;
+		for (size_t i = 0; i < line.size(); ++i)
+		{
+			char c = line[i];
+			if (quoted)
+			{
+				if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+				{
+					fields.back() += '"';
+					++i;
+				}
+				else if (c == '"')
+					quoted = false;
+				else
+					fields.back() += c;
+			}
+			else if (c == '"')
+				quoted = true;
+			else if (c == ',')
+				fields.emplace_back();
+			else if (c != '\r')
+				fields.back() += c;
+		}
+		return fields;
+	}
+};
+
+/// <summary>
+///     :        
+///  current  baseline,  .    ,    .
+/// </summary>
+/// <returns>p-; NaN,        .</returns>
+/// <remarks>
+///    (m + n &lt;= 40)  U  ,    .
+/// </remarks>
+inline double mann_whitney_greater_p(const std::vector<double>& baseline, const std::vector<double>& current)
+{
+	size_t m = baseline.size();
+	size_t n = current.size();
+	if (m < 2 || n < 2)
+		return std::numeric_limits<double>::quiet_NaN();
+
+	double u = 0;
+	for (double c : current)
+		for (double b : baseline)
+			u += c > b ? 1 : c == b ? 0.5 : 0;
+
+	if (m + n > 40)
+	{
+		double mean = m * n / 2.0;
+		double sigma = std::sqrt(m * n * (m + n + 1) / 12.0);
+		double z = (u - mean - 0.5) / sigma;
+		return 0.5 * std::erfc(z / std::sqrt(2.0));
+	}
+
+	// ways[i][j][k]    i  current  j  baseline,   U = k.
+	std::vector<std::vector<std::vector<double>>> ways(n + 1, std::vector<std::vector<double>>(m + 1));
+	for (size_t i = 0; i <= n; ++i)
+	{
+		for (size_t j = 0; j <= m; ++j)
+		{
+			std::vector<double>& cell = ways[i][j];
+			cell.assign(i * j + 1, 0);
+			if (i == 0 || j == 0)
+			{
+				cell[0] = 1;
+				continue;
+			}
+			//    current (  j  baseline)  baseline.
+			for (size_t k = j; k <= i * j; ++k)
+				cell[k] += ways[i - 1][j][k - j];
+			for (size_t k = 0; k < ways[i][j - 1].size(); ++k)
+				cell[k] += ways[i][j - 1][k];
+		}
+	}
+
+	const std::vector<double>& distribution = ways[n][m];
+	double total = 0;
+	double tail = 0;
+	double threshold = std::ceil(u - 1e-9);
+	for (size_t k = 0; k < distribution.size(); ++k)
+	{
+		total += distribution[k];
+		if (k >= threshold)
+			tail += distribution[k];
+	}
+	return tail / total;
+}
+
+/// <summary>
+///        .
+/// </summary>
+struct BenchmarkComparison
+{
+	BenchmarkRecord baseline;
+	BenchmarkRecord current;
+	/// <summary>
+	///   : +0.10   10% .
+	/// </summary>
+	double change = 0;
+	double p_value = 0;
+	bool regression = false;
+};
+
+/// <summary>
+///     .
+/// </summary>
+struct BenchmarkCompareOptions
+{
+	/// <summary>
+	///   ;   ,   .
+	/// </summary>
+	double threshold = 0.05;
+	/// <summary>
+	///      .
+	/// </summary>
+	double alpha = 0.05;
+};
+
+/// <summary>
+///    (suite, container, scenario, n).        threshold 
+///     alpha.     ( ),   .
+/// </summary>
+inline std::vector<BenchmarkComparison> compare_with_baseline(const std::vector<BenchmarkRecord>& baseline,
+	const std::vector<BenchmarkRecord>& current, BenchmarkCompareOptions options = {})
+{
+	std::map<std::tuple<std::string, std::string, std::string, size_t>, const BenchmarkRecord*> by_key;
+	for (const BenchmarkRecord& record : baseline)
+		by_key[record.key()] = &record;
+
+	std::vector<BenchmarkComparison> comparisons;
+	for (const BenchmarkRecord& record : current)
+	{
+		auto found = by_key.find(record.key());
+		if (found == by_key.end())
+			continue;
+
+		BenchmarkComparison comparison;
+		comparison.baseline = *found->second;
+		comparison.current = record;
+		comparison.change = comparison.baseline.stats.median > 0
+			? record.stats.median / comparison.baseline.stats.median - 1
+			: 0;
+		comparison.p_value = mann_whitney_greater_p(comparison.baseline.stats.samples, record.stats.samples);
+		bool significant = std::isnan(comparison.p_value) || comparison.p_value < options.alpha;
+		comparison.regression = comparison.change > options.threshold && significant;
+		comparisons.push_back(std::move(comparison));
+	}
+	return comparisons;
+}
+
+/// <summary>
+///       .
+/// </summary>
+inline size_t print_comparison(const std::vector<BenchmarkComparison>& comparisons)
+{
+	size_t regressions = 0;
+	for (const BenchmarkComparison& comparison : comparisons)
+	{
+		const BenchmarkRecord& record = comparison.current;
+		char p_value[16];
+		if (std::isnan(comparison.p_value))
+			std::snprintf(p_value, sizeof(p_value), "n/a");
+		else
+			std::snprintf(p_value, sizeof(p_value), "%.3f", comparison.p_value);
+
+		char buffer[512];
+		std::snprintf(buffer, sizeof(buffer), "  %-14s %-30s %-24s n=%-9zu %12s -> %12s  %+7.1f%%  p=%-6s %s\n",
+			record.suite.c_str(), record.container.c_str(), record.scenario.c_str(), record.n,
+			format_duration(comparison.baseline.stats.median).c_str(), format_duration(record.stats.median).c_str(),
+			comparison.change * 100, p_value, comparison.regression ? "REGRESSION" : "ok");
+		std::cout << buffer;
+		regressions += comparison.regression;
+	}
+	std::cout << regressions << " regression(s) in " << comparisons.size() << " compared benchmark(s)\n";
+	return regressions;
+}
+
+/// <summary>
+///      (  : -O2, -O3, -march, LTO, PGO).
+/// </summary>
+struct BenchmarkVariant
+{
+	std::string name;
+	std::vector<BenchmarkRecord> records;
+};
+
+/// <summary>
+///   :      .
+/// </summary>
+struct VariantComparisonRow
+{
+	std::string suite;
+	std::string container;
+	std::string scenario;
+	size_t n = 0;
+	/// <summary>
+	///       ; NaN      .
+	/// </summary>
+	std::vector<double> medians;
+	/// <summary>
+	///    .
+	/// </summary>
+	size_t best = 0;
+};
+
+/// <summary>
+///     (suite, container, scenario, n).      .
+/// </summary>
+inline std::vector<VariantComparisonRow> compare_variants(const std::vector<BenchmarkVariant>& variants)
+{
+	std::vector<VariantComparisonRow> rows;
+	std::map<std::tuple<std::string, std::string, std::string, size_t>, size_t> row_of;
+	for (size_t v = 0; v < variants.size(); ++v)
+		for (const BenchmarkRecord& record : variants[v].records)
+		{
+			auto [found, inserted] = row_of.emplace(record.key(), rows.size());
+			if (inserted)
+				rows.push_back({ record.suite, record.container, record.scenario, record.n,
+					std::vector<double>(variants.size(), std::numeric_limits<double>::quiet_NaN()) });
+			rows[found->second].medians[v] = record.stats.median;
+		}
+
+	for (VariantComparisonRow& row : rows)
+		for (size_t v = 0; v < row.medians.size(); ++v)
+			if (!std::isnan(row.medians[v]) && (std::isnan(row.medians[row.best]) || row.medians[v] < row.medians[row.best]))
+				row.best = v;
+	return rows;
+}
+
+/// <summary>
+///   :         ,  
+///   '*'.        ,    .
+/// </summary>
+inline void print_variant_table(std::ostream& out, const std::vector<BenchmarkVariant>& variants)
+{
+	std::vector<VariantComparisonRow> rows = compare_variants(variants);
+	std::vector<double> log_speedup(variants.size(), 0);
+	std::vector<size_t> compared(variants.size(), 0), wins(variants.size(), 0);
+	const int label_width = 52;
+	const int cell_width = 22;
+
+	char buffer[512];
+	std::snprintf(buffer, sizeof(buffer), "%-*s %10s", label_width, "benchmark", "n");
+	out << buffer;
+	for (const BenchmarkVariant& variant : variants)
+	{
+		std::snprintf(buffer, sizeof(buffer), " %*s ", cell_width - 1, variant.name.c_str());
+		out << buffer;
+	}
+	out << "\n";
+
+	for (const VariantComparisonRow& row : rows)
+	{
+		std::string label = row.suite + "/" + row.scenario + "  " + row.container;
+		std::snprintf(buffer, sizeof(buffer), "%-*s %10zu", label_width, label.c_str(), row.n);
+		out << buffer;
+		double base = row.medians.front();
+		for (size_t v = 0; v < variants.size(); ++v)
+		{
+			double median = row.medians[v];
+			std::string cell = "-";
+			if (!std::isnan(median))
+			{
+				cell = format_duration(median);
+				if (v > 0 && !std::isnan(base) && median > 0)
+				{
+					char speedup[32];
+					std::snprintf(speedup, sizeof(speedup), " x%.2f", base / median);
+					cell += speedup;
+					log_speedup[v] += std::log(base / median);
+					++compared[v];
+				}
+				cell += v == row.best ? '*' : ' ';
+				wins[v] += v == row.best;
+			}
+			else
+				cell += ' ';
+			std::snprintf(buffer, sizeof(buffer), " %*s", cell_width, cell.c_str());
+			out << buffer;
+		}
+		out << "\n";
+	}
+
+	std::snprintf(buffer, sizeof(buffer), "%-*s %10s", label_width,
+		("geometric mean speedup vs " + (variants.empty() ? std::string() : variants.front().name)).c_str(), "");
+	out << buffer;
+	for (size_t v = 0; v < variants.size(); ++v)
+	{
+		std::string cell = "- ";
+		if (v == 0)
+			cell = "x1.000 ";
+		else if (compared[v] > 0)
+		{
+			char speedup[32];
+			std::snprintf(speedup, sizeof(speedup), "x%.3f ", std::exp(log_speedup[v] / compared[v]));
+			cell = speedup;
+		}
+		std::snprintf(buffer, sizeof(buffer), " %*s", cell_width, cell.c_str());
+		out << buffer;
+	}
+	out << "\n";
+	std::snprintf(buffer, sizeof(buffer), "%-*s %10s", label_width, "fastest in rows", "");
+	out << buffer;
+	for (size_t v = 0; v < variants.size(); ++v)
+	{
+		std::snprintf(buffer, sizeof(buffer), " %*zu ", cell_width - 1, wins[v]);
+		out << buffer;
+	}
+	out << "\n";
+}
@@ -0,0 +1,417 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "AllocationTracker.h"
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// <summary>
+///      value  :   .
+/// </summary>
+template<class T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(_MSC_VER)
+	static volatile const void* sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// <summary>
+/// ,    ,        .
+/// </summary>
+inline void clobber_memory()
+{
+#if defined(_MSC_VER)
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : : "memory");
+#endif
+}
+
+/// <summary>
+///  .        .
+/// </summary>
+struct BenchmarkStats
+{
+	double median = 0;
+	double mean = 0;
+	double stddev = 0;
+	double min = 0;
+	/// <summary>
+	///        .
+	/// </summary>
+	size_t iterations = 0;
+	size_t repetitions = 0;
+	/// <summary>
+	///      .
+	/// </summary>
+	size_t operations = 0;
+	/// <summary>
+	///        ; NaN,  .
+	/// </summary>
+	PerfCounterValues counters;
+	/// <summary>
+	///       ( );      operations.
+	/// </summary>
+	AllocationStats memory;
+	/// <summary>
+	///     .
+	/// </summary>
+	std::vector<double> samples;
+};
+
+/// <summary>
+///  .
+/// </summary>
+struct BenchmarkOptions
+{
+	/// <summary>
+	///        ( , ,  ).
+	/// </summary>
+	std::chrono::nanoseconds warmup = std::chrono::milliseconds(100);
+	/// <summary>
+	///      ;     .
+	/// </summary>
+	std::chrono::nanoseconds min_sample_time = std::chrono::milliseconds(200);
+	size_t repetitions = 5;
+	size_t max_iterations = 1'000'000;
+	/// <summary>
+	///    (. PerfCounters).   ,    .
+	/// </summary>
+	bool hardware_counters = true;
+};
+
+/// <summary>
+///  : ,     min_sample_time,      .
+///      .
+/// </summary>
+class BenchmarkRunner
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+private:
+	BenchmarkOptions options_;
+
+public:
+	explicit BenchmarkRunner(BenchmarkOptions options = {}) : options_(options) {}
+
+	const BenchmarkOptions& options() const
+	{
+		return options_;
+	}
+
+	/// <summary>
+	///  ,        (,    ).
+	/// </summary>
+	/// <typeparam name="State"> ;        .</typeparam>
+	/// <param name="setup">setup(State&amp;)  ,  .</param>
+	/// <param name="body">body(State&amp;)   .</param>
+	/// <param name="ops">     body;     .</param>
+	template<class State, class Setup, class Body>
+	BenchmarkStats measure_fresh(Setup&& setup, Body&& body, size_t ops) const
+	{
+		PerfCounters counters(options_.hardware_counters);
+		AllocationStats memory;
+		auto run_once = [&]
+			{
+				AllocationTracker::Snapshot initial = AllocationTracker::snapshot();
+				std::optional<State> state;
+				state.emplace();
+				setup(*state);
+				AllocationTracker::reset_peak();
+				AllocationTracker::Snapshot before = AllocationTracker::snapshot();
+				counters.start();
+				clobber_memory();
+				auto start = Clock::now();
+				body(*state);
+				clobber_memory();
+				auto end = Clock::now();
+				counters.stop();
+				AllocationTracker::Snapshot after = AllocationTracker::snapshot();
+				memory = AllocationTracker::between(before, after);
+				memory.footprint_bytes = after.live_bytes > initial.live_bytes ? after.live_bytes - initial.live_bytes : 0;
+				memory.footprint_measured = true;
+				return end - start;
+			};
+		BenchmarkStats stats = measure_with(run_once, counters, ops);
+		stats.memory = memory;
+		return stats;
+	}
+	/// <summary>
+	///  ,           (, ).
+	/// </summary>
+	/// <param name="body">body()   .</param>
+	/// <param name="ops">     body.</param>
+	/// <param name="prepared_from"> AllocationTracker::snapshot(),    ;  
+	/// footprint_bytes   ,   .   footprint  .</param>
+	template<class Body>
+	BenchmarkStats measure(Body&& body, size_t ops, std::optional<AllocationTracker::Snapshot> prepared_from = std::nullopt) const
+	{
+		//    (PerfCounters)  footprint  .
+		size_t prepared_bytes = 0;
+		if (prepared_from)
+		{
+			size_t live = AllocationTracker::snapshot().live_bytes;
+			prepared_bytes = live > prepared_from->live_bytes ? live - prepared_from->live_bytes : 0;
+		}
+		PerfCounters counters(options_.hardware_counters);
+		AllocationStats memory;
+		auto run_once = [&]
+			{
+				AllocationTracker::reset_peak();
+				AllocationTracker::Snapshot before = AllocationTracker::snapshot();
+				counters.start();
+				clobber_memory();
+				auto start = Clock::now();
+				body();
+				clobber_memory();
+				auto end = Clock::now();
+				counters.stop();
+				AllocationTracker::Snapshot after = AllocationTracker::snapshot();
+				memory = AllocationTracker::between(before, after);
+				if (prepared_from)
+				{
+					memory.footprint_bytes = after.live_bytes + prepared_bytes > before.live_bytes ? after.live_bytes + prepared_bytes - before.live_bytes : 0;
+					memory.footprint_measured = true;
+				}
+				return end - start;
+			};
+		BenchmarkStats stats = measure_with(run_once, counters, ops);
+		stats.memory = memory;
+		return stats;
+	}
+
+	/// <summary>
+	///        .     
+	/// ;           .
+	/// </summary>
+	/// <param name="setup">setup(State&amp;)  ,  .</param>
+	/// <param name="op">op(State&amp;, i)  i- , i  0  ops - 1.</param>
+	/// <param name="ops">    .</param>
+	/// <param name="batch">      ;    
+	/// .     ,      .</param>
+	template<class State, class Setup, class Op>
+	LatencyStats measure_latency(Setup&& setup, Op&& op, size_t ops, size_t batch = 1) const
+	{
+		batch = std::max<size_t>(batch, 1);
+		double overhead = timer_overhead();
+		LatencyHistogram histogram;
+		size_t repetitions = std::max<size_t>(options_.repetitions, 1);
+		for (size_t r = 0; r < repetitions; ++r)
+		{
+			std::optional<State> state;
+			state.emplace();
+			setup(*state);
+			for (size_t i = 0; i < ops; i += batch)
+			{
+				size_t end = std::min(ops, i + batch);
+				clobber_memory();
+				auto start = Clock::now();
+				for (size_t j = i; j < end; ++j)
+					op(*state, j);
+				clobber_memory();
+				auto stop = Clock::now();
+				double ns = std::chrono::duration<double, std::nano>(stop - start).count() - overhead;
+				histogram.record(static_cast<uint64_t>(std::max(ns, 0.0) / (end - i) + 0.5), end - i);
+			}
+		}
+		return LatencyStats::from(histogram, batch, overhead);
+	}
+
+	/// <summary>
+	///      Clock::now(),  .
+	/// </summary>
+	static double timer_overhead()
+	{
+		static const double overhead = []
+			{
+				std::vector<double> samples(10'000);
+				for (double& sample : samples)
+				{
+					auto start = Clock::now();
+					clobber_memory();
+					auto stop = Clock::now();
+					sample = std::chrono::duration<double, std::nano>(stop - start).count();
+				}
+				std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+				return samples[samples.size() / 2];
+			}();
+		return overhead;
+	}
+
+	/// <summary>
+	///  , ,      samples.
+	/// </summary>
+	static void summarize(BenchmarkStats& stats)
+	{
+		std::vector<double> sorted = stats.samples;
+		std::sort(sorted.begin(), sorted.end());
+		size_t n = sorted.size();
+
+		stats.min = sorted.front();
+		stats.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+		double sum = 0;
+		for (double s : sorted)
+			sum += s;
+		stats.mean = sum / n;
+
+		double squares = 0;
+		for (double s : sorted)
+			squares += (s - stats.mean) * (s - stats.mean);
+		stats.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+	}
+
+private:
+	template<class RunOnce>
+	BenchmarkStats measure_with(RunOnce& run_once, PerfCounters& counters, size_t ops) const
+	{
+		if (options_.hardware_counters && !counters.available())
+			note_counters_unavailable(counters.status());
+
+		if (options_.warmup.count() > 0)
+		{
+			auto warmup_start = Clock::now();
+			do
+			{
+				run_once();
+			} while (Clock::now() - warmup_start < options_.warmup);
+		}
+
+		BenchmarkStats stats;
+		stats.repetitions = std::max<size_t>(options_.repetitions, 1);
+		stats.operations = std::max<size_t>(ops, 1);
+		size_t total_iterations = 0;
+		counters.reset();
+		for (size_t r = 0; r < stats.repetitions; ++r)
+		{
+			Clock::duration elapsed{};
+			size_t iterations = 0;
+			do
+			{
+				elapsed += run_once();
+				++iterations;
+			} while (elapsed < options_.min_sample_time && iterations < options_.max_iterations);
+
+			double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+			stats.samples.push_back(ns / (static_cast<double>(iterations) * std::max<size_t>(ops, 1)));
+			stats.iterations = iterations;
+			total_iterations += iterations;
+		}
+		if (counters.available())
+			stats.counters = counters.read().divided_by(static_cast<double>(total_iterations) * std::max<size_t>(ops, 1));
+		summarize(stats);
+		return stats;
+	}
+
+	/// <summary>
+	///        ,     .
+	/// </summary>
+	static void note_counters_unavailable(const std::string& status)
+	{
+		static bool noted = false;
+		if (noted)
+			return;
+		noted = true;
+		std::cerr << "hardware counters unavailable: " << status << "\n";
+	}
+};
+
+/// <summary>
+///       : ns, us, ms  s.
+/// </summary>
+inline std::string format_duration(double ns)
+{
+	const char* unit = "ns";
+	double value = ns;
+	if (ns >= 1e9)
+	{
+		value = ns / 1e9;
+		unit = "s";
+	}
+	else if (ns >= 1e6)
+	{
+		value = ns / 1e6;
+		unit = "ms";
+	}
+	else if (ns >= 1e3)
+	{
+		value = ns / 1e3;
+		unit = "us";
+	}
+
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.2f %s", value, unit);
+	return buffer;
+}
+
+/// <summary>
+///   : , ,      ;
+///        IPC    ,      
+///    .
+/// </summary>
+inline void print_stats(const std::string& label, const BenchmarkStats& stats)
+{
+	char buffer[256];
+	std::snprintf(buffer, sizeof(buffer), "  %-30s median %12s/op  mean %12s/op  stddev %12s/op  min %12s/op  (%zu x %zu)\n",
+		label.c_str(), format_duration(stats.median).c_str(), format_duration(stats.mean).c_str(),
+		format_duration(stats.stddev).c_str(), format_duration(stats.min).c_str(), stats.repetitions, stats.iterations);
+	std::cout << buffer;
+
+	if (stats.memory.tracked)
+	{
+		double ops = static_cast<double>(std::max<size_t>(stats.operations, 1));
+		char footprint[32] = "n/a";
+		if (stats.memory.footprint_measured)
+			std::snprintf(footprint, sizeof(footprint), "%.1f", stats.memory.footprint_bytes / ops);
+		std::snprintf(buffer, sizeof(buffer), "  %-30s allocs %.2f  bytes %.1f  peak %.1f  footprint %s  (per op)\n", "",
+			stats.memory.allocations / ops, stats.memory.bytes_allocated / ops, stats.memory.peak_bytes / ops, footprint);
+		std::cout << buffer;
+	}
+
+	const PerfCounterValues& counters = stats.counters;
+	if (!counters.available())
+		return;
+	auto value = [](double v, const char* format)
+		{
+			char text[32];
+			if (std::isnan(v))
+				std::snprintf(text, sizeof(text), "n/a");
+			else
+				std::snprintf(text, sizeof(text), format, v);
+			return std::string(text);
+		};
+	std::snprintf(buffer, sizeof(buffer), "  %-30s IPC %s  cycles %s  instr %s  L1d-miss %s  LLC-miss %s  br-miss %s  dTLB-miss %s  (per op)\n",
+		"", value(counters.ipc(), "%.2f").c_str(), value(counters.cycles, "%.1f").c_str(), value(counters.instructions, "%.1f").c_str(),
+		value(counters.l1d_misses, "%.3f").c_str(), value(counters.llc_misses, "%.3f").c_str(),
+		value(counters.branch_misses, "%.3f").c_str(), value(counters.dtlb_misses, "%.3f").c_str());
+	std::cout << buffer;
+}
+
+/// <summary>
+///    : ,    .
+/// </summary>
+inline void print_latency(const std::string& label, const LatencyStats& stats)
+{
+	char buffer[256];
+	std::snprintf(buffer, sizeof(buffer), "  %-30s p50 %10s  p90 %10s  p99 %10s  p99.9 %10s  max %10s  (%llu ops, batch %zu, timer %.0f ns)\n",
+		label.c_str(), format_duration(stats.p50).c_str(), format_duration(stats.p90).c_str(), format_duration(stats.p99).c_str(),
+		format_duration(stats.p999).c_str(), format_duration(stats.max).c_str(), static_cast<unsigned long long>(stats.count),
+		stats.batch, stats.timer_overhead);
+	std::cout << buffer;
+}
@@ -0,0 +1,482 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "BenchmarkRunner.h"
+#include "LatencyHistogram.h"
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/// <summary>
+///    ,     :    .
+/// </summary>
+struct NoLockPolicy
+{
+	template<class F>
+	decltype(auto) read(F&& f)
+	{
+		return f();
+	}
+	template<class F>
+	decltype(auto) write(F&& f)
+	{
+		return f();
+	}
+};
+
+/// <summary>
+///     .
+/// </summary>
+struct MutexPolicy
+{
+	std::mutex mutex;
+
+	template<class F>
+	decltype(auto) read(F&& f)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return f();
+	}
+	template<class F>
+	decltype(auto) write(F&& f)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return f();
+	}
+};
+
+/// <summary>
+///    ,   .
+/// </summary>
+struct SharedMutexPolicy
+{
+	std::shared_mutex mutex;
+
+	template<class F>
+	decltype(auto) read(F&& f)
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		return f();
+	}
+	template<class F>
+	decltype(auto) write(F&& f)
+	{
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		return f();
+	}
+};
+
+/// <summary>
+///   :      thread_safe = true,  SharedMutexPolicy.
+/// </summary>
+template<class Container>
+using DefaultConcurrentPolicy = std::conditional_t<requires { requires Container::thread_safe; }, NoLockPolicy, SharedMutexPolicy>;
+
+/// <summary>
+///         .
+/// </summary>
+enum class ContainerSharing
+{
+	shared,
+	per_thread
+};
+
+inline const char* sharing_name(ContainerSharing sharing)
+{
+	return sharing == ContainerSharing::shared ? "shared" : "per_thread";
+}
+
+/// <summary>
+///    : read/write   f(container)   .
+/// </summary>
+template<class Container, class Policy>
+class ConcurrentAccess
+{
+private:
+	Container& container_;
+	Policy& policy_;
+
+public:
+	ConcurrentAccess(Container& container, Policy& policy) : container_(container), policy_(policy) {}
+
+	template<class F>
+	decltype(auto) read(F&& f)
+	{
+		return policy_.read([&]() -> decltype(auto) { return f(container_); });
+	}
+	template<class F>
+	decltype(auto) write(F&& f)
+	{
+		return policy_.write([&]() -> decltype(auto) { return f(container_); });
+	}
+	/// <summary>
+	///   .
+	/// </summary>
+	Container& container()
+	{
+		return container_;
+	}
+};
+
+/// <summary>
+/// ,     ,   . ,   .
+/// </summary>
+inline std::vector<size_t> available_cpus()
+{
+	std::vector<size_t> cpus;
+#if defined(_WIN32)
+	DWORD_PTR process_mask = 0;
+	DWORD_PTR system_mask = 0;
+	if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+		for (size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+			if (process_mask & (DWORD_PTR(1) << cpu))
+				cpus.push_back(cpu);
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0)
+		for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+			if (CPU_ISSET(cpu, &set))
+				cpus.push_back(cpu);
+#endif
+	return cpus;
+}
+
+/// <summary>
+///     . false       .
+/// </summary>
+inline bool pin_current_thread(size_t cpu)
+{
+#if defined(_WIN32)
+	if (cpu >= sizeof(DWORD_PTR) * 8)
+		return false;
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+	if (cpu >= CPU_SETSIZE)
+		return false;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	(void)cpu;
+	return false;
+#endif
+}
+
+/// <summary>
+///   .
+/// </summary>
+struct ConcurrentOptions
+{
+	/// <summary>
+	///       .
+	/// </summary>
+	size_t ops_per_thread = 100'000;
+	/// <summary>
+	///    ;      .
+	/// </summary>
+	size_t repetitions = 3;
+	/// <summary>
+	///  i-   i-   ( ,   ).
+	/// </summary>
+	bool pin_threads = true;
+	/// <summary>
+	///           ; 0   .
+	/// </summary>
+	size_t latency_batch = 1;
+};
+
+/// <summary>
+///      .
+/// </summary>
+struct ConcurrentThreadStats
+{
+	/// <summary>
+	/// ,    ,  -1.
+	/// </summary>
+	long long cpu = -1;
+	size_t operations = 0;
+	double seconds = 0;
+	/// <summary>
+	///   .
+	/// </summary>
+	double throughput = 0;
+	LatencyStats latency;
+};
+
+/// <summary>
+///       .
+/// </summary>
+struct ConcurrentStats
+{
+	size_t threads = 0;
+	ContainerSharing sharing = ContainerSharing::shared;
+	/// <summary>
+	///      .
+	/// </summary>
+	bool pinned = false;
+	/// <summary>
+	///     ,    (  ).
+	/// </summary>
+	double throughput = 0;
+	/// <summary>
+	///         (1 / throughput),       
+	///     .
+	/// </summary>
+	BenchmarkStats per_op;
+	/// <summary>
+	///     .
+	/// </summary>
+	LatencyStats latency;
+	std::vector<ConcurrentThreadStats> per_thread;
+};
+
+/// <summary>
+///  : N       (   Policy)
+///    .  ,        ,
+///      ;           .
+/// </summary>
+/// <typeparam name="Container"> ;    .</typeparam>
+/// <typeparam name="Policy">  : NoLockPolicy, MutexPolicy, SharedMutexPolicy
+///     read(f)  write(f).      .</typeparam>
+template<class Container, class Policy = DefaultConcurrentPolicy<Container>>
+class ConcurrentBenchmark
+{
+private:
+	/// <summary>
+	///  ;    ,       .
+	/// </summary>
+	struct alignas(64) Slot
+	{
+		std::optional<Container> container;
+		LatencyHistogram histogram;
+		BenchmarkRunner::Clock::time_point start;
+		BenchmarkRunner::Clock::time_point end;
+		long long cpu = -1;
+	};
+
+	ConcurrentOptions options_;
+
+public:
+	explicit ConcurrentBenchmark(ConcurrentOptions options = {}) : options_(options) {}
+
+	const ConcurrentOptions& options() const
+	{
+		return options_;
+	}
+
+	/// <summary>
+	///     .
+	/// </summary>
+	/// <param name="setup">setup(Container&amp;)   ,  .   
+	///   -  .</param>
+	/// <param name="op">op(access, thread, i)  i-   thread; access  ConcurrentAccess,  
+	///    .    .</param>
+	template<class Setup, class Op>
+	ConcurrentStats run(size_t threads, ContainerSharing sharing, Setup&& setup, Op&& op) const
+	{
+		threads = std::max<size_t>(threads, 1);
+		size_t repetitions = std::max<size_t>(options_.repetitions, 1);
+		double overhead = options_.latency_batch ? BenchmarkRunner::timer_overhead() : 0;
+		std::vector<size_t> cpus = options_.pin_threads ? available_cpus() : std::vector<size_t>();
+
+		ConcurrentStats stats;
+		stats.threads = threads;
+		stats.sharing = sharing;
+		stats.pinned = options_.pin_threads;
+		stats.per_op.repetitions = repetitions;
+		stats.per_op.iterations = 1;
+		stats.per_op.operations = threads * options_.ops_per_thread;
+		stats.per_thread.resize(threads);
+		std::vector<LatencyHistogram> thread_histograms(threads);
+		std::vector<double> throughputs;
+
+		for (size_t r = 0; r < repetitions; ++r)
+		{
+			std::unique_ptr<Slot[]> slots(new Slot[threads]);
+			std::optional<Container> shared;
+			Policy policy;
+			if (sharing == ContainerSharing::shared)
+			{
+				shared.emplace();
+				setup(*shared);
+			}
+
+			std::atomic<size_t> ready{ 0 };
+			std::atomic<bool> go{ false };
+			std::vector<std::thread> workers;
+			workers.reserve(threads);
+			for (size_t t = 0; t < threads; ++t)
+				workers.emplace_back([&, t]
+					{
+						Slot& slot = slots[t];
+						if (!cpus.empty() && pin_current_thread(cpus[t % cpus.size()]))
+							slot.cpu = static_cast<long long>(cpus[t % cpus.size()]);
+						if (sharing == ContainerSharing::shared)
+						{
+							ConcurrentAccess<Container, Policy> access(*shared, policy);
+							work(slot, access, t, op, ready, go, overhead);
+						}
+						else
+						{
+							slot.container.emplace();
+							setup(*slot.container);
+							NoLockPolicy no_lock;
+							ConcurrentAccess<Container, NoLockPolicy> access(*slot.container, no_lock);
+							work(slot, access, t, op, ready, go, overhead);
+						}
+					});
+			while (ready.load(std::memory_order_acquire) < threads)
+				std::this_thread::yield();
+			go.store(true, std::memory_order_release);
+			for (auto& worker : workers)
+				worker.join();
+
+			auto first = slots[0].start;
+			auto last = slots[0].end;
+			for (size_t t = 0; t < threads; ++t)
+			{
+				Slot& slot = slots[t];
+				first = std::min(first, slot.start);
+				last = std::max(last, slot.end);
+				ConcurrentThreadStats& thread = stats.per_thread[t];
+				thread.cpu = slot.cpu;
+				thread.operations += options_.ops_per_thread;
+				thread.seconds += std::chrono::duration<double>(slot.end - slot.start).count();
+				thread_histograms[t].merge(slot.histogram);
+				stats.pinned = stats.pinned && slot.cpu >= 0;
+			}
+			double seconds = std::chrono::duration<double>(last - first).count();
+			double operations = static_cast<double>(stats.per_op.operations);
+			throughputs.push_back(seconds > 0 ? operations / seconds : 0);
+			stats.per_op.samples.push_back(seconds * 1e9 / operations);
+		}
+
+		std::vector<double> sorted = throughputs;
+		std::sort(sorted.begin(), sorted.end());
+		size_t n = sorted.size();
+		stats.throughput = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+		BenchmarkRunner::summarize(stats.per_op);
+
+		LatencyHistogram merged;
+		for (size_t t = 0; t < threads; ++t)
+		{
+			ConcurrentThreadStats& thread = stats.per_thread[t];
+			thread.throughput = thread.seconds > 0 ? thread.operations / thread.seconds : 0;
+			thread.latency = LatencyStats::from(thread_histograms[t], options_.latency_batch, overhead);
+			merged.merge(thread_histograms[t]);
+		}
+		stats.latency = LatencyStats::from(merged, options_.latency_batch, overhead);
+		return stats;
+	}
+
+	/// <summary>
+	///       thread_counts(max_threads).
+	/// </summary>
+	template<class Setup, class Op>
+	std::vector<ConcurrentStats> sweep(ContainerSharing sharing, Setup&& setup, Op&& op, size_t max_threads = 0) const
+	{
+		std::vector<ConcurrentStats> results;
+		for (size_t threads : thread_counts(max_threads))
+			results.push_back(run(threads, sharing, setup, op));
+		return results;
+	}
+
+	/// <summary>
+	///    1  max_threads (  hardware_concurrency):     .
+	/// </summary>
+	static std::vector<size_t> thread_counts(size_t max_threads = 0)
+	{
+		if (max_threads == 0)
+			max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+		std::vector<size_t> counts;
+		for (size_t threads = 1; threads < max_threads; threads *= 2)
+			counts.push_back(threads);
+		counts.push_back(max_threads);
+		return counts;
+	}
+
+private:
+	template<class Access, class Op>
+	void work(Slot& slot, Access& access, size_t thread, Op& op, std::atomic<size_t>& ready, std::atomic<bool>& go, double overhead) const
+	{
+		size_t ops = options_.ops_per_thread;
+		size_t batch = options_.latency_batch;
+		ready.fetch_add(1, std::memory_order_acq_rel);
+		while (!go.load(std::memory_order_acquire))
+			std::this_thread::yield();
+
+		slot.start = BenchmarkRunner::Clock::now();
+		if (batch == 0)
+		{
+			for (size_t i = 0; i < ops; ++i)
+				call(op, access, thread, i);
+		}
+		else
+		{
+			for (size_t i = 0; i < ops; i += batch)
+			{
+				size_t end = std::min(ops, i + batch);
+				auto start = BenchmarkRunner::Clock::now();
+				for (size_t j = i; j < end; ++j)
+					call(op, access, thread, j);
+				auto stop = BenchmarkRunner::Clock::now();
+				double ns = std::chrono::duration<double, std::nano>(stop - start).count() - overhead;
+				slot.histogram.record(static_cast<uint64_t>(std::max(ns, 0.0) / (end - i) + 0.5), end - i);
+			}
+		}
+		slot.end = BenchmarkRunner::Clock::now();
+	}
+
+	template<class Op, class Access>
+	static void call(Op& op, Access& access, size_t thread, size_t i)
+	{
+		if constexpr (std::is_void_v<decltype(op(access, thread, i))>)
+			op(access, thread, i);
+		else
+			do_not_optimize(op(access, thread, i));
+	}
+};
+
+/// <summary>
+///        ,    .
+/// </summary>
+inline void print_concurrent(const std::string& label, const ConcurrentStats& stats)
+{
+	char buffer[256];
+	std::snprintf(buffer, sizeof(buffer), "  %-30s %2zu threads %-10s %12.0f ops/s  (%s/op%s)\n", label.c_str(), stats.threads,
+		sharing_name(stats.sharing), stats.throughput, format_duration(stats.per_op.median).c_str(), stats.pinned ? ", pinned" : "");
+	std::cout << buffer;
+	if (stats.latency.count)
+		print_latency("", stats.latency);
+	if (stats.per_thread.size() < 2)
+		return;
+	for (size_t t = 0; t < stats.per_thread.size(); ++t)
+	{
+		const ConcurrentThreadStats& thread = stats.per_thread[t];
+		std::snprintf(buffer, sizeof(buffer), "    thread %-3zu cpu %-4lld %12.0f ops/s  p50 %10s  p99 %10s  max %10s\n", t, thread.cpu,
+			thread.throughput, format_duration(thread.latency.p50).c_str(), format_duration(thread.latency.p99).c_str(),
+			format_duration(thread.latency.max).c_str());
+		std::cout << buffer;
+	}
+}
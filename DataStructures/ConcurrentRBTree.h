@@ -0,0 +1,190 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "EpochReclaimer.h"
+#include "PersistentRBTree.h"
+
+/// <summary>
+///      " ,  ".
+///           :     
+/// PersistentRBTree,     .   ,   
+///   (O(log n) )      ;    
+/// EpochReclaimer,        .
+/// </summary>
+/// <typeparam name="T"> ;       operator&lt;.</typeparam>
+/// <remarks>
+///     (std::optional),        .
+///     snapshot():   O(1)   .
+/// </remarks>
+template <class T>
+class ConcurrentRBTree
+{
+private:
+    /// <summary>
+    ///  .   ,        .
+    /// </summary>
+    struct Version
+    {
+        PersistentRBTree<T> tree;
+    };
+
+    std::atomic<Version*> current_;
+    std::mutex write_mutex_;
+
+public:
+    /// <summary>
+    ///   :         .
+    /// </summary>
+    static constexpr bool thread_safe = true;
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    ConcurrentRBTree() : current_(new Version()) { }
+    /// <summary>
+    ///      .
+    /// </summary>
+    ConcurrentRBTree(std::initializer_list<T> init_list) : current_(new Version{ PersistentRBTree<T>(init_list) }) { }
+    /// <summary>
+    ///     .
+    /// </summary>
+    template<class It>
+    ConcurrentRBTree(It first, It last) : current_(new Version{ PersistentRBTree<T>(first, last) }) { }
+    /// <summary>
+    ///   .          .
+    /// </summary>
+    ~ConcurrentRBTree()
+    {
+        delete current_.load();
+    }
+
+    ConcurrentRBTree(const ConcurrentRBTree&) = delete;
+    ConcurrentRBTree& operator=(const ConcurrentRBTree&) = delete;
+
+    /// <summary>
+    ///      .
+    /// </summary>
+    size_t size() const
+    {
+        EpochReclaimer::Guard guard;
+        return current_.load(std::memory_order_acquire)->tree.size();
+    }
+    /// <summary>
+    /// ,   .
+    /// </summary>
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    /// <summary>
+    /// ,     .
+    /// </summary>
+    bool contains(const T& value) const
+    {
+        EpochReclaimer::Guard guard;
+        return current_.load(std::memory_order_acquire)->tree.contains(value);
+    }
+    /// <summary>
+    ///  ,  value.
+    /// </summary>
+    /// <returns>    std::nullopt.</returns>
+    std::optional<T> find(const T& value) const
+    {
+        return read([&](const PersistentRBTree<T>& tree) { return tree.find(value); });
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    /// <returns>   std::nullopt,   .</returns>
+    std::optional<T> lower_bound(const T& value) const
+    {
+        return read([&](const PersistentRBTree<T>& tree) { return tree.lower_bound(value); });
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    /// <returns>   std::nullopt,   .</returns>
+    std::optional<T> upper_bound(const T& value) const
+    {
+        return read([&](const PersistentRBTree<T>& tree) { return tree.upper_bound(value); });
+    }
+    /// <summary>
+    ///      O(1),    .
+    /// </summary>
+    PersistentRBTree<T> snapshot() const
+    {
+        EpochReclaimer::Guard guard;
+        return current_.load(std::memory_order_acquire)->tree.snapshot();
+    }
+
+    /// <summary>
+    ///      .
+    /// </summary>
+    /// <returns>true,       .</returns>
+    bool insert(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (current_.load(std::memory_order_relaxed)->tree.contains(value))
+            return false;
+        publish([&](PersistentRBTree<T>& tree) { tree.insert(value); });
+        return true;
+    }
+    /// <summary>
+    ///      .
+    /// </summary>
+    /// <returns>true,     .</returns>
+    bool erase(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (!current_.load(std::memory_order_relaxed)->tree.contains(value))
+            return false;
+        publish([&](PersistentRBTree<T>& tree) { tree.erase(value); });
+        return true;
+    }
+    /// <summary>
+    ///        :     ,   .
+    /// </summary>
+    /// <param name="action">,  PersistentRBTree&amp;    .</param>
+    template<class F>
+    void update(F&& action)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        publish(action);
+    }
+    /// <summary>
+    ///   .
+    /// </summary>
+    void clear()
+    {
+        update([](PersistentRBTree<T>& tree) { tree.clear(); });
+    }
+
+private:
+    template<class F>
+    std::optional<T> read(F&& search) const
+    {
+        EpochReclaimer::Guard guard;
+        const PersistentRBTree<T>& tree = current_.load(std::memory_order_acquire)->tree;
+        auto it = search(tree);
+        if (it == tree.end())
+            return std::nullopt;
+        return *it;
+    }
+    /// <summary>
+    ///      ( ,   O(1)),    action,
+    ///         .   write_mutex_.
+    /// </summary>
+    template<class F>
+    void publish(F&& action)
+    {
+        Version* previous = current_.load(std::memory_order_relaxed);
+        Version* next = new Version{ previous->tree };
+        action(next->tree);
+        current_.store(next, std::memory_order_release);
+        EpochReclaimer::instance().retire(previous);
+    }
+};
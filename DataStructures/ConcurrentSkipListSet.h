@@ -0,0 +1,533 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+#include "EpochReclaimer.h"
+
+//      :      .
+// point      ("link_upper_level", "erase_finish").
+#if !defined(DS_SKIP_LIST_TEST_HOOK)
+#define DS_SKIP_LIST_TEST_HOOK(point)
+#endif
+
+/// <summary>
+///          (Herlihy, Shavit, "The Art of Multiprocessor
+/// Programming", LockFreeSkipList). insert  erase  CAS-  ;   
+///  (     ),     ,    .
+///      EpochReclaimer.
+/// </summary>
+/// <typeparam name="T"> ;       operator&lt;.</typeparam>
+/// <remarks>
+///   :    ,        ,  
+///     ,      .    
+/// EpochReclaimer      ,  .
+/// </remarks>
+template <class T>
+class ConcurrentSkipListSet
+{
+private:
+    /// <summary>
+    ///   ;   1/2    2^32 .
+    /// </summary>
+    static constexpr int max_level = 32;
+    /// <summary>
+    ///     :   ,      
+    ///    ,          .
+    /// </summary>
+    static constexpr uint8_t linked_flag = 1;
+    static constexpr uint8_t erased_flag = 2;
+
+    /// <summary>
+    ///   :  next      top_level .
+    ///   next[i]     .
+    /// </summary>
+    struct Node
+    {
+        int top_level;
+        std::atomic<uint8_t> state;
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uintptr_t> next[1];
+
+        const T& value() const
+        {
+            return *std::launder(reinterpret_cast<const T*>(storage));
+        }
+    };
+
+    Node* head_;
+    std::atomic<int> height_{ 1 };
+    std::atomic<size_t> size_{ 0 };
+
+public:
+    /// <summary>
+    ///   :         .
+    /// </summary>
+    static constexpr bool thread_safe = true;
+
+    /// <summary>
+    ///      .     .
+    /// </summary>
+    class const_iterator
+    {
+        friend class ConcurrentSkipListSet<T>;
+    private:
+        const Node* node_ = nullptr;
+        std::shared_ptr<EpochReclaimer::Guard> guard_;
+
+        const_iterator(const Node* node, std::shared_ptr<EpochReclaimer::Guard> guard) : node_(node), guard_(std::move(guard))
+        {
+            skip_marked();
+        }
+        void skip_marked()
+        {
+            while (node_ && is_marked(node_->next[0].load(std::memory_order_acquire)))
+                node_ = to_node(node_->next[0].load(std::memory_order_acquire));
+        }
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        const T& operator*() const
+        {
+            return node_->value();
+        }
+        const T* operator->() const
+        {
+            return &node_->value();
+        }
+        const_iterator& operator++()
+        {
+            node_ = to_node(node_->next[0].load(std::memory_order_acquire));
+            skip_marked();
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            return node_ == other.node_;
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return node_ != other.node_;
+        }
+    };
+    using iterator = const_iterator;
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    ConcurrentSkipListSet() : head_(allocate_node(max_level, nullptr)) { }
+    /// <summary>
+    ///      .
+    /// </summary>
+    ConcurrentSkipListSet(std::initializer_list<T> init_list) : ConcurrentSkipListSet(init_list.begin(), init_list.end()) { }
+    /// <summary>
+    ///     .
+    /// </summary>
+    template<class It>
+    ConcurrentSkipListSet(It first, It last) : ConcurrentSkipListSet()
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+    /// <summary>
+    ///   .          .
+    /// </summary>
+    ~ConcurrentSkipListSet()
+    {
+        Node* node = to_node(head_->next[0].load());
+        while (node)
+        {
+            Node* next = to_node(node->next[0].load());
+            destroy_node(node);
+            node = next;
+        }
+        ::operator delete(head_);
+    }
+
+    ConcurrentSkipListSet(const ConcurrentSkipListSet&) = delete;
+    ConcurrentSkipListSet& operator=(const ConcurrentSkipListSet&) = delete;
+
+    /// <summary>
+    ///  .     .
+    /// </summary>
+    size_t size() const
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+    /// <summary>
+    /// ,   .
+    /// </summary>
+    bool empty() const
+    {
+        return begin() == end();
+    }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    /// <returns>true,       .</returns>
+    bool insert(const T& value)
+    {
+        EpochReclaimer::Guard guard;
+        int level = random_level();
+        raise_height(level);
+
+        Node* preds[max_level];
+        Node* succs[max_level];
+        Node* node = nullptr;
+        while (true)
+        {
+            if (find(value, preds, succs))
+            {
+                if (node)
+                    destroy_node(node);
+                return false;
+            }
+            if (!node)
+                node = allocate_node(level, &value);
+            for (int i = 0; i < level; ++i)
+                node->next[i].store(reinterpret_cast<uintptr_t>(succs[i]), std::memory_order_relaxed);
+
+            uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+            if (preds[0]->next[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_release, std::memory_order_relaxed))
+                break;
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+
+        link_upper_levels(node, value, preds, succs);
+        finish(node, linked_flag);
+        return true;
+    }
+    /// <summary>
+    ///    .
+    /// </summary>
+    /// <returns>true,     .</returns>
+    bool erase(const T& value)
+    {
+        EpochReclaimer::Guard guard;
+        Node* preds[max_level];
+        Node* succs[max_level];
+        if (!find(value, preds, succs))
+            return false;
+
+        Node* node = succs[0];
+        for (int i = node->top_level - 1; i >= 1; --i)
+        {
+            uintptr_t next = node->next[i].load(std::memory_order_acquire);
+            while (!is_marked(next) &&
+                !node->next[i].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+            }
+        }
+
+        uintptr_t next = node->next[0].load(std::memory_order_acquire);
+        while (true)
+        {
+            if (is_marked(next))
+                return false;
+            if (node->next[0].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                break;
+        }
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        find(value, preds, succs);
+        DS_SKIP_LIST_TEST_HOOK("erase_finish");
+        finish(node, erased_flag);
+        return true;
+    }
+
+    /// <summary>
+    /// ,     .   .
+    /// </summary>
+    bool contains(const T& value) const
+    {
+        EpochReclaimer::Guard guard;
+        const Node* node = search(value, false);
+        return node && !(value < node->value());
+    }
+    /// <summary>
+    ///  ,  value.
+    /// </summary>
+    /// <returns>    std::nullopt.</returns>
+    std::optional<T> find(const T& value) const
+    {
+        EpochReclaimer::Guard guard;
+        const Node* node = search(value, false);
+        if (node && !(value < node->value()))
+            return node->value();
+        return std::nullopt;
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    /// <returns>   std::nullopt,   .</returns>
+    std::optional<T> lower_bound(const T& value) const
+    {
+        EpochReclaimer::Guard guard;
+        const Node* node = search(value, false);
+        return node ? std::optional<T>(node->value()) : std::nullopt;
+    }
+    /// <summary>
+    ///  ,   value.
+    /// </summary>
+    /// <returns>   std::nullopt,   .</returns>
+    std::optional<T> upper_bound(const T& value) const
+    {
+        EpochReclaimer::Guard guard;
+        const Node* node = search(value, true);
+        return node ? std::optional<T>(node->value()) : std::nullopt;
+    }
+    /// <summary>
+    ///  (lower_bound(value), upper_bound(value));        .
+    /// </summary>
+    std::pair<std::optional<T>, std::optional<T>> equal_range(const T& value) const
+    {
+        EpochReclaimer::Guard guard;
+        return { lower_bound(value), upper_bound(value) };
+    }
+
+    const_iterator begin() const
+    {
+        auto guard = std::make_shared<EpochReclaimer::Guard>();
+        return const_iterator(to_node(head_->next[0].load(std::memory_order_acquire)), std::move(guard));
+    }
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    /// <summary>
+    ///    ,   value.
+    /// </summary>
+    const_iterator lower_bound_iterator(const T& value) const
+    {
+        auto guard = std::make_shared<EpochReclaimer::Guard>();
+        return const_iterator(search(value, false), std::move(guard));
+    }
+
+    /// <summary>
+    ///   ,   .      .
+    /// </summary>
+    void clear()
+    {
+        for (auto it = begin(); it != end(); ++it)
+            erase(*it);
+    }
+
+    /// <summary>
+    ///      (     ):     
+    ///    ,   i    i - 1     i,   
+    ///   size().
+    /// </summary>
+    /// <returns>true,   .</returns>
+    bool validate() const
+    {
+        EpochReclaimer::Guard guard;
+        size_t counted = 0;
+        for (int level = 0; level < max_level; ++level)
+        {
+            const Node* lower = level > 0 ? to_node(head_->next[level - 1].load(std::memory_order_acquire)) : nullptr;
+            const Node* previous = nullptr;
+            for (const Node* node = to_node(head_->next[level].load(std::memory_order_acquire)); node;
+                node = to_node(node->next[level].load(std::memory_order_acquire)))
+            {
+                if (node->top_level <= level || is_marked(node->next[level].load(std::memory_order_acquire)))
+                    return false;
+                if (previous && !(previous->value() < node->value()))
+                    return false;
+                if (level > 0)
+                {
+                    while (lower && lower != node)
+                        lower = to_node(lower->next[level - 1].load(std::memory_order_acquire));
+                    if (!lower)
+                        return false;
+                }
+                else
+                    ++counted;
+                previous = node;
+            }
+        }
+        return counted == size();
+    }
+
+private:
+    static bool is_marked(uintptr_t link)
+    {
+        return (link & 1) != 0;
+    }
+    static Node* to_node(uintptr_t link)
+    {
+        return reinterpret_cast<Node*>(link & ~uintptr_t(1));
+    }
+
+    /// <summary>
+    ///    level.    value == nullptr,    .
+    /// </summary>
+    static Node* allocate_node(int level, const T* value)
+    {
+        size_t bytes = sizeof(Node) + (level - 1) * sizeof(std::atomic<uintptr_t>);
+        void* memory = ::operator new(bytes);
+        Node* node = static_cast<Node*>(memory);
+        node->top_level = level;
+        new (&node->state) std::atomic<uint8_t>(0);
+        for (int i = 0; i < level; ++i)
+            new (&node->next[i]) std::atomic<uintptr_t>(0);
+        if (value)
+            new (node->storage) T(*value);
+        return node;
+    }
+    static void destroy_node(Node* node)
+    {
+        node->value().~T();
+        ::operator delete(node);
+    }
+    /// <summary>
+    ///   1..top_level-1   . ,       .
+    /// </summary>
+    void link_upper_levels(Node* node, const T& value, Node** preds, Node** succs)
+    {
+        for (int i = 1; i < node->top_level; ++i)
+        {
+            while (true)
+            {
+                uintptr_t current = node->next[i].load(std::memory_order_acquire);
+                if (is_marked(current))
+                    return;
+                if (current != reinterpret_cast<uintptr_t>(succs[i]) &&
+                    !node->next[i].compare_exchange_strong(current, reinterpret_cast<uintptr_t>(succs[i]), std::memory_order_release, std::memory_order_relaxed))
+                    return;
+
+                DS_SKIP_LIST_TEST_HOOK("link_upper_level");
+                uintptr_t expected = reinterpret_cast<uintptr_t>(succs[i]);
+                if (preds[i]->next[i].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_release, std::memory_order_relaxed))
+                    break;
+                find(value, preds, succs);
+                if (succs[0] != node)
+                    return;
+            }
+        }
+    }
+    /// <summary>
+    /// ,         ;       
+    ///       .
+    /// </summary>
+    /// <remarks>
+    ///    ,     :     
+    ///   ,  erase  .
+    /// </remarks>
+    void finish(Node* node, uint8_t flag)
+    {
+        uint8_t previous = node->state.fetch_or(flag, std::memory_order_acq_rel);
+        if ((previous | flag) != (linked_flag | erased_flag))
+            return;
+        Node* preds[max_level];
+        Node* succs[max_level];
+        find(node->value(), preds, succs);
+        EpochReclaimer::instance().retire(node, [](void* p) { destroy_node(static_cast<Node*>(p)); });
+    }
+    /// <summary>
+    ///  :      1/2.
+    /// </summary>
+    static int random_level()
+    {
+        thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int level = 1 + std::countr_one(state);
+        return level < max_level ? level : max_level;
+    }
+    void raise_height(int level)
+    {
+        int height = height_.load(std::memory_order_relaxed);
+        while (height < level && !height_.compare_exchange_weak(height, level, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// <summary>
+    ///        value (preds)     (succs),   
+    ///   .  true,  succs[0]  value.
+    /// </summary>
+    bool find(const T& value, Node** preds, Node** succs)
+    {
+        int height = height_.load(std::memory_order_acquire);
+    retry:
+        Node* pred = head_;
+        for (int level = max_level - 1; level >= height; --level)
+        {
+            preds[level] = head_;
+            succs[level] = nullptr;
+        }
+        for (int level = height - 1; level >= 0; --level)
+        {
+            Node* curr = to_node(pred->next[level].load(std::memory_order_acquire));
+            while (curr)
+            {
+                uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+                while (is_marked(succ))
+                {
+                    uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                    if (!pred->next[level].compare_exchange_strong(expected, succ & ~uintptr_t(1), std::memory_order_acq_rel, std::memory_order_relaxed))
+                        goto retry;
+                    curr = to_node(succ);
+                    if (!curr)
+                        break;
+                    succ = curr->next[level].load(std::memory_order_acquire);
+                }
+                if (!curr || !(curr->value() < value))
+                    break;
+                pred = curr;
+                curr = to_node(succ);
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return succs[0] && !(value < succs[0]->value());
+    }
+    /// <summary>
+    ///    :        value (  value,
+    ///  strict == true).
+    /// </summary>
+    const Node* search(const T& value, bool strict) const
+    {
+        const Node* pred = head_;
+        const Node* curr = nullptr;
+        for (int level = height_.load(std::memory_order_acquire) - 1; level >= 0; --level)
+        {
+            curr = to_node(pred->next[level].load(std::memory_order_acquire));
+            while (curr)
+            {
+                uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+                if (is_marked(succ))
+                {
+                    curr = to_node(succ);
+                    continue;
+                }
+                if (strict ? (value < curr->value()) : !(curr->value() < value))
+                    break;
+                pred = curr;
+                curr = to_node(succ);
+            }
+        }
+        return curr;
+    }
+};
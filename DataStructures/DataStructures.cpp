@@ -1,35 +1,95 @@
 ﻿// DataStructures.cpp : Этот файл содержит функцию "main". Здесь начинается и заканчивается выполнение программы.
 //
 
+// Перехватчики operator new/delete для учёта памяти определяются здесь, только если сборка задаёт
+// DS_DEFINE_ALLOCATION_HOOKS (цель ds_bench_memory, Debug в Visual Studio): они добавляют заголовок к каждому блоку
+// и меняют раскладку malloc, поэтому замеры времени идут без них.
+#include "AllocationTracker.h"
 #include <iostream>
 #include "List.h"
 #include "RBTree.h"
+#include "BTreeSet.h"
+#include "ConcurrentRBTree.h"
+#include "ConcurrentSkipListSet.h"
 #include "BenchmarkDSAndSTL.h"
+#include "BenchmarkCommandLine.h"
+#include "BenchmarkReport.h"
 #include "HeshTables.h"
+#include "ExternalSort.h"
 #include <unordered_map>
 #include <list>
+#include <map>
+#include <memory>
 #include <set>
 #include <chrono>
+#include <filesystem>
+#include <string>
 using namespace std;
 
-int main()
-{
-	/*ListBenchmark<List<int>, std::list<int>> ListBench(1'000'000);
-	ListBench.run_all();*/
+// Наборы бенчмарков: каждый контейнер из списка получает все сценарии набора. Выбор — параметрами командной строки
+// (--list, --suite, --scenario, --container, --n, --sweep, --isolate; см. BenchmarkCommandLine::usage()).
+static const size_t list_benchmarks = register_benchmark_suite<ListBenchmark, List<int>, std::list<int>>("list");
+
+static const size_t tree_benchmarks = register_benchmark_suite<RBTreeBenchmark,
+	RBTree<int>, std::set<int>, BTreeSet<int, 256>, SimdBTreeSet<int, 256>>("tree");
+
+static const size_t map_benchmarks = register_benchmark_suite<MapBenchmark,
+	HashMapChaining<int, int>, std::unordered_map<int, int>, std::map<int, int>>("map");
+
+static const size_t frozen_benchmarks = BenchmarkRegistry::instance().add_suite("frozen", [](size_t n, const BenchmarkOptions& options)
+	{
+		auto benchmark = make_shared<FrozenLayoutBenchmark<RBTree<int>, NodeRBT<int>>>(n, options);
+		return owned_benchmark_cases(benchmark, benchmark->cases());
+	});
 
-	MapBenchmark<HashMapChaining<int, int>, std::unordered_map<int, int>> RBTBench(1'000'000);
-	RBTBench.run_all();
+// Режимы --mode: сравнения пар контейнеров вне сценариев наборов. Пары выбираются --suite и --container, например
+// --mode concurrent --container ConcurrentSkipListSet --threads 64 или --mode external-sort --bytes 1G,10G,100G.
+static const size_t concurrent_modes =
+	register_benchmark_mode<ListBenchmark, List<int>, std::list<int>>("concurrent", "list",
+		[](auto& benchmark, const BenchmarkModeArgs& args) { benchmark.run_concurrent_sweep(args.threads); })
+	+ register_benchmark_mode<RBTreeBenchmark, ConcurrentRBTree<int>, std::set<int>>("concurrent", "tree",
+		[](auto& benchmark, const BenchmarkModeArgs& args) { benchmark.run_concurrent_sweep(args.threads); })
+	+ register_benchmark_mode<RBTreeBenchmark, ConcurrentSkipListSet<int>, RBTree<int>>("concurrent", "tree",
+		[](auto& benchmark, const BenchmarkModeArgs& args) { benchmark.run_concurrent_sweep(args.threads); })
+	+ register_benchmark_mode<MapBenchmark, HashMapChaining<int, int>, std::unordered_map<int, int>>("concurrent", "map",
+		[](auto& benchmark, const BenchmarkModeArgs& args) { benchmark.run_concurrent_sweep(args.threads); });
 
-	unordered_map<int, int> mymap;
-	/*List<int> mylist{ 5,4,3,2,1 };
-	cout << "Before sort:\n";
-	for (auto v : mylist)
-		cout << v << " ";
-	cout << "\nAfter sort:\n";
-	mylist.sort();
+static const size_t latency_modes =
+	register_benchmark_mode<RBTreeBenchmark, RBTree<int>, std::set<int>>("latency", "tree",
+		[](auto& benchmark, const BenchmarkModeArgs&) { benchmark.run_latency(); })
+	+ register_benchmark_mode<MapBenchmark, HashMapChaining<int, int>, std::unordered_map<int, int>>("latency", "map",
+		[](auto& benchmark, const BenchmarkModeArgs&) { benchmark.run_latency(); });
 
-	for(auto v : mylist)
-		cout << v << " ";*/
+static const size_t workload_modes =
+	register_benchmark_mode<RBTreeBenchmark, RBTree<int>, std::set<int>>("ycsb", "tree",
+		[](auto& benchmark, const BenchmarkModeArgs&) { benchmark.run_ycsb(); })
+	+ register_benchmark_mode<MapBenchmark, HashMapChaining<std::string, int>, std::unordered_map<std::string, int>>("ycsb", "map",
+		[](auto& benchmark, const BenchmarkModeArgs&) { benchmark.run_ycsb(); })
+	+ register_benchmark_mode<RBTreeBenchmark, RBTree<int>, std::set<int>>("trace", "tree",
+		[](auto& benchmark, const BenchmarkModeArgs& args) { benchmark.run_trace(args.trace); })
+	+ register_benchmark_mode<MapBenchmark, HashMapChaining<std::string, int>, std::unordered_map<std::string, int>>("trace", "map",
+		[](auto& benchmark, const BenchmarkModeArgs& args) { benchmark.run_trace(args.trace); });
 
-	return 0;
+static const size_t warm_start_modes =
+	register_benchmark_mode<MapBenchmark, HashMapChaining<int, int>, std::unordered_map<int, int>>("warm-start", "map",
+		[](auto& benchmark, const BenchmarkModeArgs&)
+		{
+			string path = (filesystem::temp_directory_path() / "ds_hash_warm_start.bin").string();
+			benchmark.run_warm_start(path);
+			filesystem::remove(path);
+		});
+
+// Размер входа задаёт --bytes, а не --n; бюджет памяти — --budget, каталог серий — --temp-dir.
+static const size_t external_sort_modes = BenchmarkRegistry::instance().add_mode({ "external-sort", "external_sort",
+	benchmark_type_name<ExternalSorter<uint64_t>>(), false, [](const BenchmarkModeArgs& args, BenchmarkReporter& reporter)
+	{
+		string directory = args.temp_directory.empty() ? filesystem::temp_directory_path().string() : args.temp_directory;
+		ExternalSortBenchmark<ExternalSorter<uint64_t>> benchmark(args.budget, directory);
+		benchmark.set_reporter(reporter);
+		benchmark.run_all(args.bytes);
+	} });
+
+int main(int argc, char* argv[])
+{
+	return run_benchmark_command_line(argc, argv);
 }
@@ -0,0 +1,221 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+///     (epoch-based reclamation)      .
+///       Guard    ; ,   ,
+///   retire()    ,        ,
+///     ,    ,      .
+/// </summary>
+/// <remarks>
+///    .        (Record)     ;
+///         .
+/// </remarks>
+class EpochReclaimer
+{
+private:
+    /// <summary>
+    /// ,  ,  ,       .
+    /// </summary>
+    struct Retired
+    {
+        void* pointer;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+    /// <summary>
+    ///   . active  0   ,    .
+    /// </summary>
+    struct alignas(64) Record
+    {
+        std::atomic<uint64_t> active{ 0 };
+        std::atomic<bool> in_use{ true };
+        Record* next = nullptr;
+        size_t depth = 0;
+        std::vector<Retired> retired;
+    };
+    /// <summary>
+    ///    :       .
+    /// </summary>
+    struct Holder
+    {
+        Record* record = nullptr;
+
+        ~Holder()
+        {
+            if (record)
+                record->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    /// <summary>
+    ///    ,        .
+    /// </summary>
+    static constexpr size_t collect_threshold = 64;
+
+    std::atomic<uint64_t> epoch_{ 1 };
+    std::atomic<Record*> records_{ nullptr };
+
+    EpochReclaimer() = default;
+
+public:
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    /// <summary>
+    ///       .
+    /// </summary>
+    ~EpochReclaimer()
+    {
+        Record* record = records_.load();
+        while (record)
+        {
+            for (const Retired& item : record->retired)
+                item.deleter(item.pointer);
+            Record* next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    /// <summary>
+    ///  .
+    /// </summary>
+    static EpochReclaimer& instance()
+    {
+        static EpochReclaimer reclaimer;
+        return reclaimer;
+    }
+
+    /// <summary>
+    ///   :  Guard , ,    ,   .
+    /// Guard     .
+    /// </summary>
+    class Guard
+    {
+    private:
+        Record* record_;
+    public:
+        Guard() : record_(instance().local())
+        {
+            if (record_->depth++ == 0)
+            {
+                record_->active.store(instance().epoch_.load(std::memory_order_seq_cst), std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+        ~Guard()
+        {
+            if (--record_->depth == 0)
+                record_->active.store(0, std::memory_order_release);
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    /// <summary>
+    ///  ,     ,     delete.
+    /// </summary>
+    template<class U>
+    void retire(U* pointer)
+    {
+        retire(pointer, [](void* p) { delete static_cast<U*>(p); });
+    }
+    /// <summary>
+    ///       .
+    /// </summary>
+    void retire(void* pointer, void (*deleter)(void*))
+    {
+        Record* record = local();
+        record->retired.push_back({ pointer, deleter, epoch_.load(std::memory_order_seq_cst) });
+        if (record->retired.size() >= collect_threshold)
+            collect();
+    }
+    /// <summary>
+    ///        ,      .
+    /// </summary>
+    void collect()
+    {
+        try_advance();
+        free_safe(local());
+    }
+    /// <summary>
+    ///     ,        .
+    ///      ,      .
+    /// </summary>
+    void synchronize()
+    {
+        for (int i = 0; i < 3; ++i)
+            try_advance();
+        free_safe(local());
+    }
+    /// <summary>
+    ///    ,  .
+    /// </summary>
+    size_t pending()
+    {
+        return local()->retired.size();
+    }
+
+private:
+    /// <summary>
+    ///   ;         .
+    /// </summary>
+    Record* local()
+    {
+        thread_local Holder holder;
+        if (holder.record)
+            return holder.record;
+
+        for (Record* record = records_.load(std::memory_order_acquire); record; record = record->next)
+        {
+            bool expected = false;
+            if (!record->in_use.load(std::memory_order_relaxed) &&
+                record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                holder.record = record;
+                return record;
+            }
+        }
+
+        Record* record = new Record();
+        Record* head = records_.load(std::memory_order_relaxed);
+        do
+        {
+            record->next = head;
+        } while (!records_.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+        holder.record = record;
+        return record;
+    }
+    /// <summary>
+    ///   ,         .
+    /// </summary>
+    void try_advance()
+    {
+        uint64_t current = epoch_.load(std::memory_order_seq_cst);
+        for (Record* record = records_.load(std::memory_order_acquire); record; record = record->next)
+        {
+            uint64_t active = record->active.load(std::memory_order_seq_cst);
+            if (active != 0 && active != current)
+                return;
+        }
+        epoch_.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+    }
+    void free_safe(Record* record)
+    {
+        uint64_t current = epoch_.load(std::memory_order_seq_cst);
+        size_t kept = 0;
+        for (size_t i = 0; i < record->retired.size(); ++i)
+        {
+            Retired item = record->retired[i];
+            if (item.epoch + 2 <= current)
+                item.deleter(item.pointer);
+            else
+                record->retired[kept++] = item;
+        }
+        record->retired.resize(kept);
+    }
+};
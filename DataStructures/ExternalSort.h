@@ -0,0 +1,376 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "List.h"
+
+/// <summary>
+///     ,     .
+///        ;      
+///   ().         k-   
+/// ,      .
+/// </summary>
+/// <typeparam name="T">   :     .</typeparam>
+/// <typeparam name="Compare">  ;   std::less&lt;T&gt;.</typeparam>
+/// <remarks>
+/// : push()   ,    begin()/end(), to_list()  copy_to().
+///   .     .
+/// </remarks>
+template<class T, class Compare = std::less<T>>
+class ExternalSorter
+{
+	static_assert(std::is_trivially_copyable_v<T>, "ExternalSorter requires a trivially copyable element type");
+
+private:
+	/// <summary>
+	///        .
+	/// </summary>
+	struct Run
+	{
+		std::filesystem::path path;
+		uint64_t count = 0;
+		std::ifstream in;
+		std::vector<T> window;
+		size_t pos = 0;
+		uint64_t unread = 0;
+
+		bool exhausted() const
+		{
+			return pos == window.size();
+		}
+		const T& head() const
+		{
+			return window[pos];
+		}
+		/// <summary>
+		///       read.
+		/// </summary>
+		void refill(size_t window_elements)
+		{
+			size_t next = static_cast<size_t>(std::min<uint64_t>(unread, window_elements));
+			window.resize(next);
+			pos = 0;
+			if (next == 0)
+				return;
+			if (!in.read(reinterpret_cast<char*>(window.data()), static_cast<std::streamsize>(next * sizeof(T))))
+				throw std::runtime_error("ExternalSorter: cannot read run " + path.string());
+			unread -= next;
+		}
+	};
+
+	/// <summary>
+	///     :          ,
+	///    .
+	/// </summary>
+	static constexpr size_t min_window_bytes = 1 << 16;
+
+	size_t budget_elements_;
+	std::filesystem::path directory_;
+	std::string prefix_;
+	Compare comp_;
+
+	std::vector<T> buffer_;
+	std::vector<Run> runs_;
+	uint64_t size_ = 0;
+
+	bool merging_ = false;
+	size_t memory_pos_ = 0;
+	size_t window_elements_ = 0;
+	/// <summary>
+	///  : losers_[0]       ,
+	/// losers_[1..k-1]      .
+	/// </summary>
+	std::vector<size_t> losers_;
+
+public:
+	/// <summary>
+	///     .
+	/// </summary>
+	class const_iterator
+	{
+		friend class ExternalSorter;
+	private:
+		ExternalSorter* sorter_ = nullptr;
+
+		explicit const_iterator(ExternalSorter* sorter) : sorter_(sorter && !sorter->done() ? sorter : nullptr) {}
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		const_iterator() = default;
+
+		const T& operator*() const
+		{
+			return sorter_->current();
+		}
+		const T* operator->() const
+		{
+			return &sorter_->current();
+		}
+		const_iterator& operator++()
+		{
+			sorter_->advance();
+			if (sorter_->done())
+				sorter_ = nullptr;
+			return *this;
+		}
+		void operator++(int)
+		{
+			++(*this);
+		}
+		bool operator==(const const_iterator& other) const
+		{
+			return sorter_ == other.sorter_;
+		}
+		bool operator!=(const const_iterator& other) const
+		{
+			return sorter_ != other.sorter_;
+		}
+	};
+
+	/// <summary>
+	///  .
+	/// </summary>
+	/// <param name="memory_budget_bytes">         .</param>
+	/// <param name="directory">    .</param>
+	/// <param name="comp"> .</param>
+	explicit ExternalSorter(size_t memory_budget_bytes = size_t(256) << 20,
+		const std::filesystem::path& directory = std::filesystem::temp_directory_path(), const Compare& comp = Compare{})
+		: budget_elements_(std::max<size_t>(memory_budget_bytes / sizeof(T), 1)), directory_(directory), comp_(comp)
+	{
+		std::random_device device;
+		prefix_ = "ds_extsort_" + std::to_string(device()) + "_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_";
+	}
+	~ExternalSorter()
+	{
+		for (Run& run : runs_)
+		{
+			run.in.close();
+			std::error_code ignored;
+			std::filesystem::remove(run.path, ignored);
+		}
+	}
+
+	ExternalSorter(const ExternalSorter&) = delete;
+	ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+	/// <summary>
+	///  .     ,      .
+	/// </summary>
+	/// <exception cref="std::logic_error">   .</exception>
+	void push(const T& value)
+	{
+		if (merging_)
+			throw std::logic_error("ExternalSorter::push: merge already started");
+		if (buffer_.capacity() == 0)
+			buffer_.reserve(budget_elements_);
+
+		buffer_.push_back(value);
+		++size_;
+		if (buffer_.size() >= budget_elements_)
+			spill();
+	}
+	/// <summary>
+	///    .
+	/// </summary>
+	template<class It>
+	void push(It first, It last)
+	{
+		for (; first != last; ++first)
+			push(*first);
+	}
+
+	/// <summary>
+	///    .
+	/// </summary>
+	uint64_t size() const
+	{
+		return size_;
+	}
+	/// <summary>
+	///  ,   .  ,          .
+	/// </summary>
+	size_t run_count() const
+	{
+		return runs_.size();
+	}
+
+	/// <summary>
+	///        .      .
+	/// </summary>
+	const_iterator begin()
+	{
+		if (!merging_)
+			start_merge();
+		return const_iterator(this);
+	}
+	const_iterator end()
+	{
+		return const_iterator();
+	}
+
+	/// <summary>
+	///      .
+	/// </summary>
+	template<class OutIt>
+	OutIt copy_to(OutIt out)
+	{
+		for (auto it = begin(); it != end(); ++it)
+			*out++ = *it;
+		return out;
+	}
+	/// <summary>
+	///     List.
+	/// </summary>
+	List<T> to_list()
+	{
+		List<T> result;
+		for (auto it = begin(); it != end(); ++it)
+			result.push_back(*it);
+		return result;
+	}
+
+private:
+	/// <summary>
+	///            write.
+	/// </summary>
+	void spill()
+	{
+		std::sort(buffer_.begin(), buffer_.end(), comp_);
+
+		Run run;
+		run.path = directory_ / (prefix_ + std::to_string(runs_.size()) + ".run");
+		run.count = buffer_.size();
+		bool written;
+		{
+			std::ofstream out(run.path, std::ios::binary | std::ios::trunc);
+			written = out.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size() * sizeof(T))) &&
+				out.flush();
+		}
+		if (!written)
+		{
+			//     runs_,     :    .
+			std::error_code ignored;
+			std::filesystem::remove(run.path, ignored);
+			throw std::runtime_error("ExternalSorter: cannot write run " + run.path.string());
+		}
+		runs_.push_back(std::move(run));
+		buffer_.clear();
+	}
+	/// <summary>
+	///   :      ,   ,  
+	///       .
+	/// </summary>
+	void start_merge()
+	{
+		merging_ = true;
+		if (runs_.empty())
+		{
+			std::sort(buffer_.begin(), buffer_.end(), comp_);
+			return;
+		}
+
+		if (!buffer_.empty())
+			spill();
+		std::vector<T>().swap(buffer_);
+
+		window_elements_ = std::max(budget_elements_ / runs_.size(), std::max<size_t>(min_window_bytes / sizeof(T), 1));
+		for (Run& run : runs_)
+		{
+			run.in.open(run.path, std::ios::binary);
+			if (!run.in)
+				throw std::runtime_error("ExternalSorter: cannot open run " + run.path.string());
+			run.unread = run.count;
+			run.refill(window_elements_);
+		}
+		build_losers();
+	}
+
+	bool done() const
+	{
+		if (runs_.empty())
+			return memory_pos_ == buffer_.size();
+		return runs_[losers_[0]].exhausted();
+	}
+	const T& current() const
+	{
+		if (runs_.empty())
+			return buffer_[memory_pos_];
+		return runs_[losers_[0]].head();
+	}
+	void advance()
+	{
+		if (runs_.empty())
+		{
+			++memory_pos_;
+			return;
+		}
+
+		size_t winner = losers_[0];
+		Run& run = runs_[winner];
+		if (++run.pos == run.window.size())
+			run.refill(window_elements_);
+		replay(winner);
+	}
+
+	/// <summary>
+	///  a    b.     ,  
+	///    .
+	/// </summary>
+	bool before(size_t a, size_t b) const
+	{
+		if (runs_[a].exhausted())
+			return false;
+		if (runs_[b].exhausted())
+			return true;
+		if (comp_(runs_[a].head(), runs_[b].head()))
+			return true;
+		if (comp_(runs_[b].head(), runs_[a].head()))
+			return false;
+		return a < b;
+	}
+	/// <summary>
+	///     :  k..2k-1  .
+	/// </summary>
+	void build_losers()
+	{
+		size_t k = runs_.size();
+		losers_.assign(k, 0);
+		std::vector<size_t> winners(2 * k);
+		for (size_t i = 0; i < k; ++i)
+			winners[k + i] = i;
+		for (size_t node = k - 1; node >= 1; --node)
+		{
+			size_t a = winners[2 * node];
+			size_t b = winners[2 * node + 1];
+			bool a_wins = before(a, b);
+			winners[node] = a_wins ? a : b;
+			losers_[node] = a_wins ? b : a;
+		}
+		losers_[0] = k == 1 ? 0 : winners[1];
+	}
+	/// <summary>
+	///        run  : log2(k)   .
+	/// </summary>
+	void replay(size_t run)
+	{
+		size_t winner = run;
+		for (size_t node = (run + runs_.size()) / 2; node >= 1; node /= 2)
+		{
+			if (before(losers_[node], winner))
+				std::swap(losers_[node], winner);
+		}
+		losers_[0] = winner;
+	}
+};
@@ -0,0 +1,266 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+///      (work stealing)     fork-join.
+/// ,  ,       0    .
+/// </summary>
+/// <remarks>
+///        :        (LIFO),
+///      .    ,    .
+///       ,      .  
+///    ,   ,        ,  
+/// (  ).    ,       
+///        (. RBTree::union_with).
+/// </remarks>
+class ForkJoinPool
+{
+private:
+	/// <summary>
+	///   fork-join:   ,    ,   .
+	/// </summary>
+	struct Task
+	{
+		std::function<void()> fn;
+		std::atomic<bool> done{ false };
+		std::exception_ptr error;
+
+		void execute()
+		{
+			try
+			{
+				fn();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+			done.store(true, std::memory_order_release);
+		}
+	};
+	/// <summary>
+	///     .
+	/// </summary>
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<Task*> tasks;
+	};
+
+	std::vector<WorkerQueue> queues_;
+	std::vector<std::thread> workers_;
+	std::atomic<size_t> pending_{ 0 };
+	std::atomic<bool> stop_{ false };
+	std::mutex sleep_mutex_;
+	std::condition_variable sleep_cv_;
+
+	ForkJoinPool* previous_pool_ = nullptr;
+	size_t previous_index_ = 0;
+
+	static ForkJoinPool*& current_pool()
+	{
+		thread_local ForkJoinPool* pool = nullptr;
+		return pool;
+	}
+	static size_t& current_index()
+	{
+		thread_local size_t index = 0;
+		return index;
+	}
+
+public:
+	/// <summary>
+	///    threads ,   .
+	/// </summary>
+	/// <param name="threads">  ; 0  std::thread::hardware_concurrency().</param>
+	explicit ForkJoinPool(size_t threads = 0)
+	{
+		if (threads == 0)
+			threads = std::thread::hardware_concurrency();
+		if (threads == 0)
+			threads = 1;
+
+		queues_ = std::vector<WorkerQueue>(threads);
+
+		previous_pool_ = current_pool();
+		previous_index_ = current_index();
+		current_pool() = this;
+		current_index() = 0;
+
+		for (size_t i = 1; i < threads; ++i)
+			workers_.emplace_back([this, i] { worker_loop(i); });
+	}
+	/// <summary>
+	///      ,     .
+	/// </summary>
+	~ForkJoinPool()
+	{
+		assert(current_pool() == this && current_index() == 0
+			&& "ForkJoinPool must be destroyed by its creating thread, in reverse order of creation");
+		stop_.store(true);
+		sleep_cv_.notify_all();
+		for (auto& worker : workers_)
+			worker.join();
+
+		current_pool() = previous_pool_;
+		current_index() = previous_index_;
+	}
+
+	ForkJoinPool(const ForkJoinPool&) = delete;
+	ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+	/// <summary>
+	///   ,  -.
+	/// </summary>
+	size_t size() const
+	{
+		return queues_.size();
+	}
+
+	/// <summary>
+	///        .     ,
+	///   ;     ,     .
+	/// </summary>
+	/// <param name="first"> .</param>
+	/// <param name="second"> .</param>
+	/// <remarks>
+	///    ,   ,   .
+	///       .
+	/// </remarks>
+	template<class F1, class F2>
+	void invoke(F1&& first, F2&& second)
+	{
+		if (current_pool() != this || queues_.size() == 1)
+		{
+			first();
+			second();
+			return;
+		}
+
+		size_t index = current_index();
+		Task task;
+		task.fn = [&second] { second(); };
+		push(index, &task);
+
+		std::exception_ptr first_error;
+		try
+		{
+			first();
+		}
+		catch (...)
+		{
+			first_error = std::current_exception();
+		}
+
+		if (pop_if_back(index, &task))
+			task.execute();
+		else
+			wait(index, task);
+
+		if (first_error)
+			std::rethrow_exception(first_error);
+		if (task.error)
+			std::rethrow_exception(task.error);
+	}
+
+private:
+	void push(size_t index, Task* task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(queues_[index].mutex);
+			queues_[index].tasks.push_back(task);
+		}
+		pending_.fetch_add(1, std::memory_order_release);
+		sleep_cv_.notify_one();
+	}
+	bool pop_if_back(size_t index, Task* task)
+	{
+		std::lock_guard<std::mutex> lock(queues_[index].mutex);
+		auto& tasks = queues_[index].tasks;
+		if (tasks.empty() || tasks.back() != task)
+			return false;
+		tasks.pop_back();
+		pending_.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+	/// <summary>
+	///     ,        .
+	/// </summary>
+	Task* take(size_t index)
+	{
+		{
+			std::lock_guard<std::mutex> lock(queues_[index].mutex);
+			auto& tasks = queues_[index].tasks;
+			if (!tasks.empty())
+			{
+				Task* task = tasks.back();
+				tasks.pop_back();
+				pending_.fetch_sub(1, std::memory_order_relaxed);
+				return task;
+			}
+		}
+		for (size_t offset = 1; offset < queues_.size(); ++offset)
+		{
+			WorkerQueue& victim = queues_[(index + offset) % queues_.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				Task* task = victim.tasks.front();
+				victim.tasks.pop_front();
+				pending_.fetch_sub(1, std::memory_order_relaxed);
+				return task;
+			}
+		}
+		return nullptr;
+	}
+	/// <summary>
+	///    ,      .
+	/// </summary>
+	void wait(size_t index, Task& task)
+	{
+		while (!task.done.load(std::memory_order_acquire))
+		{
+			if (pending_.load(std::memory_order_acquire) > 0)
+			{
+				if (Task* other = take(index))
+				{
+					other->execute();
+					continue;
+				}
+			}
+			std::this_thread::yield();
+		}
+	}
+	void worker_loop(size_t index)
+	{
+		current_pool() = this;
+		current_index() = index;
+
+		while (true)
+		{
+			if (Task* task = take(index))
+			{
+				task->execute();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleep_mutex_);
+			sleep_cv_.wait_for(lock, std::chrono::milliseconds(1), [this]
+				{
+					return stop_.load() || pending_.load(std::memory_order_acquire) > 0;
+				});
+			if (stop_.load() && pending_.load() == 0)
+				return;
+		}
+	}
+};
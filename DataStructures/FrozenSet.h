@@ -0,0 +1,278 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+/// <summary>
+///      :        
+///      (  k    2k  2k + 1).
+///         ,     .
+/// </summary>
+/// <typeparam name="T"> ;     operator&lt;.</typeparam>
+template<class T>
+class FrozenSet
+{
+private:
+	/// <summary>
+	///    ,   1;  0  .
+	/// </summary>
+	std::vector<T> data_;
+	size_t size_ = 0;
+
+	/// <summary>
+	///    :   k  log2(prefetch_stride)   
+	/// prefetch_stride  ,   k * prefetch_stride,     -.
+	/// </summary>
+	static constexpr size_t prefetch_stride = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+public:
+	/// <summary>
+	///   :     ,     .
+	/// </summary>
+	class const_iterator
+	{
+		friend class FrozenSet;
+	private:
+		const FrozenSet* set_ = nullptr;
+		size_t index_ = 0;
+
+		const_iterator(const FrozenSet* set, size_t index) : set_(set), index_(index) {}
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		const_iterator() = default;
+
+		const T& operator*() const
+		{
+			return set_->data_[index_];
+		}
+		const T* operator->() const
+		{
+			return &set_->data_[index_];
+		}
+		const_iterator& operator++()
+		{
+			size_t n = set_->size_;
+			if (2 * index_ + 1 <= n)
+			{
+				index_ = 2 * index_ + 1;
+				while (2 * index_ <= n)
+					index_ = 2 * index_;
+			}
+			else
+			{
+				index_ >>= std::countr_one(index_) + 1;
+			}
+			return *this;
+		}
+		const_iterator operator++(int)
+		{
+			const_iterator tmp = *this;
+			++(*this);
+			return tmp;
+		}
+		const_iterator& operator--()
+		{
+			size_t n = set_->size_;
+			if (index_ == 0)
+			{
+				index_ = n == 0 ? 0 : 1;
+				while (index_ && 2 * index_ + 1 <= n)
+					index_ = 2 * index_ + 1;
+			}
+			else if (2 * index_ <= n)
+			{
+				index_ = 2 * index_;
+				while (2 * index_ + 1 <= n)
+					index_ = 2 * index_ + 1;
+			}
+			else
+			{
+				index_ >>= std::countr_zero(index_) + 1;
+			}
+			return *this;
+		}
+		const_iterator operator--(int)
+		{
+			const_iterator tmp = *this;
+			--(*this);
+			return tmp;
+		}
+		bool operator==(const const_iterator& other) const
+		{
+			return index_ == other.index_;
+		}
+		bool operator!=(const const_iterator& other) const
+		{
+			return index_ != other.index_;
+		}
+	};
+	using iterator = const_iterator;
+
+	/// <summary>
+	///   .
+	/// </summary>
+	FrozenSet() : data_(1) {}
+	/// <summary>
+	///    .    ,  ;  .
+	/// </summary>
+	/// <typeparam name="It"> ,   InputIterator.</typeparam>
+	/// <param name="first">    ().</param>
+	/// <param name="last">    ( ).</param>
+	template<class It>
+	FrozenSet(It first, It last)
+	{
+		std::vector<T> sorted;
+		for (; first != last; ++first)
+			sorted.push_back(*first);
+		if (!std::is_sorted(sorted.begin(), sorted.end()))
+			std::sort(sorted.begin(), sorted.end());
+		sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const T& a, const T& b) { return !(a < b) && !(b < a); }), sorted.end());
+
+		size_ = sorted.size();
+		data_.resize(size_ + 1);
+		size_t next = 0;
+		fill(sorted, next, 1);
+	}
+
+	/// <summary>
+	///   .
+	/// </summary>
+	size_t size() const
+	{
+		return size_;
+	}
+	/// <summary>
+	/// ,   .
+	/// </summary>
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+	/// <summary>
+	///      .
+	/// </summary>
+	size_t memory_bytes() const
+	{
+		return data_.capacity() * sizeof(T);
+	}
+
+	const_iterator begin() const
+	{
+		const_iterator it(this, 0);
+		return ++it;
+	}
+	const_iterator end() const
+	{
+		return const_iterator(this, 0);
+	}
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+	/// <summary>
+	///  ,   value.      :     2k + (data[k] &lt; value).
+	/// </summary>
+	const_iterator lower_bound(const T& value) const
+	{
+		size_t k = 1;
+		while (k <= size_)
+		{
+			prefetch(k * prefetch_stride);
+			k = 2 * k + (data_[k] < value);
+		}
+		return const_iterator(this, k >> (std::countr_one(k) + 1));
+	}
+	/// <summary>
+	///  ,   value.
+	/// </summary>
+	const_iterator upper_bound(const T& value) const
+	{
+		size_t k = 1;
+		while (k <= size_)
+		{
+			prefetch(k * prefetch_stride);
+			k = 2 * k + !(value < data_[k]);
+		}
+		return const_iterator(this, k >> (std::countr_one(k) + 1));
+	}
+	/// <summary>
+	///  ;  end(),   .
+	/// </summary>
+	const_iterator find(const T& value) const
+	{
+		const_iterator it = lower_bound(value);
+		if (it != end() && !(value < *it))
+			return it;
+		return end();
+	}
+	/// <summary>
+	/// ,     .
+	/// </summary>
+	bool contains(const T& value) const
+	{
+		return find(value) != end();
+	}
+	/// <summary>
+	///   [lower_bound(value), upper_bound(value)).
+	/// </summary>
+	std::pair<const_iterator, const_iterator> equal_range(const T& value) const
+	{
+		return { lower_bound(value), upper_bound(value) };
+	}
+
+	/// <summary>
+	/// ,       in-order      size() .
+	/// </summary>
+	bool validate() const
+	{
+		size_t counted = 0;
+		const T* prev = nullptr;
+		for (auto it = begin(); it != end(); ++it)
+		{
+			if (prev && !(*prev < *it))
+				return false;
+			prev = &*it;
+			++counted;
+		}
+		return counted == size_;
+	}
+
+	bool operator==(const FrozenSet& other) const
+	{
+		return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+	}
+
+private:
+	/// <summary>
+	///         in-order .
+	/// </summary>
+	void fill(const std::vector<T>& sorted, size_t& next, size_t k)
+	{
+		if (k > size_) return;
+		fill(sorted, next, 2 * k);
+		data_[k] = sorted[next++];
+		fill(sorted, next, 2 * k + 1);
+	}
+	/// <summary>
+	///    -     .
+	/// </summary>
+	void prefetch(size_t k) const
+	{
+		if (k >= data_.size()) return;
+#if defined(_MSC_VER)
+		_mm_prefetch(reinterpret_cast<const char*>(data_.data() + k), _MM_HINT_T0);
+#else
+		__builtin_prefetch(data_.data() + k);
+#endif
+	}
+};
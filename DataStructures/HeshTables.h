@@ -1,8 +1,14 @@
 #pragma once
 #include <vector>
+#include <optional>
 #include <utility>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 //   
 /// <summary>
 ///  -    , ,    .
@@ -39,6 +45,47 @@ public:
 	virtual size_t size() const = 0;
 };
 
+/// <summary>
+///  ,  HashMapChaining::save.      , 
+///            .
+/// </summary>
+/// <remarks>
+/// : ,  uint64_t offsets[bucket_count + 1] (  i  
+/// [offsets[i], offsets[i + 1])),    {, }.      .
+/// </remarks>
+struct HashFileHeader
+{
+	static constexpr char expected_magic[8] = { 'D', 'S', 'H', 'A', 'S', 'H', '0', '1' };
+	static constexpr uint32_t byte_order_mark = 0x01020304;
+
+	char magic[8];
+	uint32_t byte_order;
+	uint32_t entry_size;
+	uint32_t key_size;
+	uint32_t value_size;
+	uint64_t bucket_count;
+	uint64_t size;
+	uint64_t offsets_offset;
+	uint64_t entries_offset;
+	uint64_t file_size;
+};
+
+/// <summary>
+///   HashFileHeader.    std::pair  ,       .
+/// </summary>
+template<class Key, class Value>
+struct HashFileEntry
+{
+	Key first;
+	Value second;
+};
+
+/// <summary>
+///   ,   ;   MappedHashMap.h,     open_mmap.
+/// </summary>
+template<class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class MappedHashMap;
+
 /// <summary>
 ///  -     .
 /// </summary>
@@ -59,6 +106,9 @@ private:
 
 	float max_load_factor_ = 1.0f;
 public:
+	using key_type = Key;
+	using mapped_type = Value;
+
 	/// <summary>
 	///   -  .
 	/// </summary>
@@ -180,6 +230,56 @@ public:
 		}
 	};
 	/// <summary>
+	/// ,     extract().  - ,   ;
+	/// insert(node_type&&)        .
+	/// </summary>
+	class node_type
+	{
+		friend class HashMapChaining;
+	private:
+		std::optional<std::pair<Key, Value>> entry_;
+
+		explicit node_type(std::pair<Key, Value>&& entry) : entry_(std::move(entry)) {}
+	public:
+		node_type() = default;
+		node_type(node_type&& other) noexcept : entry_(std::move(other.entry_))
+		{
+			other.entry_.reset();
+		}
+		node_type& operator=(node_type&& other) noexcept
+		{
+			entry_ = std::move(other.entry_);
+			other.entry_.reset();
+			return *this;
+		}
+
+		/// <summary>
+		/// ,  handle   .
+		/// </summary>
+		bool empty() const
+		{
+			return !entry_.has_value();
+		}
+		explicit operator bool() const
+		{
+			return entry_.has_value();
+		}
+		/// <summary>
+		///  .    ,   .
+		/// </summary>
+		Key& key()
+		{
+			return entry_->first;
+		}
+		/// <summary>
+		///  .
+		/// </summary>
+		Value& mapped()
+		{
+			return entry_->second;
+		}
+	};
+	/// <summary>
 	///  -        .
 	/// </summary>
 	/// <param name="bucket_count">    ()  -</param>
@@ -261,6 +361,68 @@ public:
 		return false;
 	}
 	/// <summary>
+	///       ,   -  node_type.
+	/// </summary>
+	/// <param name="key">  .</param>
+	/// <returns>node_type     node_type,     .</returns>
+	node_type extract(const Key& key)
+	{
+		size_t index = hash_(key) % buckets_.size();
+		Bucket& bucket = buckets_[index];
+		for (size_t i = 0; i < bucket.size(); ++i)
+		{
+			if (equal_(bucket[i].first, key))
+				return extract(iterator(this, index, i));
+		}
+		return node_type();
+	}
+	/// <summary>
+	///  ,    ,   -  node_type.
+	/// </summary>
+	/// <param name="it">  .  end()   node_type.</param>
+	node_type extract(iterator it)
+	{
+		if (it.map_ != this || it.bucket_idx_ >= buckets_.size())
+			return node_type();
+
+		Bucket& bucket = buckets_[it.bucket_idx_];
+		node_type handle(std::move(bucket[it.elem_idx_]));
+		bucket.erase(bucket.begin() + it.elem_idx_);
+		--size_;
+		return handle;
+	}
+	/// <summary>
+	///  ,      ,         .
+	/// </summary>
+	/// <param name="handle">,   extract().     .</param>
+	/// <returns>             .
+	///    ,    handle.   handle  {end(), false}.</returns>
+	std::pair<iterator, bool> insert(node_type&& handle)
+	{
+		if (handle.empty())
+			return { end(), false };
+
+		const Key& key = handle.entry_->first;
+		size_t hash = hash_(key);
+		size_t index = hash % buckets_.size();
+		for (size_t i = 0; i < buckets_[index].size(); ++i)
+		{
+			if (equal_(buckets_[index][i].first, key))
+				return { iterator(this, index, i), false };
+		}
+
+		//     ,        .
+		if (static_cast<float>(size_ + 1) / buckets_.size() > max_load_factor_)
+		{
+			rehash(buckets_.size() * 2);
+			index = hash % buckets_.size();
+		}
+		buckets_[index].push_back(std::move(*handle.entry_));
+		handle.entry_.reset();
+		++size_;
+		return { iterator(this, index, buckets_[index].size() - 1), true };
+	}
+	/// <summary>
 	///       -.
 	/// </summary>
 	/// <returns>     -  size_t. </returns>
@@ -269,6 +431,85 @@ public:
 		return size_;
 	}
 
+	/// <summary>
+	///      HashFileHeader,  open_mmap     .
+	///     ,        .
+	/// </summary>
+	/// <param name="path">  ;   .</param>
+	/// <exception cref="std::runtime_error"> .</exception>
+	void save(const std::string& path) const
+	{
+		using Entry = HashFileEntry<Key, Value>;
+		static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+			"HashMapChaining::save requires trivially copyable key and value types");
+
+		HashFileHeader header{};
+		std::memcpy(header.magic, HashFileHeader::expected_magic, sizeof(header.magic));
+		header.byte_order = HashFileHeader::byte_order_mark;
+		header.entry_size = sizeof(Entry);
+		header.key_size = sizeof(Key);
+		header.value_size = sizeof(Value);
+		header.bucket_count = buckets_.size();
+		header.size = size_;
+		header.offsets_offset = align_up(sizeof(HashFileHeader), alignof(uint64_t));
+		header.entries_offset = align_up(header.offsets_offset + (buckets_.size() + 1) * sizeof(uint64_t), 64);
+		header.file_size = header.entries_offset + size_ * sizeof(Entry);
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("HashMapChaining::save: cannot open " + path);
+
+		std::vector<char> padding(64, 0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(padding.data(), header.offsets_offset - sizeof(header));
+
+		std::vector<uint64_t> offsets;
+		offsets.reserve(buckets_.size() + 1);
+		uint64_t offset = 0;
+		for (const auto& bucket : buckets_)
+		{
+			offsets.push_back(offset);
+			offset += bucket.size();
+		}
+		offsets.push_back(offset);
+		out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+		out.write(padding.data(), header.entries_offset - header.offsets_offset - offsets.size() * sizeof(uint64_t));
+
+		std::vector<Entry> chunk;
+		chunk.reserve(4096);
+		for (const auto& bucket : buckets_)
+		{
+			for (const auto& data : bucket)
+			{
+				Entry entry;
+				std::memset(&entry, 0, sizeof(entry));
+				entry.first = data.first;
+				entry.second = data.second;
+				chunk.push_back(entry);
+				if (chunk.size() == chunk.capacity())
+				{
+					out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(Entry));
+					chunk.clear();
+				}
+			}
+		}
+		out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(Entry));
+
+		if (!out.flush())
+			throw std::runtime_error("HashMapChaining::save: cannot write " + path);
+	}
+	/// <summary>
+	///  ,  save(),       .
+	///       :       .
+	/// </summary>
+	/// <param name="path">  .</param>
+	/// <exception cref="std::runtime_error">       .</exception>
+	/// <remarks> MappedHashMap.h:        -.</remarks>
+	static MappedHashMap<Key, Value, Hash, KeyEqual> open_mmap(const std::string& path, const Hash& h = Hash{}, const KeyEqual& eq = KeyEqual{})
+	{
+		return MappedHashMap<Key, Value, Hash, KeyEqual>(path, h, eq);
+	}
+
 	/// <summary>
 	///      ()  -.
 	/// </summary>
@@ -278,12 +519,12 @@ public:
 		if (new_bucket_count < 1) new_bucket_count = 1;
 
 		std::vector<Bucket> new_buckets(new_bucket_count);
-		for (const auto& bucket : buckets_)
+		for (auto& bucket : buckets_)
 		{
-			for (const auto& data : bucket)
+			for (auto& data : bucket)
 			{
 				size_t new_index = hash_(data.first) % new_bucket_count;
-				new_buckets[new_index].emplace_back(data);
+				new_buckets[new_index].emplace_back(std::move(data));
 			}
 		}
 
@@ -424,4 +665,10 @@ public:
 	{
 		return iterator(this, buckets_.size(), 0);
 	}
+
+private:
+	static uint64_t align_up(uint64_t offset, uint64_t alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
 };
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// -     HDR:   2^precision_bits  ,  
+///     2^(precision_bits - 1)  .      1/128,
+///        ,    O(1)    .
+/// </summary>
+class LatencyHistogram
+{
+private:
+	static constexpr unsigned precision_bits = 8;
+	static constexpr uint64_t sub_bucket_count = uint64_t(1) << precision_bits;
+	static constexpr uint64_t sub_bucket_half = sub_bucket_count / 2;
+	static constexpr size_t bucket_total = sub_bucket_count + (64 - precision_bits) * sub_bucket_half;
+
+	std::vector<uint64_t> counts_;
+	uint64_t total_ = 0;
+	uint64_t min_ = UINT64_MAX;
+	uint64_t max_ = 0;
+	double sum_ = 0;
+
+public:
+	LatencyHistogram() : counts_(bucket_total, 0) {}
+
+	/// <summary>
+	///   count .
+	/// </summary>
+	void record(uint64_t value, uint64_t count = 1)
+	{
+		if (count == 0)
+			return;
+		counts_[index_of(value)] += count;
+		total_ += count;
+		min_ = std::min(min_, value);
+		max_ = std::max(max_, value);
+		sum_ += static_cast<double>(value) * count;
+	}
+	/// <summary>
+	///     .
+	/// </summary>
+	void merge(const LatencyHistogram& other)
+	{
+		for (size_t i = 0; i < counts_.size(); ++i)
+			counts_[i] += other.counts_[i];
+		total_ += other.total_;
+		min_ = std::min(min_, other.min_);
+		max_ = std::max(max_, other.max_);
+		sum_ += other.sum_;
+	}
+
+	uint64_t count() const
+	{
+		return total_;
+	}
+	uint64_t min() const
+	{
+		return total_ ? min_ : 0;
+	}
+	uint64_t max() const
+	{
+		return max_;
+	}
+	double mean() const
+	{
+		return total_ ? sum_ / total_ : 0;
+	}
+
+	/// <summary>
+	/// ,    percentile   (    ).
+	/// </summary>
+	/// <param name="percentile"> 0  100.</param>
+	uint64_t percentile(double percentile) const
+	{
+		if (total_ == 0)
+			return 0;
+		double clamped = std::clamp(percentile, 0.0, 100.0);
+		uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100 * total_)));
+		uint64_t seen = 0;
+		for (size_t i = 0; i < counts_.size(); ++i)
+		{
+			seen += counts_[i];
+			if (seen >= target)
+				return std::clamp(highest_equivalent(i), min_, max_);
+		}
+		return max_;
+	}
+
+private:
+	static size_t index_of(uint64_t value)
+	{
+		if (value < sub_bucket_count)
+			return static_cast<size_t>(value);
+		unsigned shift = static_cast<unsigned>(std::bit_width(value)) - precision_bits;
+		return static_cast<size_t>(sub_bucket_count + (shift - 1) * sub_bucket_half + ((value >> shift) - sub_bucket_half));
+	}
+	static uint64_t highest_equivalent(size_t index)
+	{
+		if (index < sub_bucket_count)
+			return index;
+		uint64_t offset = index - sub_bucket_count;
+		unsigned shift = static_cast<unsigned>(offset / sub_bucket_half) + 1;
+		uint64_t lowest = (offset % sub_bucket_half + sub_bucket_half) << shift;
+		return lowest + ((uint64_t(1) << shift) - 1);
+	}
+};
+
+/// <summary>
+///    ,  .
+/// </summary>
+struct LatencyStats
+{
+	double p50 = 0;
+	double p90 = 0;
+	double p99 = 0;
+	double p999 = 0;
+	double max = 0;
+	double mean = 0;
+	/// <summary>
+	///    (  ).
+	/// </summary>
+	uint64_t count = 0;
+	/// <summary>
+	///       .
+	/// </summary>
+	size_t batch = 1;
+	/// <summary>
+	///     ,    .
+	/// </summary>
+	double timer_overhead = 0;
+	LatencyHistogram histogram;
+
+	static LatencyStats from(const LatencyHistogram& histogram, size_t batch, double timer_overhead)
+	{
+		LatencyStats stats;
+		stats.p50 = static_cast<double>(histogram.percentile(50));
+		stats.p90 = static_cast<double>(histogram.percentile(90));
+		stats.p99 = static_cast<double>(histogram.percentile(99));
+		stats.p999 = static_cast<double>(histogram.percentile(99.9));
+		stats.max = static_cast<double>(histogram.max());
+		stats.mean = histogram.mean();
+		stats.count = histogram.count();
+		stats.batch = batch;
+		stats.timer_overhead = timer_overhead;
+		stats.histogram = histogram;
+		return stats;
+	}
+};
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstddef>
 #include <initializer_list>
+#include <stdexcept>
+#include <utility>
 /// <summary>
 ///   Node   ,         .
 /// </summary>
@@ -82,6 +85,53 @@ public:
 		}
 
 	};
+	/// <summary>
+	/// ,     extract().     ,      ;
+	/// insert(pos, node_type&&)          .
+	/// </summary>
+	class node_type
+	{
+		friend class List<T>;
+	private:
+		NodeList<T>* node_ = nullptr;
+
+		explicit node_type(NodeList<T>* node) : node_(node) {}
+	public:
+		node_type() = default;
+		node_type(node_type&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+		node_type& operator=(node_type&& other) noexcept
+		{
+			if (this != &other)
+			{
+				delete node_;
+				node_ = std::exchange(other.node_, nullptr);
+			}
+			return *this;
+		}
+		~node_type()
+		{
+			delete node_;
+		}
+
+		/// <summary>
+		/// ,  handle   .
+		/// </summary>
+		bool empty() const
+		{
+			return node_ == nullptr;
+		}
+		explicit operator bool() const
+		{
+			return node_ != nullptr;
+		}
+		/// <summary>
+		///  .
+		/// </summary>
+		T& value() const
+		{
+			return node_->data;
+		}
+	};
 private: 
 	/// <summary>
 	///        .
@@ -434,6 +484,58 @@ public:
 		return iterator(next_node);
 	}
 	/// <summary>
+	///    ,    pos,   .
+	/// </summary>
+	/// <param name="pos">   .</param>
+	/// <returns>node_type,  .</returns>
+	node_type extract(iterator pos)
+	{
+		if (pos == end())
+			throw std::out_of_range("Cannot extract end() iterator");
+
+		NodeList<T>* node = pos.ptr;
+		if (node->prev)
+			node->prev->next = node->next;
+		else
+			head = node->next;
+		if (node->next)
+			node->next->prev = node->prev;
+		else
+			tail = node->prev;
+
+		node->next = node->prev = nullptr;
+		--list_size;
+		return node_type(node);
+	}
+	/// <summary>
+	///   pos ,      ,      .
+	/// </summary>
+	/// <param name="pos">,     .</param>
+	/// <param name="handle">,   extract().    .</param>
+	/// <returns>   ;   handle  pos.</returns>
+	iterator insert(iterator pos, node_type&& handle)
+	{
+		NodeList<T>* node = std::exchange(handle.node_, nullptr);
+		if (!node)
+			return pos;
+
+		NodeList<T>* after = pos.ptr;
+		NodeList<T>* before = after ? after->prev : tail;
+		node->prev = before;
+		node->next = after;
+		if (before)
+			before->next = node;
+		else
+			head = node;
+		if (after)
+			after->prev = node;
+		else
+			tail = node;
+
+		++list_size;
+		return iterator(node);
+	}
+	/// <summary>
 	///   ,   .
 	/// </summary>
 	/// <param name="value">; ,   ,  .</param>
@@ -0,0 +1,163 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// <summary>
+/// ,      .       .
+///    ,      .
+/// </summary>
+class MappedFile
+{
+private:
+	const std::byte* data_ = nullptr;
+	size_t size_ = 0;
+#if defined(_WIN32)
+	HANDLE file_ = INVALID_HANDLE_VALUE;
+	HANDLE mapping_ = nullptr;
+#else
+	int fd_ = -1;
+#endif
+
+public:
+	MappedFile() = default;
+	/// <summary>
+	///           .
+	/// </summary>
+	/// <param name="path">  .</param>
+	/// <exception cref="std::runtime_error">     .</exception>
+	explicit MappedFile(const std::string& path)
+	{
+#if defined(_WIN32)
+		file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("MappedFile: cannot open " + path);
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file_, &size))
+		{
+			close();
+			throw std::runtime_error("MappedFile: cannot stat " + path);
+		}
+		size_ = static_cast<size_t>(size.QuadPart);
+		if (size_ == 0)
+			return;
+
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_)
+			data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+		if (!data_)
+		{
+			close();
+			throw std::runtime_error("MappedFile: cannot map " + path);
+		}
+#else
+		fd_ = ::open(path.c_str(), O_RDONLY);
+		if (fd_ < 0)
+			throw std::runtime_error("MappedFile: cannot open " + path);
+
+		struct stat info;
+		if (::fstat(fd_, &info) != 0)
+		{
+			close();
+			throw std::runtime_error("MappedFile: cannot stat " + path);
+		}
+		size_ = static_cast<size_t>(info.st_size);
+		if (size_ == 0)
+			return;
+
+		void* address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+		if (address == MAP_FAILED)
+		{
+			close();
+			throw std::runtime_error("MappedFile: cannot map " + path);
+		}
+		data_ = static_cast<const std::byte*>(address);
+#endif
+	}
+	~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept
+	{
+		swap(other);
+	}
+	MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			swap(other);
+		}
+		return *this;
+	}
+
+	/// <summary>
+	///   ; nullptr   .
+	/// </summary>
+	const std::byte* data() const
+	{
+		return data_;
+	}
+	/// <summary>
+	///    .
+	/// </summary>
+	size_t size() const
+	{
+		return size_;
+	}
+
+	void swap(MappedFile& other) noexcept
+	{
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+#if defined(_WIN32)
+		std::swap(file_, other.file_);
+		std::swap(mapping_, other.mapping_);
+#else
+		std::swap(fd_, other.fd_);
+#endif
+	}
+
+private:
+	void close()
+	{
+#if defined(_WIN32)
+		if (data_)
+			UnmapViewOfFile(data_);
+		if (mapping_)
+			CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE)
+			CloseHandle(file_);
+		mapping_ = nullptr;
+		file_ = INVALID_HANDLE_VALUE;
+#else
+		if (data_)
+			::munmap(const_cast<std::byte*>(data_), size_);
+		if (fd_ >= 0)
+			::close(fd_);
+		fd_ = -1;
+#endif
+		data_ = nullptr;
+		size_ = 0;
+	}
+};
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "HeshTables.h"
+#include "MappedFile.h"
+
+/// <summary>
+///  -  ,    (. HashMapChaining::open_mmap).
+///      ;      .
+/// </summary>
+/// <typeparam name="Hash">    ,     (     ).</typeparam>
+template<class Key, class Value, class Hash, class KeyEqual>
+class MappedHashMap
+{
+public:
+	using Entry = HashFileEntry<Key, Value>;
+
+private:
+	MappedFile file_;
+	const uint64_t* offsets_ = nullptr;
+	const Entry* entries_ = nullptr;
+	size_t bucket_count_ = 0;
+	size_t size_ = 0;
+
+	Hash hash_;
+	KeyEqual equal_;
+
+public:
+	/// <summary>
+	///          (   ),  
+	///        .
+	/// </summary>
+	/// <exception cref="std::runtime_error">  ,      /.</exception>
+	explicit MappedHashMap(const std::string& path, const Hash& h = Hash{}, const KeyEqual& eq = KeyEqual{})
+		: file_(path), hash_(h), equal_(eq)
+	{
+		if (file_.size() < sizeof(HashFileHeader))
+			throw std::runtime_error("MappedHashMap: file is too small");
+
+		HashFileHeader header;
+		std::memcpy(&header, file_.data(), sizeof(header));
+		if (std::memcmp(header.magic, HashFileHeader::expected_magic, sizeof(header.magic)) != 0 ||
+			header.byte_order != HashFileHeader::byte_order_mark)
+			throw std::runtime_error("MappedHashMap: not a hash table file");
+		if (header.entry_size != sizeof(Entry) || header.key_size != sizeof(Key) || header.value_size != sizeof(Value))
+			throw std::runtime_error("MappedHashMap: file was written for other key/value types");
+		//   ,   :      .
+		if (header.file_size != file_.size() || header.bucket_count == 0 ||
+			header.offsets_offset % alignof(uint64_t) != 0 || header.entries_offset % alignof(Entry) != 0 ||
+			header.offsets_offset > header.entries_offset || header.entries_offset > header.file_size ||
+			header.bucket_count >= (header.entries_offset - header.offsets_offset) / sizeof(uint64_t) ||
+			header.size > (header.file_size - header.entries_offset) / sizeof(Entry))
+			throw std::runtime_error("MappedHashMap: file is truncated or corrupted");
+
+		bucket_count_ = static_cast<size_t>(header.bucket_count);
+		size_ = static_cast<size_t>(header.size);
+		offsets_ = reinterpret_cast<const uint64_t*>(file_.data() + header.offsets_offset);
+		entries_ = reinterpret_cast<const Entry*>(file_.data() + header.entries_offset);
+		// lookup   [offsets_[i], offsets_[i + 1])  .
+		if (offsets_[0] != 0 || offsets_[bucket_count_] != size_)
+			throw std::runtime_error("MappedHashMap: file is truncated or corrupted");
+		for (size_t i = 0; i < bucket_count_; ++i)
+		{
+			if (offsets_[i] > offsets_[i + 1])
+				throw std::runtime_error("MappedHashMap: file is truncated or corrupted");
+		}
+	}
+
+	/// <summary>
+	///    .
+	/// </summary>
+	/// <param name="value">   .</param>
+	/// <returns>true,   .</returns>
+	bool find(const Key& key, Value& value) const
+	{
+		const Entry* entry = lookup(key);
+		if (!entry)
+			return false;
+		value = entry->second;
+		return true;
+	}
+	/// <summary>
+	/// ,     .
+	/// </summary>
+	bool contains(const Key& key) const
+	{
+		return lookup(key) != nullptr;
+	}
+	/// <summary>
+	///         .
+	/// </summary>
+	/// <returns>    .</returns>
+	const Value& at(const Key& key) const
+	{
+		const Entry* entry = lookup(key);
+		if (!entry)
+			throw std::out_of_range("MappedHashMap::at: key not found");
+		return entry->second;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+	size_t bucket_count() const
+	{
+		return bucket_count_;
+	}
+
+	/// <summary>
+	///    .
+	/// </summary>
+	const Entry* begin() const
+	{
+		return entries_;
+	}
+	const Entry* end() const
+	{
+		return entries_ + size_;
+	}
+
+private:
+	const Entry* lookup(const Key& key) const
+	{
+		size_t index = hash_(key) % bucket_count_;
+		const Entry* last = entries_ + offsets_[index + 1];
+		for (const Entry* entry = entries_ + offsets_[index]; entry != last; ++entry)
+		{
+			if (equal_(entry->first, key))
+				return entry;
+		}
+		return nullptr;
+	}
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "MappedFile.h"
+#include "SortedArrayFile.h"
+
+/// <summary>
+///     ,   .    
+///   :   ,      .
+/// </summary>
+/// <typeparam name="T">   ,   operator&lt;.</typeparam>
+template<class T>
+class MappedSortedArray
+{
+private:
+	MappedFile file_;
+	const T* data_ = nullptr;
+	size_t size_ = 0;
+
+public:
+	using const_iterator = const T*;
+
+	/// <summary>
+	///     .
+	/// </summary>
+	/// <exception cref="std::runtime_error">       /.</exception>
+	explicit MappedSortedArray(const std::string& path) : file_(path)
+	{
+		if (file_.size() < sizeof(SortedArrayFileHeader))
+			throw std::runtime_error("MappedSortedArray: file is too small");
+
+		SortedArrayFileHeader header;
+		std::memcpy(&header, file_.data(), sizeof(header));
+		if (std::memcmp(header.magic, SortedArrayFileHeader::expected_magic, sizeof(header.magic)) != 0 ||
+			header.byte_order != SortedArrayFileHeader::byte_order_mark)
+			throw std::runtime_error("MappedSortedArray: not a sorted array file");
+		if (header.element_size != sizeof(T))
+			throw std::runtime_error("MappedSortedArray: file was written for another element type");
+		if (header.file_size != file_.size() || header.data_offset % alignof(T) != 0 ||
+			header.data_offset + header.count * sizeof(T) > header.file_size)
+			throw std::runtime_error("MappedSortedArray: file is truncated or corrupted");
+
+		data_ = reinterpret_cast<const T*>(file_.data() + header.data_offset);
+		size_ = static_cast<size_t>(header.count);
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+	const_iterator begin() const
+	{
+		return data_;
+	}
+	const_iterator end() const
+	{
+		return data_ + size_;
+	}
+
+	/// <summary>
+	///  ,   value.
+	/// </summary>
+	const_iterator lower_bound(const T& value) const
+	{
+		return std::lower_bound(begin(), end(), value);
+	}
+	/// <summary>
+	///  ,   value.
+	/// </summary>
+	const_iterator upper_bound(const T& value) const
+	{
+		return std::upper_bound(begin(), end(), value);
+	}
+	/// <summary>
+	///  ;  end(),   .
+	/// </summary>
+	const_iterator find(const T& value) const
+	{
+		const_iterator it = lower_bound(value);
+		if (it != end() && !(value < *it))
+			return it;
+		return end();
+	}
+	/// <summary>
+	/// ,     .
+	/// </summary>
+	bool contains(const T& value) const
+	{
+		return find(value) != end();
+	}
+	/// <summary>
+	///   [lower_bound(value), upper_bound(value)).
+	/// </summary>
+	std::pair<const_iterator, const_iterator> equal_range(const T& value) const
+	{
+		return { lower_bound(value), upper_bound(value) };
+	}
+};
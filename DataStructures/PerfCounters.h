@@ -0,0 +1,222 @@
+#pragma once
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// <summary>
+///   .  BenchmarkStats      .
+/// NaN ,    ( perf_event_open,       ).
+/// </summary>
+struct PerfCounterValues
+{
+	static constexpr double unavailable = std::numeric_limits<double>::quiet_NaN();
+
+	double cycles = unavailable;
+	double instructions = unavailable;
+	double l1d_misses = unavailable;
+	double llc_misses = unavailable;
+	double branch_misses = unavailable;
+	double dtlb_misses = unavailable;
+
+	/// <summary>
+	///      .
+	/// </summary>
+	bool available() const
+	{
+		for (double value : { cycles, instructions, l1d_misses, llc_misses, branch_misses, dtlb_misses })
+			if (!std::isnan(value))
+				return true;
+		return false;
+	}
+	/// <summary>
+	///   .
+	/// </summary>
+	double ipc() const
+	{
+		return cycles > 0 ? instructions / cycles : unavailable;
+	}
+	PerfCounterValues divided_by(double divisor) const
+	{
+		PerfCounterValues result = *this;
+		for (double* value : { &result.cycles, &result.instructions, &result.l1d_misses, &result.llc_misses,
+			&result.branch_misses, &result.dtlb_misses })
+			*value /= divisor;
+		return result;
+	}
+};
+
+/// <summary>
+///     perf_event_open ( Linux).    
+///    ,     .
+/// </summary>
+/// <remarks>
+///    ,     PMU   ,  
+///   time_enabled / time_running. ,    ,  NaN;   
+///  , start/stop   ,     status().
+///      .
+/// </remarks>
+class PerfCounters
+{
+private:
+	enum class Control
+	{
+		reset,
+		enable,
+		disable
+	};
+
+	std::vector<int> fds_;
+	std::vector<double PerfCounterValues::*> targets_;
+	std::string status_;
+
+public:
+	/// <param name="enabled">false     .</param>
+	explicit PerfCounters(bool enabled = true)
+	{
+		if (!enabled)
+		{
+			status_ = "disabled";
+			return;
+		}
+#if defined(__linux__)
+		int error = 0;
+		open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &PerfCounterValues::cycles, error);
+		open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &PerfCounterValues::instructions, error);
+		open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, &PerfCounterValues::branch_misses, error);
+		open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D), &PerfCounterValues::l1d_misses, error);
+		open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL), &PerfCounterValues::llc_misses, error);
+		open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB), &PerfCounterValues::dtlb_misses, error);
+		if (fds_.empty())
+			status_ = std::string("perf_event_open: ") + std::strerror(error) + paranoid_hint(error);
+		else
+			status_ = std::to_string(fds_.size()) + " of 6 counters";
+#else
+		status_ = "hardware counters require Linux perf_event_open";
+#endif
+	}
+	~PerfCounters()
+	{
+#if defined(__linux__)
+		for (int fd : fds_)
+			::close(fd);
+#endif
+	}
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	bool available() const
+	{
+		return !fds_.empty();
+	}
+	/// <summary>
+	///         .
+	/// </summary>
+	const std::string& status() const
+	{
+		return status_;
+	}
+
+	/// <summary>
+	///   .
+	/// </summary>
+	void reset()
+	{
+		control(Control::reset);
+	}
+	/// <summary>
+	///  .     ,   .
+	/// </summary>
+	void start()
+	{
+		control(Control::enable);
+	}
+	void stop()
+	{
+		control(Control::disable);
+	}
+
+	/// <summary>
+	/// ,    reset()    start()  stop(),    .
+	/// </summary>
+	PerfCounterValues read() const
+	{
+		PerfCounterValues values;
+#if defined(__linux__)
+		for (size_t i = 0; i < fds_.size(); ++i)
+		{
+			uint64_t data[3] = {};
+			if (::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+				continue;
+			uint64_t value = data[0];
+			uint64_t enabled = data[1];
+			uint64_t running = data[2];
+			if (running == 0)
+				values.*targets_[i] = enabled == 0 ? 0 : PerfCounterValues::unavailable;
+			else
+				values.*targets_[i] = static_cast<double>(value) * enabled / running;
+		}
+#endif
+		return values;
+	}
+
+private:
+	void control(Control request)
+	{
+#if defined(__linux__)
+		unsigned long code = request == Control::reset ? PERF_EVENT_IOC_RESET
+			: request == Control::enable ? PERF_EVENT_IOC_ENABLE
+			: PERF_EVENT_IOC_DISABLE;
+		for (int fd : fds_)
+			::ioctl(fd, code, 0);
+#else
+		(void)request;
+#endif
+	}
+
+#if defined(__linux__)
+	static uint64_t cache_event(uint64_t cache)
+	{
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+
+	void open_event(uint32_t type, uint64_t config, double PerfCounterValues::* target, int& error)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+		if (fd < 0)
+		{
+			error = errno;
+			return;
+		}
+		fds_.push_back(fd);
+		targets_.push_back(target);
+	}
+	static std::string paranoid_hint(int error)
+	{
+		if (error != EACCES && error != EPERM)
+			return "";
+		return " (check /proc/sys/kernel/perf_event_paranoid or CAP_PERFMON)";
+	}
+#endif
+};
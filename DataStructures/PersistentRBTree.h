@@ -0,0 +1,722 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "RBTree.h"
+
+/// <summary>
+///   - .        ,
+///       ,      .
+/// </summary>
+/// <typeparam name="T">    .</typeparam>
+template <class T>
+struct NodePRBT
+{
+    Color color;
+    T data;
+    NodePRBT* left;
+    NodePRBT* right;
+    /// <summary>
+    ///     ,   .
+    /// </summary>
+    std::atomic<size_t> refs;
+
+    NodePRBT(Color c, const T& value, NodePRBT* l = nullptr, NodePRBT* r = nullptr)
+        : color(c), data(value), left(l), right(r), refs(1) { }
+};
+
+/// <summary>
+///  (copy-on-write) - .     , snapshot()   O(1),
+///  insert  erase       ,   O(log n) . ,    ,
+///     .  ,    ,   .
+/// </summary>
+/// <typeparam name="T"> ;       operator&lt;.</typeparam>
+/// <remarks>
+///          .     ,    ,
+///        ,  snapshot().
+///            (S. Kahrs, "Red-black trees with types").
+/// </remarks>
+template <class T>
+class PersistentRBTree
+{
+private:
+    using Node = NodePRBT<T>;
+
+    Node* root;
+    size_t tree_size;
+
+public:
+    /// <summary>
+    ///    in-order.      ,      .
+    ///  ,    ,    ,    .
+    /// </summary>
+    class const_iterator
+    {
+        friend class PersistentRBTree<T>;
+    private:
+        std::vector<const Node*> path;
+        const Node* root = nullptr;
+
+        explicit const_iterator(const Node* r) : root(r) { }
+
+        void push_leftmost(const Node* node)
+        {
+            for (; node; node = node->left)
+                path.push_back(node);
+        }
+        void push_rightmost(const Node* node)
+        {
+            for (; node; node = node->right)
+                path.push_back(node);
+        }
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        const T& operator*() const
+        {
+            return path.back()->data;
+        }
+        const T* operator->() const
+        {
+            return &path.back()->data;
+        }
+        const_iterator& operator++()
+        {
+            const Node* node = path.back();
+            if (node->right)
+            {
+                push_leftmost(node->right);
+                return *this;
+            }
+            path.pop_back();
+            while (!path.empty() && path.back()->right == node)
+            {
+                node = path.back();
+                path.pop_back();
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+        const_iterator& operator--()
+        {
+            if (path.empty())
+            {
+                push_rightmost(root);
+                return *this;
+            }
+            const Node* node = path.back();
+            if (node->left)
+            {
+                push_rightmost(node->left);
+                return *this;
+            }
+            path.pop_back();
+            while (!path.empty() && path.back()->left == node)
+            {
+                node = path.back();
+                path.pop_back();
+            }
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            if (path.empty() || other.path.empty())
+                return path.empty() == other.path.empty();
+            return path.back() == other.path.back();
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return !(*this == other);
+        }
+    };
+    using iterator = const_iterator;
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    PersistentRBTree() : root(nullptr), tree_size(0) { }
+    /// <summary>
+    ///    O(1):       other.
+    /// </summary>
+    PersistentRBTree(const PersistentRBTree& other) : root(retain(other.root)), tree_size(other.tree_size) { }
+    /// <summary>
+    ///  :   other,   .
+    /// </summary>
+    PersistentRBTree(PersistentRBTree&& other) noexcept : root(other.root), tree_size(other.tree_size)
+    {
+        other.root = nullptr;
+        other.tree_size = 0;
+    }
+    /// <summary>
+    ///     .
+    /// </summary>
+    PersistentRBTree(std::initializer_list<T> init_list) : PersistentRBTree(init_list.begin(), init_list.end()) { }
+    /// <summary>
+    ///      O(n),     (,  RBTree),   O(n log n).
+    ///   .
+    /// </summary>
+    /// <typeparam name="It"> ,   InputIterator.</typeparam>
+    /// <param name="first">    ().</param>
+    /// <param name="last">    ( ).</param>
+    template<class It>
+    PersistentRBTree(It first, It last) : root(nullptr), tree_size(0)
+    {
+        std::vector<T> values;
+        for (; first != last; ++first)
+            values.push_back(*first);
+        if (!std::is_sorted(values.begin(), values.end()))
+            std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end(), [](const T& a, const T& b) { return !(a < b) && !(b < a); }), values.end());
+
+        int red_depth = 0;
+        for (size_t count = values.size(); count > 1; count /= 2)
+            ++red_depth;
+
+        root = build_sorted(values.data(), values.size(), 0, red_depth);
+        tree_size = values.size();
+        blacken_root();
+    }
+    /// <summary>
+    ///  ,        .
+    /// </summary>
+    ~PersistentRBTree()
+    {
+        release(root);
+    }
+
+    /// <summary>
+    ///    O(1):   ,      other.
+    /// </summary>
+    PersistentRBTree& operator=(const PersistentRBTree& other)
+    {
+        PersistentRBTree copy(other);
+        swap(copy);
+        return *this;
+    }
+    /// <summary>
+    ///  .
+    /// </summary>
+    PersistentRBTree& operator=(PersistentRBTree&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release(root);
+            root = other.root;
+            tree_size = other.tree_size;
+            other.root = nullptr;
+            other.tree_size = 0;
+        }
+        return *this;
+    }
+
+    /// <summary>
+    ///      O(1).        ,  .
+    /// </summary>
+    /// <returns> ,     .</returns>
+    PersistentRBTree snapshot() const
+    {
+        return PersistentRBTree(*this);
+    }
+
+    /// <summary>
+    ///  .
+    /// </summary>
+    size_t size() const
+    {
+        return tree_size;
+    }
+    /// <summary>
+    /// ,   .
+    /// </summary>
+    bool empty() const
+    {
+        return root == nullptr;
+    }
+    /// <summary>
+    ///   ; ,    ,  .
+    /// </summary>
+    void clear()
+    {
+        release(root);
+        root = nullptr;
+        tree_size = 0;
+    }
+
+    /// <summary>
+    ///  ,     ,     .  .
+    /// </summary>
+    /// <param name="value">  .</param>
+    void insert(const T& value)
+    {
+        if (contains(value))
+            return;
+        root = insert_node(root, value);
+        blacken_root();
+        ++tree_size;
+    }
+    /// <summary>
+    ///  ,     ,     .
+    /// </summary>
+    /// <param name="value"> .</param>
+    /// <returns>true,     .</returns>
+    bool erase(const T& value)
+    {
+        if (!contains(value))
+            return false;
+        root = erase_node(root, value);
+        blacken_root();
+        --tree_size;
+        return true;
+    }
+
+    /// <summary>
+    /// ,     .
+    /// </summary>
+    bool contains(const T& value) const
+    {
+        const Node* current = root;
+        while (current)
+        {
+            if (value < current->data)
+                current = current->left;
+            else if (current->data < value)
+                current = current->right;
+            else
+                return true;
+        }
+        return false;
+    }
+    /// <summary>
+    ///  ;  end(),   .
+    /// </summary>
+    const_iterator find(const T& value) const
+    {
+        const_iterator it(root);
+        const Node* current = root;
+        while (current)
+        {
+            it.path.push_back(current);
+            if (value < current->data)
+                current = current->left;
+            else if (current->data < value)
+                current = current->right;
+            else
+                return it;
+        }
+        return end();
+    }
+    /// <summary>
+    ///    ,   value,  end().
+    /// </summary>
+    const_iterator lower_bound(const T& value) const
+    {
+        return bound(value, [](const T& node_value, const T& key) { return !(node_value < key); });
+    }
+    /// <summary>
+    ///    ,   value,  end().
+    /// </summary>
+    const_iterator upper_bound(const T& value) const
+    {
+        return bound(value, [](const T& node_value, const T& key) { return key < node_value; });
+    }
+    /// <summary>
+    ///   [lower_bound(value), upper_bound(value)).
+    /// </summary>
+    std::pair<const_iterator, const_iterator> equal_range(const T& value) const
+    {
+        return { lower_bound(value), upper_bound(value) };
+    }
+
+    const_iterator begin() const
+    {
+        const_iterator it(root);
+        it.push_leftmost(root);
+        return it;
+    }
+    const_iterator end() const
+    {
+        return const_iterator(root);
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    void swap(PersistentRBTree& other) noexcept
+    {
+        std::swap(root, other.root);
+        std::swap(tree_size, other.tree_size);
+    }
+    /// <summary>
+    ///    std::cout  .
+    /// </summary>
+    void print() const
+    {
+        for (auto it = cbegin(); it != cend(); ++it)
+            std::cout << *it << " ";
+    }
+    /// <summary>
+    ///   - , ,     .
+    /// </summary>
+    /// <returns>true,   .</returns>
+    bool validate() const
+    {
+        if (!root)
+            return tree_size == 0;
+        if (root->color != Color::BLACK)
+            return false;
+        size_t counted = 0;
+        return validate_node(root, nullptr, nullptr, counted) != 0 && counted == tree_size;
+    }
+
+    bool operator==(const PersistentRBTree& other) const
+    {
+        if (root == other.root) return true;
+        if (size() != other.size()) return false;
+        return std::equal(begin(), end(), other.begin());
+    }
+
+private:
+    static bool is_red(const Node* node)
+    {
+        return node && node->color == Color::RED;
+    }
+    static bool is_black(const Node* node)
+    {
+        return node && node->color == Color::BLACK;
+    }
+    static bool has_red_child(const Node* node)
+    {
+        return is_red(node->left) || is_red(node->right);
+    }
+    /// <summary>
+    ///    .
+    /// </summary>
+    static Node* retain(Node* node)
+    {
+        if (node)
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+    /// <summary>
+    ///    ;        .
+    /// </summary>
+    static void release(Node* node)
+    {
+        while (node && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            release(node->left);
+            Node* right = node->right;
+            delete node;
+            node = right;
+        }
+    }
+    /// <summary>
+    ///  ,    .   node   , 
+    ///   ;   ,    ,     .
+    /// </summary>
+    /// <param name="node"> ;      .</param>
+    static Node* own(Node* node)
+    {
+        if (node->refs.load(std::memory_order_acquire) == 1)
+            return node;
+        Node* copy = new Node(node->color, node->data, retain(node->left), retain(node->right));
+        release(node);
+        return copy;
+    }
+    void blacken_root()
+    {
+        if (is_red(root))
+        {
+            root = own(root);
+            root->color = Color::BLACK;
+        }
+    }
+
+    template<class Pred>
+    const_iterator bound(const T& value, Pred goes_left) const
+    {
+        const_iterator it(root);
+        size_t candidate_depth = 0;
+        const Node* current = root;
+        while (current)
+        {
+            it.path.push_back(current);
+            if (goes_left(current->data, value))
+            {
+                candidate_depth = it.path.size();
+                current = current->left;
+            }
+            else
+            {
+                current = current->right;
+            }
+        }
+        it.path.resize(candidate_depth);
+        return it;
+    }
+
+    /// <summary>
+    ///      ;    red_depth ,
+    ///    ,      .
+    /// </summary>
+    static Node* build_sorted(const T* values, size_t count, int depth, int red_depth)
+    {
+        if (count == 0) return nullptr;
+        size_t middle = count / 2;
+        Node* left = build_sorted(values, middle, depth + 1, red_depth);
+        Node* right = build_sorted(values + middle + 1, count - middle - 1, depth + 1, red_depth);
+        return new Node(depth == red_depth ? Color::RED : Color::BLACK, values[middle], left, right);
+    }
+
+    /// <summary>
+    ///    t (    ).      t     .
+    /// </summary>
+    static Node* insert_node(Node* t, const T& value)
+    {
+        if (!t)
+            return new Node(Color::RED, value);
+        t = own(t);
+        if (value < t->data)
+            t->left = insert_node(t->left, value);
+        else
+            t->right = insert_node(t->right, value);
+        return t->color == Color::BLACK ? balance(t) : t;
+    }
+    /// <summary>
+    ///   "   "   t,    .
+    ///      ;  t    .
+    /// </summary>
+    static Node* balance(Node* t)
+    {
+        Node* l = t->left;
+        Node* r = t->right;
+        if (is_red(l) && is_red(r) && (has_red_child(l) || has_red_child(r)))
+        {
+            l = t->left = own(l);
+            r = t->right = own(r);
+            l->color = Color::BLACK;
+            r->color = Color::BLACK;
+            t->color = Color::RED;
+            return t;
+        }
+        if (is_red(l) && is_red(l->left))
+        {
+            l = own(l);
+            Node* ll = l->left = own(l->left);
+            ll->color = Color::BLACK;
+            t->left = l->right;
+            t->color = Color::BLACK;
+            l->right = t;
+            l->color = Color::RED;
+            return l;
+        }
+        if (is_red(l) && is_red(l->right))
+        {
+            l = own(l);
+            Node* lr = own(l->right);
+            l->right = lr->left;
+            l->color = Color::BLACK;
+            t->left = lr->right;
+            t->color = Color::BLACK;
+            lr->left = l;
+            lr->right = t;
+            lr->color = Color::RED;
+            return lr;
+        }
+        if (is_red(r) && is_red(r->right))
+        {
+            r = own(r);
+            Node* rr = r->right = own(r->right);
+            rr->color = Color::BLACK;
+            t->right = r->left;
+            t->color = Color::BLACK;
+            r->left = t;
+            r->color = Color::RED;
+            return r;
+        }
+        if (is_red(r) && is_red(r->left))
+        {
+            r = own(r);
+            Node* rl = own(r->left);
+            r->left = rl->right;
+            r->color = Color::BLACK;
+            t->right = rl->left;
+            t->color = Color::BLACK;
+            rl->left = t;
+            rl->right = r;
+            rl->color = Color::RED;
+            return rl;
+        }
+        t->color = Color::BLACK;
+        return t;
+    }
+
+    /// <summary>
+    ///   (    )   t.      ,
+    ///      ,    bal_left/bal_right  .
+    /// </summary>
+    static Node* erase_node(Node* t, const T& value)
+    {
+        t = own(t);
+        if (value < t->data)
+        {
+            bool black_left = is_black(t->left);
+            t->left = erase_node(t->left, value);
+            if (black_left)
+                return bal_left(t);
+            t->color = Color::RED;
+            return t;
+        }
+        if (t->data < value)
+        {
+            bool black_right = is_black(t->right);
+            t->right = erase_node(t->right, value);
+            if (black_right)
+                return bal_right(t);
+            t->color = Color::RED;
+            return t;
+        }
+        Node* result = fuse(t->left, t->right);
+        t->left = t->right = nullptr;
+        delete t;
+        return result;
+    }
+    /// <summary>
+    ///    t,          .
+    /// </summary>
+    static Node* bal_left(Node* t)
+    {
+        if (is_red(t->left))
+        {
+            Node* l = t->left = own(t->left);
+            l->color = Color::BLACK;
+            t->color = Color::RED;
+            return t;
+        }
+        if (is_black(t->right))
+        {
+            Node* r = t->right = own(t->right);
+            r->color = Color::RED;
+            return balance(t);
+        }
+        Node* r = own(t->right);
+        Node* rl = own(r->left);
+        t->right = rl->left;
+        t->color = Color::BLACK;
+        r->left = rl->right;
+        Node* c = r->right = own(r->right);
+        c->color = Color::RED;
+        rl->left = t;
+        rl->right = balance(r);
+        rl->color = Color::RED;
+        return rl;
+    }
+    /// <summary>
+    ///    t,          .
+    /// </summary>
+    static Node* bal_right(Node* t)
+    {
+        if (is_red(t->right))
+        {
+            Node* r = t->right = own(t->right);
+            r->color = Color::BLACK;
+            t->color = Color::RED;
+            return t;
+        }
+        if (is_black(t->left))
+        {
+            Node* l = t->left = own(t->left);
+            l->color = Color::RED;
+            return balance(t);
+        }
+        Node* l = own(t->left);
+        Node* lr = own(l->right);
+        t->left = lr->right;
+        t->color = Color::BLACK;
+        l->right = lr->left;
+        Node* a = l->left = own(l->left);
+        a->color = Color::RED;
+        lr->left = balance(l);
+        lr->right = t;
+        lr->color = Color::RED;
+        return lr;
+    }
+    /// <summary>
+    ///      ,    a   b,    .
+    /// </summary>
+    static Node* fuse(Node* a, Node* b)
+    {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->color == Color::BLACK && b->color == Color::RED)
+        {
+            b = own(b);
+            b->left = fuse(a, b->left);
+            return b;
+        }
+        if (a->color == Color::RED && b->color == Color::BLACK)
+        {
+            a = own(a);
+            a->right = fuse(a->right, b);
+            return a;
+        }
+        a = own(a);
+        b = own(b);
+        Node* middle = fuse(a->right, b->left);
+        if (is_red(middle))
+        {
+            middle = own(middle);
+            a->right = middle->left;
+            b->left = middle->right;
+            middle->left = a;
+            middle->right = b;
+            return middle;
+        }
+        b->left = middle;
+        a->right = b;
+        return a->color == Color::RED ? a : bal_left(a);
+    }
+
+    /// <summary>
+    ///  ;     (    1)  0  .
+    /// </summary>
+    int validate_node(const Node* node, const T* min, const T* max, size_t& counted) const
+    {
+        if (!node) return 1;
+        if (node->refs.load(std::memory_order_relaxed) == 0)
+            return 0;
+        if ((min && !(*min < node->data)) || (max && !(node->data < *max)))
+            return 0;
+        if (node->color == Color::RED && has_red_child(node))
+            return 0;
+        ++counted;
+        int l = validate_node(node->left, min, &node->data, counted);
+        int r = validate_node(node->right, &node->data, max, counted);
+        if (l == 0 || r == 0 || l != r) return 0;
+        return l + (node->color == Color::BLACK ? 1 : 0);
+    }
+};
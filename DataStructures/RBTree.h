@@ -1,8 +1,19 @@
 #pragma once
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <utility>
+#include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "ForkJoinPool.h"
+#include "FrozenSet.h"
+#include "SortedArrayFile.h"
 
 /// <summary>
 /// ,   .
@@ -26,17 +37,14 @@ struct NodeRBT
 	NodeRBT* parent;
 
 	NodeRBT(const T& value) : data(value), left(nullptr), right(nullptr), parent(nullptr), color(Color::RED) {}
-    ~NodeRBT()
-    {
-		left = nullptr;
-		right = nullptr;
-		parent = nullptr;
-		delete left;
-		delete right;
-		delete parent;
-    }
 };
 
+/// <summary>
+///   ,   ;   MappedSortedArray.h,     open_mmap.
+/// </summary>
+template<class T>
+class MappedSortedArray;
+
 /// <summary>
 ///   -  - .
 /// </summary>
@@ -46,7 +54,11 @@ class RBTree
 {
 private:
     NodeRBT<T>* root;
-    size_t tree_size;
+    /// <summary>
+    ///    unknown_size,      ( split);     size().
+    /// </summary>
+    mutable size_t tree_size;
+    static constexpr size_t unknown_size = static_cast<size_t>(-1);
 
     /// <summary>
 	///       - .
@@ -218,6 +230,53 @@ public:
         }
     };
     /// <summary>
+    /// ,     extract().     ,       
+    ///  ; insert(node_type&amp;&amp;)          .
+    /// </summary>
+    class node_type
+    {
+        friend class RBTree;
+    private:
+        NodeRBT<T>* node_ = nullptr;
+
+        explicit node_type(NodeRBT<T>* node) : node_(node) {}
+    public:
+        node_type() = default;
+        node_type(node_type&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+        node_type& operator=(node_type&& other) noexcept
+        {
+            if (this != &other)
+            {
+                delete node_;
+                node_ = std::exchange(other.node_, nullptr);
+            }
+            return *this;
+        }
+        ~node_type()
+        {
+            delete node_;
+        }
+
+        /// <summary>
+        /// ,  handle   .
+        /// </summary>
+        bool empty() const
+        {
+            return node_ == nullptr;
+        }
+        explicit operator bool() const
+        {
+            return node_ != nullptr;
+        }
+        /// <summary>
+        ///  .    ,   ,      .
+        /// </summary>
+        T& value() const
+        {
+            return node_->data;
+        }
+    };
+    /// <summary>
     ///     RBTree.   .
     /// </summary>
     RBTree() : root(nullptr), tree_size(0) {}
@@ -271,9 +330,20 @@ public:
     /// <summary>
     ///      ( ).
     /// </summary>
-    /// <returns>  (size_t) -    tree_size.</returns>
+    /// <returns>  (size_t).</returns>
+    /// <remarks>
+    ///  split          ,  .
+    ///     ,        .
+    /// </remarks>
     size_t size() const
     {
+        if (tree_size == unknown_size)
+        {
+            size_t count = 0;
+            for (auto it = cbegin(); it != cend(); ++it)
+                ++count;
+            tree_size = count;
+        }
         return tree_size;
     }
 
@@ -287,15 +357,32 @@ public:
     }
 
     /// <summary>
-    ///           ( ).
+    ///         ( )      :
+    ///       ,   ,       .
+    ///         ,       2n.
     /// </summary>
     /// <param name="node">   (  ) ,   .</param>
+    /// <remarks>
+    ///  parent  :   .  T  , NodeRBT 
+    ///  ,  delete       .
+    /// </remarks>
     void clear(NodeRBT<T>* node)
     {
-        if (!node) return;
-        clear(node->left);
-        clear(node->right);
-        delete node;
+        while (node)
+        {
+            if (NodeRBT<T>* left = node->left)
+            {
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            }
+            else
+            {
+                NodeRBT<T>* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
     }
     /// <summary>
     ///   :   ,  root  nullptr     0.
@@ -326,11 +413,11 @@ public:
         NodeRBT<T>* new_node = new NodeRBT<T>(value);
         if (!bst_insert(new_node))
         {
-            //delete new_node;
+            delete new_node;
             return;
         }
         insert_fixup(new_node);
-        tree_size++;
+        grow_size(1);
     }
     /// <summary>
     ///       ,   ,  ,  
@@ -343,7 +430,7 @@ public:
         if (!delete_node) return false;
 
         erase_node(delete_node);
-        tree_size--;
+        shrink_size(1);
         return true;
     }
 
@@ -436,6 +523,26 @@ public:
         }
         return end();
     }
+    /// <summary>
+    ///   :   hint   ,     value,
+    ///    .     hint      hint,     .
+    /// </summary>
+    /// <param name="hint">    ; end()     .</param>
+    /// <param name="value">  .</param>
+    /// <returns>     end().</returns>
+    iterator find(const_iterator hint, const T& value)
+    {
+        NodeRBT<T>* node = find_from(hint.node, value);
+        return node ? iterator(node, root) : end();
+    }
+    /// <summary>
+    ///     .
+    /// </summary>
+    const_iterator find(const_iterator hint, const T& value) const
+    {
+        NodeRBT<T>* node = find_from(hint.node, value);
+        return node ? const_iterator(node, root) : cend();
+    }
 
     /// <summary>
     ///    ? :          true,           false.
@@ -452,11 +559,46 @@ public:
         }
 
         insert_fixup(node);
-        ++tree_size;
+        grow_size(1);
 
         return { iterator(node, root), true };
     }
     /// <summary>
+    ///   :       hint (    ),
+    ///      ,       hint,  
+    ///   .    ,      ,
+    ///     O(1).
+    /// </summary>
+    /// <param name="hint">    .  end()      O(log n).</param>
+    /// <param name="value">  .</param>
+    /// <returns>         .</returns>
+    iterator insert(const_iterator hint, const T& value)
+    {
+        NodeRBT<T>* node = hint.node;
+        if (!root)
+            return attach(nullptr, false, value);
+        if (!node)
+            node = maximum(root);
+
+        if (value < node->data)
+        {
+            const_iterator before(node, root);
+            NodeRBT<T>* prev = (--before).node;
+            if (!prev || prev->data < value)
+                return node->left ? attach(prev, false, value) : attach(node, true, value);
+            return insert_from(finger_start(node, value), value);
+        }
+        if (node->data < value)
+        {
+            const_iterator after(node, root);
+            NodeRBT<T>* next = (++after).node;
+            if (!next || value < next->data)
+                return node->right ? attach(next, true, value) : attach(node, false, value);
+            return insert_from(finger_start(node, value), value);
+        }
+        return iterator(node, root);
+    }
+    /// <summary>
     ///  ,    
     /// </summary>
     /// <param name="it">   .  it  end(),   .</param>
@@ -470,10 +612,60 @@ public:
         ++next;
 
         erase_node(it.node);
-        --tree_size;
+        shrink_size(1);
 
         return next;
     }
+    /// <summary>
+    ///       ,   .
+    /// </summary>
+    /// <param name="value">  .</param>
+    /// <returns>node_type,  ,   node_type,     .</returns>
+    node_type extract(const T& value)
+    {
+        NodeRBT<T>* node = find_node(value);
+        if (!node)
+            return node_type();
+
+        unlink_node(node);
+        shrink_size(1);
+        return node_type(node);
+    }
+    /// <summary>
+    ///    ,    ,   .
+    /// </summary>
+    /// <param name="it">   .  end()   node_type.</param>
+    node_type extract(const_iterator it)
+    {
+        if (!it.node)
+            return node_type();
+
+        unlink_node(it.node);
+        shrink_size(1);
+        return node_type(it.node);
+    }
+    /// <summary>
+    ///     (    )      .
+    /// </summary>
+    /// <param name="handle">,   extract().     .</param>
+    /// <returns>std::pair&lt;iterator, bool&gt;            .
+    ///     ,     handle.   handle  {end(), false}.</returns>
+    std::pair<iterator, bool> insert(node_type&& handle)
+    {
+        NodeRBT<T>* node = handle.node_;
+        if (!node)
+            return { end(), false };
+
+        node->left = node->right = node->parent = nullptr;
+        node->color = Color::RED;
+        if (!bst_insert(node))
+            return { find(node->data), false };
+
+        handle.node_ = nullptr;
+        insert_fixup(node);
+        grow_size(1);
+        return { iterator(node, root), true };
+    }
 
     /// <summary>
     ///  ,    ()  .
@@ -594,6 +786,367 @@ public:
         };
     }
 
+    /// <summary>
+    ///       [lo, hi]     fn.  in-order   :
+    ///    lo   hi  ,       
+    ///    ,    .
+    /// </summary>
+    /// <param name="lo">   ().</param>
+    /// <param name="hi">   ().</param>
+    /// <param name="fn"> fn(const T&amp;).    bool,  false  .</param>
+    /// <returns> ,   fn.</returns>
+    template<class F>
+    size_t for_each_in_range(const T& lo, const T& hi, F&& fn) const
+    {
+        //  -    2 * log2(n + 1),    128     size_t.
+        NodeRBT<T>* stack[2 * std::numeric_limits<size_t>::digits];
+        size_t top = 0;
+        size_t visited = 0;
+
+        NodeRBT<T>* current = root;
+        while (current)
+        {
+            if (current->data < lo)
+            {
+                current = current->right;
+            }
+            else
+            {
+                stack[top++] = current;
+                current = current->left;
+            }
+        }
+
+        while (top)
+        {
+            NodeRBT<T>* node = stack[--top];
+            if (hi < node->data)
+                break;
+            ++visited;
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, const T&>, bool>)
+            {
+                if (!fn(static_cast<const T&>(node->data)))
+                    break;
+            }
+            else
+            {
+                fn(static_cast<const T&>(node->data));
+            }
+
+            for (current = node->right; current; current = current->left)
+                stack[top++] = current;
+        }
+        return visited;
+    }
+    /// <summary>
+    ///     [lo, hi].     ,    O(log n + k),
+    ///  k  ,      ,   for_each_in_range.
+    /// </summary>
+    size_t count_in_range(const T& lo, const T& hi) const
+    {
+        return for_each_in_range(lo, hi, [](const T&) {});
+    }
+
+    /// <summary>
+    ///       :   key     key.     ,    .
+    /// </summary>
+    /// <param name="key"> .</param>
+    /// <returns>std::pair<RBTree, RBTree>       key,      key.</returns>
+    /// <remarks>
+    ///   O(log n):     ,      ,
+    ///      size()   .
+    /// </remarks>
+    std::pair<RBTree, RBTree> split(const T& key)
+    {
+        std::pair<RBTree, RBTree> parts;
+        NodeRBT<T>* found = nullptr;
+        int left_bh = 0;
+        int right_bh = 0;
+
+        split_nodes(root, black_height(root), key, parts.first.root, left_bh, found, parts.second.root, right_bh);
+        if (found)
+            parts.second.root = join_nodes(nullptr, 0, found, parts.second.root, right_bh, right_bh);
+
+        parts.first.blacken_root();
+        parts.second.blacken_root();
+        parts.first.tree_size = parts.first.root ? unknown_size : 0;
+        parts.second.tree_size = parts.second.root ? unknown_size : 0;
+
+        root = nullptr;
+        tree_size = 0;
+        return parts;
+    }
+    /// <summary>
+    ///           O(log n).   left    key,   right   key.
+    /// </summary>
+    /// <param name="left">    key.   .</param>
+    /// <param name="key"> ,    .</param>
+    /// <param name="right">    key.   .</param>
+    /// <returns>,   left, key  right.</returns>
+    static RBTree join(RBTree& left, const T& key, RBTree& right)
+    {
+        NodeRBT<T>* left_max = left.maximum(left.root);
+        NodeRBT<T>* right_min = right.minimum(right.root);
+        if ((left_max && !(left_max->data < key)) || (right_min && !(key < right_min->data)))
+            throw std::invalid_argument("RBTree::join: keys are not ordered");
+
+        RBTree result;
+        int bh = 0;
+        result.root = result.join_nodes(left.root, black_height(left.root), new NodeRBT<T>(key),
+            right.root, black_height(right.root), bh);
+        result.blacken_root();
+        result.tree_size = (left.tree_size == unknown_size || right.tree_size == unknown_size)
+            ? unknown_size : left.tree_size + right.tree_size + 1;
+
+        left.root = right.root = nullptr;
+        left.tree_size = right.tree_size = 0;
+        return result;
+    }
+    /// <summary>
+    ///  :       other,     .     split/join  O(m log(n/m + 1)).
+    /// </summary>
+    /// <param name="other"> .      ,   other .</param>
+    /// <param name="threads"> ;    1      
+    /// ForkJoinPool,       .</param>
+    void union_with(RBTree& other, size_t threads = 1)
+    {
+        with_pool(threads, [&](ForkJoinPool* pool) { union_in_pool(other, pool); });
+    }
+    /// <summary>
+    ///      :         .
+    /// </summary>
+    /// <param name="pool">,   ;       .</param>
+    void union_with(RBTree& other, ForkJoinPool& pool)
+    {
+        union_in_pool(other, &pool);
+    }
+    /// <summary>
+    ///  :      ,   other.     split/join  O(m log(n/m + 1)).
+    /// </summary>
+    /// <param name="other"> .   other .</param>
+    /// <param name="threads"> ;    1      
+    /// ForkJoinPool,       .</param>
+    void intersect(RBTree& other, size_t threads = 1)
+    {
+        with_pool(threads, [&](ForkJoinPool* pool) { intersect_in_pool(other, pool); });
+    }
+    /// <summary>
+    ///      .
+    /// </summary>
+    /// <param name="pool">,   .</param>
+    void intersect(RBTree& other, ForkJoinPool& pool)
+    {
+        intersect_in_pool(other, &pool);
+    }
+    /// <summary>
+    ///  :      ,   other.     split/join  O(m log(n/m + 1)).
+    /// </summary>
+    /// <param name="other"> .   other .</param>
+    /// <param name="threads"> ;    1      
+    /// ForkJoinPool,       .</param>
+    void difference(RBTree& other, size_t threads = 1)
+    {
+        with_pool(threads, [&](ForkJoinPool* pool) { difference_in_pool(other, pool); });
+    }
+    /// <summary>
+    ///      .
+    /// </summary>
+    /// <param name="pool">,   .</param>
+    void difference(RBTree& other, ForkJoinPool& pool)
+    {
+        difference_in_pool(other, &pool);
+    }
+
+    /// <summary>
+    ///    :  ,       O(m),
+    ///       union.     .
+    /// </summary>
+    /// <typeparam name="It"> ,   InputIterator.</typeparam>
+    /// <param name="first">    ().</param>
+    /// <param name="last">    ( ).</param>
+    /// <param name="threads">   ,   .</param>
+    template<class It>
+    void insert_bulk(It first, It last, size_t threads = 1)
+    {
+        with_pool(threads, [&](ForkJoinPool* pool) { insert_bulk_in_pool(first, last, pool); });
+    }
+    /// <summary>
+    ///        .
+    /// </summary>
+    /// <param name="pool">,   .</param>
+    template<class It>
+    void insert_bulk(It first, It last, ForkJoinPool& pool)
+    {
+        insert_bulk_in_pool(first, last, &pool);
+    }
+
+    /// <summary>
+    ///           .   .
+    /// </summary>
+    /// <returns>FrozenSet    .</returns>
+    FrozenSet<T> freeze() const
+    {
+        return FrozenSet<T>(cbegin(), cend());
+    }
+
+    /// <summary>
+    ///       .   T   
+    /// (zigzag-varint)      (varint),     T 
+    ///   .
+    /// </summary>
+    /// <param name="out">,    .</param>
+    /// <exception cref="std::runtime_error">   .</exception>
+    void serialize(std::ostream& out) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "RBTree::serialize requires a trivially copyable element type");
+
+        std::string buffer(serial_magic, sizeof(serial_magic));
+        buffer.push_back(static_cast<char>(delta_encoded ? SerialEncoding::delta_varint : SerialEncoding::raw));
+        put_varint(buffer, sizeof(T));
+        put_varint(buffer, size());
+
+        uint64_t previous = 0;
+        bool first = true;
+        for (const T& value : *this)
+        {
+            if constexpr (delta_encoded)
+            {
+                uint64_t current = static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+                if (first)
+                {
+                    int64_t signed_value = static_cast<int64_t>(value);
+                    put_varint(buffer, (static_cast<uint64_t>(signed_value) << 1) ^ static_cast<uint64_t>(signed_value >> 63));
+                }
+                else
+                {
+                    put_varint(buffer, static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(current - previous)));
+                }
+                previous = current;
+                first = false;
+            }
+            else
+            {
+                buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            if (buffer.size() >= serial_chunk_size)
+            {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+        if (!out)
+            throw std::runtime_error("RBTree::serialize: write failed");
+    }
+    /// <summary>
+    ///  ,  serialize().   ,     O(n)
+    ///   ,    insert_bulk,      .
+    /// </summary>
+    /// <param name="in">,    .</param>
+    /// <returns> .</returns>
+    /// <exception cref="std::runtime_error"> ,        .</exception>
+    static RBTree deserialize(std::istream& in)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "RBTree::deserialize requires a trivially copyable element type");
+
+        std::streambuf* source = in.rdbuf();
+        char magic[sizeof(serial_magic)];
+        if (!source || source->sgetn(magic, sizeof(magic)) != static_cast<std::streamsize>(sizeof(magic)) ||
+            std::memcmp(magic, serial_magic, sizeof(magic)) != 0)
+            throw std::runtime_error("RBTree::deserialize: not a serialized tree");
+
+        int encoding = source->sbumpc();
+        SerialEncoding expected = delta_encoded ? SerialEncoding::delta_varint : SerialEncoding::raw;
+        if (encoding != static_cast<int>(expected) || get_varint(*source) != sizeof(T))
+            throw std::runtime_error("RBTree::deserialize: stream was written for another element type");
+
+        uint64_t count = get_varint(*source);
+        std::vector<T> values;
+        values.reserve(static_cast<size_t>(std::min<uint64_t>(count, serial_chunk_size)));
+
+        uint64_t previous = 0;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            T value;
+            if constexpr (delta_encoded)
+            {
+                uint64_t encoded = get_varint(*source);
+                uint64_t current;
+                if (i == 0)
+                {
+                    current = static_cast<uint64_t>(static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1));
+                }
+                else
+                {
+                    current = previous + encoded;
+                }
+                value = static_cast<T>(static_cast<std::make_unsigned_t<T>>(current));
+                previous = current;
+            }
+            else
+            {
+                if (source->sgetn(reinterpret_cast<char*>(&value), sizeof(T)) != static_cast<std::streamsize>(sizeof(T)))
+                    throw std::runtime_error("RBTree::deserialize: unexpected end of stream");
+            }
+
+            if (!values.empty() && !(values.back() < value))
+                throw std::runtime_error("RBTree::deserialize: elements are not strictly increasing");
+            values.push_back(value);
+        }
+
+        RBTree result;
+        result.root = build_sorted(values.data(), values.size());
+        result.tree_size = values.size();
+        return result;
+    }
+    /// <summary>
+    ///          (SortedArrayFileHeader),
+    ///  open_mmap        .
+    /// </summary>
+    /// <param name="path">  ;   .</param>
+    /// <exception cref="std::runtime_error"> .</exception>
+    void save(const std::string& path) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "RBTree::save requires a trivially copyable element type");
+
+        SortedArrayFileHeader header{};
+        std::memcpy(header.magic, SortedArrayFileHeader::expected_magic, sizeof(header.magic));
+        header.byte_order = SortedArrayFileHeader::byte_order_mark;
+        header.element_size = sizeof(T);
+        header.count = size();
+        header.data_offset = (sizeof(SortedArrayFileHeader) + 63) / 64 * 64;
+        header.file_size = header.data_offset + header.count * sizeof(T);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("RBTree::save: cannot open " + path);
+
+        std::string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+        buffer.resize(header.data_offset, '\0');
+        for (const T& value : *this)
+        {
+            buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            if (buffer.size() >= serial_chunk_size)
+            {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+        if (!out.flush())
+            throw std::runtime_error("RBTree::save: cannot write " + path);
+    }
+    /// <summary>
+    ///  ,  save(),       .
+    /// </summary>
+    /// <exception cref="std::runtime_error">       .</exception>
+    /// <remarks> MappedSortedArray.h:        .</remarks>
+    static MappedSortedArray<T> open_mmap(const std::string& path)
+    {
+        return MappedSortedArray<T>(path);
+    }
+
     /// <summary>
 	///        :      .
     /// </summary>
@@ -823,11 +1376,91 @@ private:
         x->parent = y;
     }
 
+    /// <summary>
+    ///   node,          value:
+    ///  value  node    ,          value;
+    ///  value  node  .
+    /// </summary>
+    NodeRBT<T>* finger_start(NodeRBT<T>* node, const T& value) const
+    {
+        bool greater = node->data < value;
+        while (node->parent)
+        {
+            NodeRBT<T>* parent = node->parent;
+            if (greater ? (node == parent->left && value < parent->data) : (node == parent->right && parent->data < value))
+                return node;
+            node = parent;
+        }
+        return node;
+    }
+    /// <summary>
+    ///     value,   ,  finger_start  hint (  ,  hint ).
+    /// </summary>
+    NodeRBT<T>* find_from(NodeRBT<T>* hint, const T& value) const
+    {
+        if (hint && hint->data == value)
+            return hint;
+        NodeRBT<T>* current = hint ? finger_start(hint, value) : root;
+        while (current)
+        {
+            if (value < current->data)
+                current = current->left;
+            else if (current->data < value)
+                current = current->right;
+            else
+                return current;
+        }
+        return nullptr;
+    }
+    /// <summary>
+    ///    start (    value).
+    /// </summary>
+    iterator insert_from(NodeRBT<T>* start, const T& value)
+    {
+        NodeRBT<T>* parent = nullptr;
+        bool left = false;
+        for (NodeRBT<T>* current = start; current;)
+        {
+            parent = current;
+            if (value < current->data)
+            {
+                current = current->left;
+                left = true;
+            }
+            else if (current->data < value)
+            {
+                current = current->right;
+                left = false;
+            }
+            else
+                return iterator(current, root);
+        }
+        return attach(parent, left, value);
+    }
+    /// <summary>
+    ///      value     parent ( ,  parent ),
+    ///   -    .
+    /// </summary>
+    iterator attach(NodeRBT<T>* parent, bool as_left, const T& value)
+    {
+        NodeRBT<T>* node = new NodeRBT<T>(value);
+        node->parent = parent;
+        if (!parent)
+            root = node;
+        else if (as_left)
+            parent->left = node;
+        else
+            parent->right = node;
+
+        insert_fixup(node);
+        grow_size(1);
+        return iterator(node, root);
+    }
     /// <summary>
     ///          .
     /// </summary>
     /// <param name="new_node">  .</param>
-    /// <returns> true     ; false        . </returns>
+    /// <returns> true     ; false         (    ). </returns>
     /// <remarks>
     ///       - .
     ///   .
@@ -854,7 +1487,6 @@ private:
             }
             else if (new_node->data == current->data)
             {
-                delete new_node;
 				return false;
             }
             else
@@ -927,13 +1559,23 @@ private:
     }
 
     /// <summary>
-    ///     - .
+    ///     -     .
     /// </summary>
     /// <param name="z">  .</param>
+    void erase_node(NodeRBT<T>* z)
+    {
+        unlink_node(z);
+        delete z;
+    }
+    /// <summary>
+    ///    - ,   .
+    /// </summary>
+    /// <param name="z">  .</param>
     /// <remarks>
-    ///          .
+    ///         .
+    ///  left, right  parent         .
     /// </remarks>
-    void erase_node(NodeRBT<T>* z)
+    void unlink_node(NodeRBT<T>* z)
     {
         NodeRBT<T>* x = nullptr;
         NodeRBT<T>* x_parent = nullptr;
@@ -945,14 +1587,12 @@ private:
             x = nullptr;
             x_parent = z->parent;
             transplant(z, nullptr);
-            delete z;
         }
         else if (!z->left || !z->right)
         {
             x = z->left ? z->left : z->right;
             transplant(z, x);
             x_parent = x->parent;
-            delete z;
         }
         else
         {
@@ -979,7 +1619,6 @@ private:
             y->left->parent = y;
             y->color = z->color;
 
-            delete z;
         }
         
         if (removed_color == Color::BLACK)
@@ -1095,6 +1734,635 @@ private:
         return nullptr;
     }
     /// <summary>
+    ///     (  2^8 - 1 ),         .
+    /// </summary>
+    static constexpr int parallel_cutoff_bh = 8;
+    /// <summary>
+    ///   ,         .
+    /// </summary>
+    static constexpr size_t parallel_cutoff_size = 1 << 13;
+
+    /// <summary>
+    ///   ;       size().
+    /// </summary>
+    void grow_size(size_t count)
+    {
+        if (tree_size != unknown_size)
+            tree_size += count;
+    }
+    void shrink_size(size_t count)
+    {
+        if (tree_size != unknown_size)
+            tree_size -= count;
+    }
+    /// <summary>
+    ///    ; pool  nullptr   .
+    /// </summary>
+    void union_in_pool(RBTree& other, ForkJoinPool* pool)
+    {
+        if (this == &other) return;
+
+        size_t duplicates = 0;
+        int bh = 0;
+        bool known = tree_size != unknown_size && other.tree_size != unknown_size;
+        size_t total = tree_size + other.tree_size;
+        root = union_nodes(root, black_height(root), other.root, black_height(other.root), bh, duplicates, pool);
+        blacken_root();
+        tree_size = known ? total - duplicates : unknown_size;
+
+        other.root = nullptr;
+        other.tree_size = 0;
+    }
+    void intersect_in_pool(RBTree& other, ForkJoinPool* pool)
+    {
+        if (this == &other) return;
+
+        size_t kept = 0;
+        int bh = 0;
+        root = intersect_nodes(root, black_height(root), other.root, black_height(other.root), bh, kept, pool);
+        blacken_root();
+        tree_size = kept;
+
+        other.root = nullptr;
+        other.tree_size = 0;
+    }
+    void difference_in_pool(RBTree& other, ForkJoinPool* pool)
+    {
+        if (this == &other)
+        {
+            clear();
+            return;
+        }
+
+        size_t removed = 0;
+        int bh = 0;
+        root = difference_nodes(root, black_height(root), other.root, black_height(other.root), bh, removed, pool);
+        blacken_root();
+        shrink_size(removed);
+
+        other.root = nullptr;
+        other.tree_size = 0;
+    }
+    template<class It>
+    void insert_bulk_in_pool(It first, It last, ForkJoinPool* pool)
+    {
+        std::vector<T> values(first, last);
+        if (values.empty()) return;
+
+        sort_values(values.data(), values.size(), pool);
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        int red_depth = 0;
+        for (size_t count = values.size(); count > 1; count /= 2)
+            ++red_depth;
+
+        NodeRBT<T>* built = build_sorted(values.data(), values.size(), 0, red_depth, pool);
+        size_t duplicates = 0;
+        int bh = 0;
+        root = union_nodes(root, black_height(root), built, black_height(built), bh, duplicates, pool);
+        grow_size(values.size() - duplicates);
+        blacken_root();
+    }
+    /// <summary>
+    ///  action   ,  threads  1,   nullptr ( )   .
+    /// </summary>
+    template<class Action>
+    static void with_pool(size_t threads, Action&& action)
+    {
+        if (threads > 1)
+        {
+            ForkJoinPool pool(threads);
+            action(&pool);
+        }
+        else
+        {
+            action(nullptr);
+        }
+    }
+    /// <summary>
+    ///     : ,       ,  .
+    /// </summary>
+    template<class F1, class F2>
+    static void fork(ForkJoinPool* pool, bool large, F1&& first, F2&& second)
+    {
+        if (pool && large)
+        {
+            pool->invoke(first, second);
+        }
+        else
+        {
+            first();
+            second();
+        }
+    }
+    /// <summary>
+    ///        .
+    /// </summary>
+    static void sort_values(T* values, size_t count, ForkJoinPool* pool)
+    {
+        if (!pool || count < parallel_cutoff_size)
+        {
+            std::sort(values, values + count);
+            return;
+        }
+
+        size_t mid = count / 2;
+        pool->invoke(
+            [&] { sort_values(values, mid, pool); },
+            [&] { sort_values(values + mid, count - mid, pool); });
+        std::inplace_merge(values, values + mid, values + count);
+    }
+    /// <summary>
+    ///     serialize():         .
+    /// </summary>
+    enum class SerialEncoding : char
+    {
+        raw = 0,
+        delta_varint = 1
+    };
+    static constexpr char serial_magic[4] = { 'R', 'B', 'T', '1' };
+    static constexpr bool delta_encoded = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(uint64_t);
+    static constexpr size_t serial_chunk_size = 1 << 16;
+
+    /// <summary>
+    ///     varint:  7   ,    .
+    /// </summary>
+    static void put_varint(std::string& buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+    /// <summary>
+    ///     varint.
+    /// </summary>
+    /// <exception cref="std::runtime_error">     64 .</exception>
+    static uint64_t get_varint(std::streambuf& source)
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = source.sbumpc();
+            if (byte == std::char_traits<char>::eof())
+                throw std::runtime_error("RBTree::deserialize: unexpected end of stream");
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        throw std::runtime_error("RBTree::deserialize: malformed varint");
+    }
+    /// <summary>
+    ///           .
+    /// </summary>
+    static NodeRBT<T>* build_sorted(const T* values, size_t count)
+    {
+        int red_depth = 0;
+        for (size_t remaining = count; remaining > 1; remaining /= 2)
+            ++red_depth;
+        return build_sorted(values, count, 0, red_depth, nullptr);
+    }
+    /// <summary>
+    ///   -      .
+    /// </summary>
+    /// <param name="values">    .</param>
+    /// <param name="count">  .</param>
+    /// <param name="depth">  .</param>
+    /// <param name="red_depth">   ( ) ;     .</param>
+    /// <param name="pool">   nullptr.</param>
+    /// <returns>  .</returns>
+    /// <remarks>
+    ///    ,          ,
+    ///            .
+    /// </remarks>
+    static NodeRBT<T>* build_sorted(const T* values, size_t count, int depth, int red_depth, ForkJoinPool* pool)
+    {
+        if (count == 0) return nullptr;
+
+        size_t mid = count / 2;
+        NodeRBT<T>* node = new NodeRBT<T>(values[mid]);
+        node->color = (depth == red_depth && depth > 0) ? Color::RED : Color::BLACK;
+
+        NodeRBT<T>* l = nullptr;
+        NodeRBT<T>* r = nullptr;
+        fork(pool, count >= parallel_cutoff_size,
+            [&] { l = build_sorted(values, mid, depth + 1, red_depth, pool); },
+            [&] { r = build_sorted(values + mid + 1, count - mid - 1, depth + 1, red_depth, pool); });
+
+        attach_left(node, l);
+        attach_right(node, r);
+        return node;
+    }
+    /// <summary>
+    ///       :       node   (    0).
+    /// </summary>
+    /// <param name="node"> .</param>
+    /// <returns>׸  .</returns>
+    static int black_height(NodeRBT<T>* node)
+    {
+        int bh = 0;
+        for (; node; node = node->left)
+        {
+            if (node->color == Color::BLACK)
+                ++bh;
+        }
+        return bh;
+    }
+    /// <summary>
+    /// ׸    node      .
+    /// </summary>
+    static int child_black_height(NodeRBT<T>* node, int bh)
+    {
+        return node->color == Color::BLACK ? bh - 1 : bh;
+    }
+    /// <summary>
+    ///     ,     .
+    /// </summary>
+    static Color color_of(NodeRBT<T>* node)
+    {
+        return node ? node->color : Color::BLACK;
+    }
+    /// <summary>
+    ///        .
+    /// </summary>
+    static NodeRBT<T>* detach(NodeRBT<T>* node)
+    {
+        if (node) node->parent = nullptr;
+        return node;
+    }
+    /// <summary>
+    ///  child   parent    .
+    /// </summary>
+    static void attach_left(NodeRBT<T>* parent, NodeRBT<T>* child)
+    {
+        parent->left = child;
+        if (child) child->parent = parent;
+    }
+    /// <summary>
+    ///  child   parent    .
+    /// </summary>
+    static void attach_right(NodeRBT<T>* parent, NodeRBT<T>* child)
+    {
+        parent->right = child;
+        if (child) child->parent = parent;
+    }
+    /// <summary>
+    ///           .      .
+    /// </summary>
+    void blacken_root()
+    {
+        if (!root) return;
+        root->parent = nullptr;
+        root->color = Color::BLACK;
+    }
+    /// <summary>
+    ///    :    left_rotate   root,     .
+    /// </summary>
+    static NodeRBT<T>* rotate_left_subtree(NodeRBT<T>* x)
+    {
+        NodeRBT<T>* y = x->right;
+        attach_right(x, y->left);
+        y->parent = x->parent;
+        attach_left(y, x);
+        return y;
+    }
+    /// <summary>
+    ///    :    .
+    /// </summary>
+    static NodeRBT<T>* rotate_right_subtree(NodeRBT<T>* x)
+    {
+        NodeRBT<T>* y = x->left;
+        attach_left(x, y->right);
+        y->parent = x->parent;
+        attach_right(y, x);
+        return y;
+    }
+    /// <summary>
+    ///     l       r       k   (, r).
+    /// </summary>
+    /// <remarks>
+    ///              join_nodes.
+    /// </remarks>
+    static NodeRBT<T>* join_right(NodeRBT<T>* l, int l_bh, NodeRBT<T>* k, NodeRBT<T>* r, int r_bh)
+    {
+        if (color_of(l) == Color::BLACK && l_bh == r_bh)
+        {
+            k->color = Color::RED;
+            attach_left(k, l);
+            attach_right(k, r);
+            return k;
+        }
+
+        NodeRBT<T>* joined = join_right(l->right, child_black_height(l, l_bh), k, r, r_bh);
+        attach_right(l, joined);
+
+        if (l->color == Color::BLACK && joined->color == Color::RED && color_of(joined->right) == Color::RED)
+        {
+            joined->right->color = Color::BLACK;
+            return rotate_left_subtree(l);
+        }
+        return l;
+    }
+    /// <summary>
+    ///   join_right:     r.
+    /// </summary>
+    static NodeRBT<T>* join_left(NodeRBT<T>* l, int l_bh, NodeRBT<T>* k, NodeRBT<T>* r, int r_bh)
+    {
+        if (color_of(r) == Color::BLACK && l_bh == r_bh)
+        {
+            k->color = Color::RED;
+            attach_left(k, l);
+            attach_right(k, r);
+            return k;
+        }
+
+        NodeRBT<T>* joined = join_left(l, l_bh, k, r->left, child_black_height(r, r_bh));
+        attach_left(r, joined);
+
+        if (r->color == Color::BLACK && joined->color == Color::RED && color_of(joined->left) == Color::RED)
+        {
+            joined->left->color = Color::BLACK;
+            return rotate_right_subtree(r);
+        }
+        return r;
+    }
+    /// <summary>
+    ///    l  r   k (  l  k,   r  k).
+    /// </summary>
+    /// <param name="l"> .</param>
+    /// <param name="l_bh">׸  l.</param>
+    /// <param name="k"> ;    .</param>
+    /// <param name="r"> .</param>
+    /// <param name="r_bh">׸  r.</param>
+    /// <param name="bh">׸  .</param>
+    /// <returns>  ;    .</returns>
+    /// <remarks>
+    ///       (Just Join for Parallel Ordered Sets),  O(|l_bh - r_bh| + 1).
+    /// </remarks>
+    static NodeRBT<T>* join_nodes(NodeRBT<T>* l, int l_bh, NodeRBT<T>* k, NodeRBT<T>* r, int r_bh, int& bh)
+    {
+        k->left = k->right = k->parent = nullptr;
+        detach(l);
+        detach(r);
+
+        if (l_bh > r_bh)
+        {
+            NodeRBT<T>* t = join_right(l, l_bh, k, r, r_bh);
+            t->parent = nullptr;
+            bh = l_bh;
+            if (t->color == Color::RED && color_of(t->right) == Color::RED)
+            {
+                t->color = Color::BLACK;
+                ++bh;
+            }
+            return t;
+        }
+        if (r_bh > l_bh)
+        {
+            NodeRBT<T>* t = join_left(l, l_bh, k, r, r_bh);
+            t->parent = nullptr;
+            bh = r_bh;
+            if (t->color == Color::RED && color_of(t->left) == Color::RED)
+            {
+                t->color = Color::BLACK;
+                ++bh;
+            }
+            return t;
+        }
+
+        k->color = (color_of(l) == Color::BLACK && color_of(r) == Color::BLACK) ? Color::RED : Color::BLACK;
+        attach_left(k, l);
+        attach_right(k, r);
+        bh = l_bh + (k->color == Color::BLACK ? 1 : 0);
+        return k;
+    }
+    /// <summary>
+    ///    t   key        key.
+    /// </summary>
+    /// <param name="t">  .</param>
+    /// <param name="bh">׸  t.</param>
+    /// <param name="key"> .</param>
+    /// <param name="l">     key.</param>
+    /// <param name="l_bh">׸  l.</param>
+    /// <param name="found">   key,     t (  );   .</param>
+    /// <param name="r">     key.</param>
+    /// <param name="r_bh">׸  r.</param>
+    void split_nodes(NodeRBT<T>* t, int bh, const T& key,
+        NodeRBT<T>*& l, int& l_bh, NodeRBT<T>*& found, NodeRBT<T>*& r, int& r_bh)
+    {
+        if (!t)
+        {
+            l = r = nullptr;
+            l_bh = r_bh = 0;
+            return;
+        }
+
+        NodeRBT<T>* t_left = detach(t->left);
+        NodeRBT<T>* t_right = detach(t->right);
+        int child_bh = child_black_height(t, bh);
+
+        if (key == t->data)
+        {
+            found = t;
+            l = t_left;
+            l_bh = child_bh;
+            r = t_right;
+            r_bh = child_bh;
+        }
+        else if (key < t->data)
+        {
+            split_nodes(t_left, child_bh, key, l, l_bh, found, r, r_bh);
+            r = join_nodes(r, r_bh, t, t_right, child_bh, r_bh);
+        }
+        else
+        {
+            split_nodes(t_right, child_bh, key, l, l_bh, found, r, r_bh);
+            l = join_nodes(t_left, child_bh, t, l, l_bh, l_bh);
+        }
+    }
+    /// <summary>
+    ///    t    .
+    /// </summary>
+    /// <param name="t">  .</param>
+    /// <param name="bh">׸  t.</param>
+    /// <param name="rest">  .</param>
+    /// <param name="rest_bh">׸  rest.</param>
+    /// <returns>    .</returns>
+    NodeRBT<T>* split_last(NodeRBT<T>* t, int bh, NodeRBT<T>*& rest, int& rest_bh)
+    {
+        NodeRBT<T>* t_left = detach(t->left);
+        NodeRBT<T>* t_right = detach(t->right);
+        int child_bh = child_black_height(t, bh);
+
+        if (!t_right)
+        {
+            rest = t_left;
+            rest_bh = child_bh;
+            return t;
+        }
+
+        NodeRBT<T>* last = split_last(t_right, child_bh, rest, rest_bh);
+        rest = join_nodes(t_left, child_bh, t, rest, rest_bh, rest_bh);
+        return last;
+    }
+    /// <summary>
+    ///   l  r    (  l   r).
+    /// </summary>
+    NodeRBT<T>* join_two(NodeRBT<T>* l, int l_bh, NodeRBT<T>* r, int r_bh, int& bh)
+    {
+        if (!l)
+        {
+            bh = r_bh;
+            return detach(r);
+        }
+
+        NodeRBT<T>* rest = nullptr;
+        int rest_bh = 0;
+        NodeRBT<T>* last = split_last(l, l_bh, rest, rest_bh);
+        return join_nodes(rest, rest_bh, last, r, r_bh, bh);
+    }
+    /// <summary>
+    ///   a  b.       a,   b .
+    /// </summary>
+    /// <param name="duplicates">    .</param>
+    NodeRBT<T>* union_nodes(NodeRBT<T>* a, int a_bh, NodeRBT<T>* b, int b_bh, int& bh, size_t& duplicates, ForkJoinPool* pool)
+    {
+        if (!a)
+        {
+            bh = b_bh;
+            return detach(b);
+        }
+        if (!b)
+        {
+            bh = a_bh;
+            return detach(a);
+        }
+
+        NodeRBT<T>* b_left = detach(b->left);
+        NodeRBT<T>* b_right = detach(b->right);
+        int b_child_bh = child_black_height(b, b_bh);
+
+        NodeRBT<T>* a_left = nullptr;
+        NodeRBT<T>* a_right = nullptr;
+        NodeRBT<T>* found = nullptr;
+        int a_left_bh = 0;
+        int a_right_bh = 0;
+        split_nodes(a, a_bh, b->data, a_left, a_left_bh, found, a_right, a_right_bh);
+
+        NodeRBT<T>* key = b;
+        if (found)
+        {
+            delete b;
+            key = found;
+            ++duplicates;
+        }
+
+        NodeRBT<T>* l = nullptr;
+        NodeRBT<T>* r = nullptr;
+        int l_bh = 0;
+        int r_bh = 0;
+        size_t l_duplicates = 0;
+        size_t r_duplicates = 0;
+        fork(pool, b_child_bh >= parallel_cutoff_bh,
+            [&] { l = union_nodes(a_left, a_left_bh, b_left, b_child_bh, l_bh, l_duplicates, pool); },
+            [&] { r = union_nodes(a_right, a_right_bh, b_right, b_child_bh, r_bh, r_duplicates, pool); });
+        duplicates += l_duplicates + r_duplicates;
+        return join_nodes(l, l_bh, key, r, r_bh, bh);
+    }
+    /// <summary>
+    ///   a  b. ,    , .
+    /// </summary>
+    /// <param name="kept">    .</param>
+    NodeRBT<T>* intersect_nodes(NodeRBT<T>* a, int a_bh, NodeRBT<T>* b, int b_bh, int& bh, size_t& kept, ForkJoinPool* pool)
+    {
+        if (!a || !b)
+        {
+            clear(a);
+            clear(b);
+            bh = 0;
+            return nullptr;
+        }
+
+        NodeRBT<T>* b_left = detach(b->left);
+        NodeRBT<T>* b_right = detach(b->right);
+        int b_child_bh = child_black_height(b, b_bh);
+
+        NodeRBT<T>* a_left = nullptr;
+        NodeRBT<T>* a_right = nullptr;
+        NodeRBT<T>* found = nullptr;
+        int a_left_bh = 0;
+        int a_right_bh = 0;
+        split_nodes(a, a_bh, b->data, a_left, a_left_bh, found, a_right, a_right_bh);
+        delete b;
+
+        NodeRBT<T>* l = nullptr;
+        NodeRBT<T>* r = nullptr;
+        int l_bh = 0;
+        int r_bh = 0;
+        size_t l_kept = 0;
+        size_t r_kept = 0;
+        fork(pool, b_child_bh >= parallel_cutoff_bh,
+            [&] { l = intersect_nodes(a_left, a_left_bh, b_left, b_child_bh, l_bh, l_kept, pool); },
+            [&] { r = intersect_nodes(a_right, a_right_bh, b_right, b_child_bh, r_bh, r_kept, pool); });
+        kept += l_kept + r_kept;
+
+        if (found)
+        {
+            ++kept;
+            return join_nodes(l, l_bh, found, r, r_bh, bh);
+        }
+        return join_two(l, l_bh, r, r_bh, bh);
+    }
+    /// <summary>
+    ///   a \ b.   b    a .
+    /// </summary>
+    /// <param name="removed">     a .</param>
+    NodeRBT<T>* difference_nodes(NodeRBT<T>* a, int a_bh, NodeRBT<T>* b, int b_bh, int& bh, size_t& removed, ForkJoinPool* pool)
+    {
+        if (!a)
+        {
+            clear(b);
+            bh = 0;
+            return nullptr;
+        }
+        if (!b)
+        {
+            bh = a_bh;
+            return detach(a);
+        }
+
+        NodeRBT<T>* b_left = detach(b->left);
+        NodeRBT<T>* b_right = detach(b->right);
+        int b_child_bh = child_black_height(b, b_bh);
+
+        NodeRBT<T>* a_left = nullptr;
+        NodeRBT<T>* a_right = nullptr;
+        NodeRBT<T>* found = nullptr;
+        int a_left_bh = 0;
+        int a_right_bh = 0;
+        split_nodes(a, a_bh, b->data, a_left, a_left_bh, found, a_right, a_right_bh);
+        delete b;
+        if (found)
+        {
+            delete found;
+            ++removed;
+        }
+
+        NodeRBT<T>* l = nullptr;
+        NodeRBT<T>* r = nullptr;
+        int l_bh = 0;
+        int r_bh = 0;
+        size_t l_removed = 0;
+        size_t r_removed = 0;
+        fork(pool, b_child_bh >= parallel_cutoff_bh,
+            [&] { l = difference_nodes(a_left, a_left_bh, b_left, b_child_bh, l_bh, l_removed, pool); },
+            [&] { r = difference_nodes(a_right, a_right_bh, b_right, b_child_bh, r_bh, r_removed, pool); });
+        removed += l_removed + r_removed;
+        return join_two(l, l_bh, r, r_bh, bh);
+    }
+    /// <summary>
     ///    .
     /// </summary>
     /// <param name="u">  .</param>
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+///      (. RBTree::save).     .
+/// </summary>
+/// <remarks>
+/// : ,  count  T ,   data_offset.      .
+/// </remarks>
+struct SortedArrayFileHeader
+{
+	static constexpr char expected_magic[8] = { 'D', 'S', 'S', 'O', 'R', 'T', '0', '1' };
+	static constexpr uint32_t byte_order_mark = 0x01020304;
+
+	char magic[8];
+	uint32_t byte_order;
+	uint32_t element_size;
+	uint64_t count;
+	uint64_t data_offset;
+	uint64_t file_size;
+};
@@ -0,0 +1,532 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+///  64-  ( MurmurHash3). :  id   .
+/// </summary>
+inline uint64_t workload_mix64(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+/// <summary>
+/// 32-    ,     32 .
+/// </summary>
+inline uint32_t workload_mix32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+	return x;
+}
+
+/// <summary>
+///     YCSB: "user"   id,    length .
+/// </summary>
+inline std::string make_string_key(uint64_t id, size_t length = 24)
+{
+	std::string digits = std::to_string(workload_mix64(id));
+	std::string key = "user";
+	if (key.size() + digits.size() < length)
+		key.append(length - key.size() - digits.size(), '0');
+	return key + digits;
+}
+
+/// <summary>
+///       id.   ,       ,
+///  -        .
+/// </summary>
+template<class Key>
+Key workload_key(uint64_t id)
+{
+	if constexpr (std::is_same_v<Key, std::string>)
+		return make_string_key(id);
+	else if constexpr (sizeof(Key) <= sizeof(uint32_t))
+		return static_cast<Key>(workload_mix32(static_cast<uint32_t>(id)));
+	else
+		return static_cast<Key>(workload_mix64(id));
+}
+
+/// <summary>
+///    [0, items).
+/// </summary>
+class UniformGenerator
+{
+private:
+	uint64_t items_;
+
+public:
+	explicit UniformGenerator(uint64_t items) : items_(std::max<uint64_t>(items, 1)) {}
+
+	template<class Rng>
+	uint64_t operator()(Rng& rng) const
+	{
+		return std::uniform_int_distribution<uint64_t>(0, items_ - 1)(rng);
+	}
+};
+
+/// <summary>
+///     [0, items):  0  ,   i 
+/// 1 / (i + 1)^theta.    . ("Quickly generating billion-record synthetic databases"),   YCSB.
+/// </summary>
+/// <remarks>
+///   O(items)   -; grow()      .
+/// </remarks>
+class ZipfianGenerator
+{
+private:
+	uint64_t items_;
+	double theta_;
+	double zeta2_;
+	double zetan_;
+	double alpha_;
+	double eta_;
+
+public:
+	explicit ZipfianGenerator(uint64_t items, double theta = 0.99)
+		: items_(0), theta_(theta), zeta2_(zeta(0, 2, theta, 0)), zetan_(0)
+	{
+		if (theta <= 0 || theta >= 1)
+			throw std::invalid_argument("ZipfianGenerator: theta must be in (0, 1)");
+		alpha_ = 1 / (1 - theta_);
+		grow(std::max<uint64_t>(items, 1));
+	}
+
+	uint64_t items() const
+	{
+		return items_;
+	}
+	/// <summary>
+	///    items  (  "").
+	/// </summary>
+	void grow(uint64_t items)
+	{
+		if (items <= items_)
+			return;
+		zetan_ = zeta(items_, items, theta_, zetan_);
+		items_ = items;
+		eta_ = (1 - std::pow(2.0 / items_, 1 - theta_)) / (1 - zeta2_ / zetan_);
+	}
+
+	template<class Rng>
+	uint64_t operator()(Rng& rng) const
+	{
+		double u = std::uniform_real_distribution<double>(0, 1)(rng);
+		double uz = u * zetan_;
+		if (uz < 1)
+			return 0;
+		if (uz < 1 + std::pow(0.5, theta_))
+			return std::min<uint64_t>(1, items_ - 1);
+		uint64_t rank = static_cast<uint64_t>(items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+		return std::min(rank, items_ - 1);
+	}
+
+private:
+	/// <summary>
+	///   1 / i^theta  i  from + 1  to     partial.
+	/// </summary>
+	static double zeta(uint64_t from, uint64_t to, double theta, double partial)
+	{
+		for (uint64_t i = from; i < to; ++i)
+			partial += 1 / std::pow(static_cast<double>(i + 1), theta);
+		return partial;
+	}
+};
+
+/// <summary>
+///  :  hot_operation_fraction      hot_set_fraction
+/// ,     .
+/// </summary>
+class HotSetGenerator
+{
+private:
+	uint64_t items_;
+	uint64_t hot_items_;
+	double hot_operation_fraction_;
+
+public:
+	HotSetGenerator(uint64_t items, double hot_set_fraction, double hot_operation_fraction)
+		: items_(std::max<uint64_t>(items, 1)), hot_operation_fraction_(hot_operation_fraction)
+	{
+		hot_items_ = std::clamp<uint64_t>(static_cast<uint64_t>(items_ * hot_set_fraction), 1, items_);
+	}
+
+	template<class Rng>
+	uint64_t operator()(Rng& rng) const
+	{
+		bool hot = std::uniform_real_distribution<double>(0, 1)(rng) < hot_operation_fraction_ || hot_items_ == items_;
+		if (hot)
+			return std::uniform_int_distribution<uint64_t>(0, hot_items_ - 1)(rng);
+		return std::uniform_int_distribution<uint64_t>(hot_items_, items_ - 1)(rng);
+	}
+};
+
+/// <summary>
+///    .
+/// </summary>
+enum class KeyDistribution
+{
+	uniform,
+	/// <summary>
+	///   ,    ,      .
+	/// </summary>
+	zipfian,
+	/// <summary>
+	///    :      .
+	/// </summary>
+	latest,
+	hot_set
+};
+
+/// <summary>
+///    .
+/// </summary>
+enum class WorkloadOpType : uint8_t
+{
+	read,
+	update,
+	insert,
+	erase,
+	scan,
+	read_modify_write
+};
+
+/// <summary>
+///  : ,   (   workload_key)   .
+/// </summary>
+struct WorkloadOp
+{
+	WorkloadOpType type = WorkloadOpType::read;
+	uint32_t scan_length = 0;
+	uint64_t id = 0;
+};
+
+/// <summary>
+///  :   (  )    .
+/// </summary>
+struct WorkloadSpec
+{
+	std::string name = "custom";
+	double read = 1;
+	double update = 0;
+	double insert = 0;
+	double erase = 0;
+	double scan = 0;
+	double read_modify_write = 0;
+	KeyDistribution distribution = KeyDistribution::zipfian;
+	double zipfian_theta = 0.99;
+	double hot_set_fraction = 0.2;
+	double hot_operation_fraction = 0.8;
+	/// <summary>
+	///      [1, max_scan_length].
+	/// </summary>
+	uint32_t max_scan_length = 100;
+
+	/// <summary>
+	///   YCSB:
+	/// A  50%  / 50% ; B  95/5; C    (   );
+	/// D  95%  / 5% ,  ; E  95%  / 5%  ();
+	/// F  50%  / 50% -- ().
+	/// </summary>
+	/// <exception cref="std::invalid_argument">   AF.</exception>
+	static WorkloadSpec ycsb(char letter)
+	{
+		WorkloadSpec spec;
+		spec.name = std::string("ycsb_") + static_cast<char>(std::tolower(static_cast<unsigned char>(letter)));
+		switch (std::toupper(static_cast<unsigned char>(letter)))
+		{
+		case 'A':
+			spec.read = 0.5;
+			spec.update = 0.5;
+			break;
+		case 'B':
+			spec.read = 0.95;
+			spec.update = 0.05;
+			break;
+		case 'C':
+			spec.read = 1;
+			break;
+		case 'D':
+			spec.read = 0.95;
+			spec.insert = 0.05;
+			spec.distribution = KeyDistribution::latest;
+			break;
+		case 'E':
+			spec.read = 0;
+			spec.scan = 0.95;
+			spec.insert = 0.05;
+			break;
+		case 'F':
+			spec.read = 0.5;
+			spec.read_modify_write = 0.5;
+			break;
+		default:
+			throw std::invalid_argument("WorkloadSpec::ycsb: unknown workload letter");
+		}
+		return spec;
+	}
+};
+
+/// <summary>
+///    :     ,   
+///      .
+/// </summary>
+struct Workload
+{
+	std::string name;
+	/// <summary>
+	///   ( 0..records-1)    .
+	/// </summary>
+	uint64_t records = 0;
+	std::vector<WorkloadOp> ops;
+
+	/// <summary>
+	///  operation_count   records  .    
+	/// records, records + 1, ...;       .
+	/// </summary>
+	static Workload generate(const WorkloadSpec& spec, uint64_t records, size_t operation_count, uint64_t seed = 42)
+	{
+		double weights[] = { spec.read, spec.update, spec.insert, spec.erase, spec.scan, spec.read_modify_write };
+		double total = 0;
+		for (double weight : weights)
+		{
+			if (weight < 0)
+				throw std::invalid_argument("Workload::generate: negative operation share");
+			total += weight;
+		}
+		if (total <= 0)
+			throw std::invalid_argument("Workload::generate: empty operation mix");
+
+		Workload workload;
+		workload.name = spec.name;
+		workload.records = std::max<uint64_t>(records, 1);
+		workload.ops.reserve(operation_count);
+
+		std::mt19937_64 rng(seed);
+		std::uniform_real_distribution<double> coin(0, total);
+		std::uniform_int_distribution<uint32_t> scan_length(1, std::max<uint32_t>(spec.max_scan_length, 1));
+		uint64_t next_id = workload.records;
+		ZipfianGenerator zipfian(workload.records, spec.zipfian_theta);
+		HotSetGenerator hot_set(workload.records, spec.hot_set_fraction, spec.hot_operation_fraction);
+		UniformGenerator uniform(workload.records);
+
+		auto choose = [&]
+			{
+				switch (spec.distribution)
+				{
+				case KeyDistribution::uniform:
+					return next_id == workload.records ? uniform(rng) : std::uniform_int_distribution<uint64_t>(0, next_id - 1)(rng);
+				case KeyDistribution::zipfian:
+					return workload_mix64(zipfian(rng)) % workload.records;
+				case KeyDistribution::latest:
+					zipfian.grow(next_id);
+					return next_id - 1 - zipfian(rng);
+				case KeyDistribution::hot_set:
+				default:
+					return hot_set(rng);
+				}
+			};
+
+		for (size_t i = 0; i < operation_count; ++i)
+		{
+			double pick = coin(rng);
+			size_t type = 0;
+			while (type + 1 < std::size(weights) && pick >= weights[type])
+				pick -= weights[type++];
+
+			WorkloadOp op;
+			op.type = static_cast<WorkloadOpType>(type);
+			if (op.type == WorkloadOpType::insert)
+				op.id = next_id++;
+			else
+				op.id = choose();
+			if (op.type == WorkloadOpType::scan)
+				op.scan_length = scan_length(rng);
+			workload.ops.push_back(op);
+		}
+		return workload;
+	}
+
+	/// <summary>
+	///     :
+	///  "records N",       "R id", "U id", "I id", "E id", "S id "  "M id".
+	/// ,   '#',  .
+	/// </summary>
+	void save_trace(const std::string& path) const
+	{
+		std::ofstream out(path);
+		if (!out)
+			throw std::runtime_error("Workload: cannot open " + path);
+		out << "# " << name << "\nrecords " << records << "\n";
+		for (const WorkloadOp& op : ops)
+		{
+			out << "RUIESM"[static_cast<size_t>(op.type)] << ' ' << op.id;
+			if (op.type == WorkloadOpType::scan)
+				out << ' ' << op.scan_length;
+			out << '\n';
+		}
+	}
+	/// <summary>
+	///  ,  save_trace         .
+	/// </summary>
+	/// <exception cref="std::runtime_error">      .</exception>
+	static Workload load_trace(const std::string& path)
+	{
+		std::ifstream in(path);
+		if (!in)
+			throw std::runtime_error("Workload: cannot open " + path);
+
+		Workload workload;
+		workload.name = path;
+		std::string word;
+		while (in >> word)
+		{
+			if (word[0] == '#')
+			{
+				std::getline(in, word);
+				continue;
+			}
+			if (word == "records")
+			{
+				if (!(in >> workload.records))
+					throw std::runtime_error("Workload: bad records line in " + path);
+				continue;
+			}
+
+			static const std::string codes = "RUIESM";
+			size_t code = word.size() == 1 ? codes.find(word[0]) : std::string::npos;
+			WorkloadOp op;
+			if (code == std::string::npos || !(in >> op.id))
+				throw std::runtime_error("Workload: bad operation '" + word + "' in " + path);
+			op.type = static_cast<WorkloadOpType>(code);
+			if (op.type == WorkloadOpType::scan && !(in >> op.scan_length))
+				throw std::runtime_error("Workload: scan without length in " + path);
+			workload.ops.push_back(op);
+		}
+		return workload;
+	}
+};
+
+/// <summary>
+///   0..records-1  :  ( operator[])   -,
+///   .
+/// </summary>
+template<class Key, class Container>
+void preload_workload(Container& container, uint64_t records)
+{
+	for (uint64_t id = 0; id < records; ++id)
+	{
+		Key key = workload_key<Key>(id);
+		if constexpr (requires { container[key]; })
+			container.emplace(key, static_cast<int>(id));
+		else
+			container.insert(key);
+	}
+}
+
+/// <summary>
+///       .  1,     
+///  ( do_not_optimize   ).
+/// </summary>
+/// <remarks>
+///    ,  update   ,  read_modify_write     .
+///         lower_bound  ;  -   
+///   id, id + 1, ... (     ).
+/// </remarks>
+template<class Key, class Container>
+size_t apply_workload_op(Container& container, const WorkloadOp& op)
+{
+	Key key = workload_key<Key>(op.id);
+	constexpr bool is_map = requires { container[key]; };
+
+	auto read = [&](const Key& k) -> size_t
+		{
+			if constexpr (requires { container.contains(k); })
+				return container.contains(k) ? 1 : 0;
+			else if constexpr (requires (typename Container::mapped_type value) { container.find(k, value); })
+			{
+				typename Container::mapped_type value{};
+				return container.find(k, value) ? 1 : 0;
+			}
+			else
+				return container.find(k) != container.end() ? 1 : 0;
+		};
+
+	switch (op.type)
+	{
+	case WorkloadOpType::read:
+		return read(key);
+	case WorkloadOpType::update:
+		if constexpr (is_map)
+		{
+			container[key] = static_cast<int>(op.id + 1);
+			return 1;
+		}
+		else
+			return read(key);
+	case WorkloadOpType::insert:
+		if constexpr (is_map)
+			container.emplace(key, static_cast<int>(op.id));
+		else
+			container.insert(key);
+		return 1;
+	case WorkloadOpType::erase:
+		return container.erase(key) ? 1 : 0;
+	case WorkloadOpType::scan:
+	{
+		size_t seen = 0;
+		if constexpr (requires { container.lower_bound(key) != container.end(); })
+		{
+			for (auto it = container.lower_bound(key); it != container.end() && seen < op.scan_length; ++it)
+				++seen;
+		}
+		else if constexpr (!is_map && requires { *container.lower_bound(key); })
+		{
+			Key from = key;
+			while (seen < op.scan_length)
+			{
+				auto next = container.lower_bound(from);
+				if (!next)
+					break;
+				++seen;
+				if (*next == std::numeric_limits<Key>::max())
+					break;
+				from = *next + 1;
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < op.scan_length; ++i)
+				seen += read(workload_key<Key>(op.id + i));
+		}
+		return seen;
+	}
+	case WorkloadOpType::read_modify_write:
+	default:
+	{
+		size_t found = read(key);
+		if constexpr (is_map)
+			container[key] = static_cast<int>(op.id + 1);
+		else
+			container.insert(key);
+		return found;
+	}
+	}
+}
@@ -0,0 +1,182 @@
+#pragma once
+// Переносимая замена Microsoft CppUnitTest.h для сборки тестов вне Visual Studio (CMake, цель ds_tests).
+// Поддерживает подмножество API, которое используют тесты: TEST_CLASS, TEST_METHOD и Assert.
+// Тесты регистрируются статическими объектами и запускаются из TestRunner.cpp.
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework {
+
+	/// <summary>
+	/// Зарегистрированный тестовый метод.
+	/// </summary>
+	struct TestCase
+	{
+		std::string class_name;
+		std::string method_name;
+		std::function<void()> run;
+	};
+
+	inline std::vector<TestCase>& registered_tests()
+	{
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	struct TestRegistrar
+	{
+		TestRegistrar(const char* class_name, const char* method_name, std::function<void()> run)
+		{
+			registered_tests().push_back({ class_name, method_name, std::move(run) });
+		}
+	};
+
+	/// <summary>
+	/// Исключение, которым Assert сообщает о проваленной проверке.
+	/// </summary>
+	class AssertFailedException : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	class Assert
+	{
+	public:
+		template<class T>
+		static void AreEqual(const T& expected, const T& actual, const wchar_t* message = nullptr)
+		{
+			if (!(expected == actual))
+				fail("AreEqual", describe(expected), describe(actual), message);
+		}
+		template<class Expected, class Actual>
+		static void AreEqual(const Expected& expected, const Actual& actual, const wchar_t* message = nullptr)
+		{
+			if (!(expected == actual))
+				fail("AreEqual", describe(expected), describe(actual), message);
+		}
+		static void AreEqual(const char* expected, const char* actual, const wchar_t* message = nullptr)
+		{
+			AreEqual(std::string(expected), std::string(actual), message);
+		}
+		template<class Expected, class Actual>
+		static void AreNotEqual(const Expected& not_expected, const Actual& actual, const wchar_t* message = nullptr)
+		{
+			if (not_expected == actual)
+				fail("AreNotEqual", "not " + describe(not_expected), describe(actual), message);
+		}
+		static void IsTrue(bool condition, const wchar_t* message = nullptr)
+		{
+			if (!condition)
+				fail("IsTrue", "true", "false", message);
+		}
+		static void IsFalse(bool condition, const wchar_t* message = nullptr)
+		{
+			if (condition)
+				fail("IsFalse", "false", "true", message);
+		}
+		template<class T>
+		static void IsNull(const T* pointer, const wchar_t* message = nullptr)
+		{
+			if (pointer != nullptr)
+				fail("IsNull", "null", "non-null", message);
+		}
+		template<class T>
+		static void IsNotNull(const T* pointer, const wchar_t* message = nullptr)
+		{
+			if (pointer == nullptr)
+				fail("IsNotNull", "non-null", "null", message);
+		}
+		[[noreturn]] static void Fail(const wchar_t* message = nullptr)
+		{
+			throw AssertFailedException("Fail" + suffix(message));
+		}
+		template<class Exception, class Functor>
+		static void ExpectException(Functor functor, const wchar_t* message = nullptr)
+		{
+			try
+			{
+				functor();
+			}
+			catch (const Exception&)
+			{
+				return;
+			}
+			catch (...)
+			{
+				throw AssertFailedException("ExpectException: a different exception was thrown" + suffix(message));
+			}
+			throw AssertFailedException("ExpectException: no exception was thrown" + suffix(message));
+		}
+
+	private:
+		template<class T>
+		static std::string describe(const T& value)
+		{
+			if constexpr (requires(std::ostream& out) { out << value; })
+			{
+				std::ostringstream out;
+				out << value;
+				return out.str();
+			}
+			else
+				return "<value>";
+		}
+		static std::string suffix(const wchar_t* message)
+		{
+			if (!message)
+				return "";
+			std::string narrow;
+			for (const wchar_t* c = message; *c; ++c)
+				narrow += *c < 128 ? static_cast<char>(*c) : '?';
+			return " - " + narrow;
+		}
+		[[noreturn]] static void fail(const char* check, const std::string& expected, const std::string& actual, const wchar_t* message)
+		{
+			throw AssertFailedException(std::string(check) + ": expected <" + expected + ">, actual <" + actual + ">" + suffix(message));
+		}
+	};
+
+	/// <summary>
+	/// База тестового класса: каждый метод выполняется на новом экземпляре, как в Visual Studio.
+	/// </summary>
+	template<class Class, class Name>
+	struct TestClass
+	{
+		using self_t = Class;
+
+		static const char* test_class_name()
+		{
+			return Name::value;
+		}
+		template<void (Class::*Method)()>
+		static void invoke()
+		{
+			Class instance;
+			(instance.*Method)();
+		}
+	};
+
+}}}
+
+#define TEST_CLASS(className) \
+	struct className##_TestClassName { static constexpr const char* value = #className; }; \
+	struct className : ::Microsoft::VisualStudio::CppUnitTestFramework::TestClass<className, className##_TestClassName>
+
+// Тело конструктора вложенной структуры — контекст полного класса, поэтому метод можно взять до его объявления.
+#define TEST_METHOD(methodName) \
+	struct methodName##_Registrar \
+	{ \
+		methodName##_Registrar() \
+		{ \
+			::Microsoft::VisualStudio::CppUnitTestFramework::TestRegistrar(test_class_name(), #methodName, &invoke<&self_t::methodName>); \
+		} \
+	}; \
+	inline static const methodName##_Registrar methodName##_registrar{}; \
+	void methodName()
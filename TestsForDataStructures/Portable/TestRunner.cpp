@@ -0,0 +1,45 @@
+// Точка входа ds_tests: запускает тесты, зарегистрированные макросами TEST_METHOD.
+// Аргументы — подстроки имени "Класс::Метод"; без аргументов выполняются все тесты.
+// Код возврата 0, если все выбранные тесты прошли, иначе 1.
+#include <exception>
+#include <iostream>
+#include <string>
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+int main(int argc, char* argv[])
+{
+	size_t run = 0, failed = 0;
+	for (const TestCase& test : registered_tests())
+	{
+		std::string name = test.class_name + "::" + test.method_name;
+		bool selected = argc < 2;
+		for (int i = 1; i < argc && !selected; ++i)
+			selected = name.find(argv[i]) != std::string::npos;
+		if (!selected)
+			continue;
+
+		++run;
+		try
+		{
+			test.run();
+			continue;
+		}
+		catch (const AssertFailedException& e)
+		{
+			std::cout << "FAILED " << name << ": " << e.what() << '\n';
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << "FAILED " << name << ": unexpected exception: " << e.what() << '\n';
+		}
+		catch (...)
+		{
+			std::cout << "FAILED " << name << ": unexpected exception\n";
+		}
+		++failed;
+	}
+	std::cout << run << " tests, " << failed << " failed\n";
+	return failed == 0 && run > 0 ? 0 : 1;
+}
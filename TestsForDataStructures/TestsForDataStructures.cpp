@@ -1,14 +1,118 @@
 ﻿#include "pch.h"
+#define DS_DEFINE_ALLOCATION_HOOKS
+#include "../DataStructures/AllocationTracker.h"
 #include "CppUnitTest.h"
+// Точки синхронизации ConcurrentSkipListSet для детерминированных тестов гонок (см. TestsForConcurrentSkipListSet).
+void skip_list_test_hook(const char* point);
+#define DS_SKIP_LIST_TEST_HOOK(point) skip_list_test_hook(point)
 #include "../DataStructures/List.h"
 #include "../DataStructures/RBTree.h"
+#include "../DataStructures/BTreeSet.h"
+#include "../DataStructures/PersistentRBTree.h"
+#include "../DataStructures/ConcurrentRBTree.h"
+#include "../DataStructures/ConcurrentSkipListSet.h"
 #include "../DataStructures//HeshTables.h"
+#include "../DataStructures/MappedHashMap.h"
+#include "../DataStructures/MappedSortedArray.h"
+#include "../DataStructures/ExternalSort.h"
+#include "../DataStructures/BenchmarkReport.h"
+#include "../DataStructures/Workload.h"
+#include "../DataStructures/ConcurrentBenchmark.h"
+#include "../DataStructures/BenchmarkDSAndSTL.h"
+#include "../DataStructures/BenchmarkCommandLine.h"
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
 #include <random>
+#include <sstream>
 #include <set>
+#include <thread>
+#include <unordered_map>
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
+/// <summary>
+/// Сценарий гонки «вставка связывает верхний уровень узла, который удаляющий поток уже пометил»:
+/// вставляющий поток останавливается перед связыванием уровня, удаляющий — перед завершением работы с узлом.
+/// </summary>
+namespace SkipListRace
+{
+	/// <summary>
+	/// 0 — сценарий не начат; 1 — вставка ждёт перед связыванием уровня; 2 — удаление ждёт перед finish;
+	/// 3 — вставка завершена.
+	/// </summary>
+	inline std::atomic<int> stage{ 0 };
+	/// <summary>
+	/// 1 — вставляющий поток сценария, 2 — удаляющий; у остальных потоков точки синхронизации ничего не делают.
+	/// </summary>
+	inline thread_local int role = 0;
+
+	inline void wait_for(int value)
+	{
+		while (stage.load() != value)
+			std::this_thread::yield();
+	}
+}
+
+void skip_list_test_hook(const char* point)
+{
+	using namespace SkipListRace;
+	if (role == 1 && std::string(point) == "link_upper_level" && stage.load() == 0)
+	{
+		stage = 1;
+		wait_for(2);
+	}
+	else if (role == 2 && std::string(point) == "erase_finish")
+	{
+		stage = 2;
+		wait_for(3);
+	}
+}
+
 namespace TestsForDataStructures
 {
+	struct LiveCounted
+	{
+		static inline int live = 0;
+		int value;
+
+		LiveCounted(int v = 0) : value(v) { ++live; }
+		LiveCounted(const LiveCounted& other) : value(other.value) { ++live; }
+		~LiveCounted() { --live; }
+		LiveCounted& operator=(const LiveCounted& other) = default;
+		auto operator<=>(const LiveCounted& other) const = default;
+	};
+	/// <summary>
+	/// Ключ, который замечает сравнение после уничтожения: так тест без ASan видит освобождённый, но достижимый узел.
+	/// </summary>
+	struct DestroyedCheckedKey
+	{
+		static inline std::atomic<bool> dead_touched{ false };
+		int value;
+		uint32_t magic = 0x5EED;
+
+		DestroyedCheckedKey(int v = 0) : value(v) {}
+		DestroyedCheckedKey(const DestroyedCheckedKey& other) : value(other.value) {}
+		~DestroyedCheckedKey() { magic = 0xDEAD; }
+		bool operator<(const DestroyedCheckedKey& other) const
+		{
+			if (magic != 0x5EED || other.magic != 0x5EED)
+				dead_touched = true;
+			return value < other.value;
+		}
+	};
+	struct CopyCounted
+	{
+		static inline int copies = 0;
+		int value;
+
+		CopyCounted(int v = 0) : value(v) {}
+		CopyCounted(const CopyCounted& other) : value(other.value) { ++copies; }
+		CopyCounted(CopyCounted&& other) noexcept = default;
+		CopyCounted& operator=(const CopyCounted& other) { value = other.value; ++copies; return *this; }
+		CopyCounted& operator=(CopyCounted&& other) noexcept = default;
+	};
 	TEST_CLASS(TestsForList)
 	{
 	public:
@@ -212,6 +316,33 @@ namespace TestsForDataStructures
 
 			Assert::AreEqual(static_cast<size_t>(0), b.size());
 		}
+		TEST_METHOD(ExtractAndInsertNodeHandle)
+		{
+			List<int> pending = { 1, 2, 3 };
+			List<int> active = { 10, 30 };
+
+			auto it = pending.begin();
+			++it;
+			const int* address = &*it;
+			auto handle = pending.extract(it);
+			Assert::AreEqual(2, handle.value());
+			Assert::AreEqual(static_cast<size_t>(2), pending.size());
+
+			auto inserted = active.insert(++active.begin(), std::move(handle));
+			Assert::IsTrue(handle.empty());
+			Assert::IsTrue(address == &*inserted);
+
+			active.insert(active.end(), pending.extract(pending.begin()));
+			active.insert(active.begin(), pending.extract(pending.begin()));
+			Assert::IsTrue(pending.empty());
+			Assert::IsTrue(pending.begin() == pending.end());
+
+			int expected[] = { 3, 10, 2, 30, 1 };
+			int i = 0;
+			for (auto x : active)
+				Assert::AreEqual(expected[i++], x);
+			Assert::AreEqual(static_cast<size_t>(5), active.size());
+		}
 
 	};
 	TEST_CLASS(TestsForRBTree)
@@ -507,6 +638,1118 @@ namespace TestsForDataStructures
 				++it_st;
 			}
 		}
+		TEST_METHOD(SplitByKey)
+		{
+			RBTree<int> tree;
+			for (int i = 1; i <= 1000; ++i)
+			{
+				tree.insert(i);
+			}
+
+			auto parts = tree.split(400);
+
+			Assert::IsTrue(tree.empty());
+			Assert::AreEqual(static_cast<size_t>(399), parts.first.size());
+			Assert::AreEqual(static_cast<size_t>(601), parts.second.size());
+			Assert::IsTrue(parts.first.validate());
+			Assert::IsTrue(parts.second.validate());
+			Assert::AreEqual(*(--parts.first.end()), 399);
+			Assert::AreEqual(*parts.second.begin(), 400);
+		}
+		TEST_METHOD(SplitPartsCountSizeAfterUpdates)
+		{
+			RBTree<int> tree;
+			for (int i = 1; i <= 1000; ++i)
+				tree.insert(i);
+
+			auto parts = tree.split(400);
+			parts.first.insert(0);
+			parts.first.erase(1);
+			parts.first.erase(2);
+			Assert::AreEqual(static_cast<size_t>(398), parts.first.size());
+
+			RBTree<int> other = { 2000, 3000 };
+			parts.second.union_with(other);
+			parts.second.erase(400);
+			RBTree<int> joined = RBTree<int>::join(parts.first, 400, parts.second);
+			Assert::AreEqual(static_cast<size_t>(0), parts.second.size());
+			Assert::AreEqual(static_cast<size_t>(1001), joined.size());
+			Assert::IsTrue(joined.validate());
+		}
+		TEST_METHOD(JoinTrees)
+		{
+			RBTree<int> left;
+			RBTree<int> right;
+			for (int i = 0; i < 10; ++i)
+			{
+				left.insert(i);
+			}
+			for (int i = 11; i < 1000; ++i)
+			{
+				right.insert(i);
+			}
+
+			RBTree<int> joined = RBTree<int>::join(left, 10, right);
+
+			Assert::IsTrue(left.empty());
+			Assert::IsTrue(right.empty());
+			Assert::AreEqual(static_cast<size_t>(1000), joined.size());
+			Assert::IsTrue(joined.validate());
+			int i = 0;
+			for (auto x : joined)
+			{
+				Assert::AreEqual(i++, x);
+			}
+		}
+		TEST_METHOD(JoinThrowsOnUnorderedKeys)
+		{
+			RBTree<int> left = { 1, 2, 3 };
+			RBTree<int> right = { 4, 5, 6 };
+
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					RBTree<int>::join(left, 4, right);
+				});
+			Assert::AreEqual(static_cast<size_t>(3), left.size());
+		}
+		TEST_METHOD(SetAlgebraMatchesStd)
+		{
+			std::mt19937 gen(42);
+			for (int round = 0; round < 20; ++round)
+			{
+				std::set<int> a;
+				std::set<int> b;
+				int a_count = gen() % 3000;
+				int b_count = gen() % 300;
+				for (int i = 0; i < a_count; ++i) a.insert(gen() % 5000);
+				for (int i = 0; i < b_count; ++i) b.insert(gen() % 5000);
+
+				std::vector<int> expected_union;
+				std::vector<int> expected_intersection;
+				std::vector<int> expected_difference;
+				std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_union));
+				std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_intersection));
+				std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_difference));
+
+				RBTree<int> u(a.begin(), a.end());
+				RBTree<int> u_other(b.begin(), b.end());
+				u.union_with(u_other);
+				Assert::IsTrue(u.validate());
+				Assert::IsTrue(u_other.empty());
+				Assert::AreEqual(expected_union.size(), u.size());
+				Assert::IsTrue(std::equal(u.begin(), u.end(), expected_union.begin()));
+
+				RBTree<int> in(b.begin(), b.end());
+				RBTree<int> in_other(a.begin(), a.end());
+				in.intersect(in_other);
+				Assert::IsTrue(in.validate());
+				Assert::AreEqual(expected_intersection.size(), in.size());
+				Assert::IsTrue(std::equal(in.begin(), in.end(), expected_intersection.begin()));
+
+				RBTree<int> d(a.begin(), a.end());
+				RBTree<int> d_other(b.begin(), b.end());
+				d.difference(d_other);
+				Assert::IsTrue(d.validate());
+				Assert::AreEqual(expected_difference.size(), d.size());
+				Assert::IsTrue(std::equal(d.begin(), d.end(), expected_difference.begin()));
+			}
+		}
+		TEST_METHOD(InsertBulk)
+		{
+			RBTree<int> tree;
+			std::set<int> expected;
+			std::mt19937 gen(42);
+			for (int i = 0; i < 1000; ++i)
+			{
+				int v = gen() % 100'000;
+				tree.insert(v);
+				expected.insert(v);
+			}
+
+			std::vector<int> batch;
+			for (int i = 0; i < 60'000; ++i)
+			{
+				batch.push_back(gen() % 100'000);
+			}
+			expected.insert(batch.begin(), batch.end());
+			tree.insert_bulk(batch.begin(), batch.end(), 4);
+
+			Assert::IsTrue(tree.validate());
+			Assert::AreEqual(expected.size(), tree.size());
+			Assert::IsTrue(std::equal(tree.begin(), tree.end(), expected.begin()));
+		}
+		TEST_METHOD(InsertBulk_EmptyTreeAllSizes)
+		{
+			for (int n = 0; n < 70; ++n)
+			{
+				std::vector<int> batch;
+				for (int i = n; i > 0; --i)
+				{
+					batch.push_back(i);
+				}
+				RBTree<int> tree;
+				tree.insert_bulk(batch.begin(), batch.end());
+
+				Assert::IsTrue(tree.validate());
+				Assert::AreEqual(static_cast<size_t>(n), tree.size());
+			}
+		}
+		TEST_METHOD(ParallelSetAlgebraMatchesSequential)
+		{
+			std::vector<int> a_keys;
+			std::vector<int> b_keys;
+			for (int i = 0; i < 100'000; ++i)
+			{
+				a_keys.push_back(i * 2);
+				b_keys.push_back(i * 3);
+			}
+
+			RBTree<int> seq(a_keys.begin(), a_keys.end());
+			RBTree<int> seq_other(b_keys.begin(), b_keys.end());
+			RBTree<int> par(a_keys.begin(), a_keys.end());
+			RBTree<int> par_other(b_keys.begin(), b_keys.end());
+			seq.union_with(seq_other);
+			par.union_with(par_other, 4);
+			Assert::IsTrue(par.validate());
+			Assert::IsTrue(seq == par);
+
+			RBTree<int> par_b(b_keys.begin(), b_keys.end());
+			par.intersect(par_b, 4);
+			Assert::IsTrue(par.validate());
+			Assert::AreEqual(b_keys.size(), par.size());
+
+			RBTree<int> par_a(a_keys.begin(), a_keys.end());
+			par.difference(par_a, 4);
+			Assert::IsTrue(par.validate());
+			std::vector<int> expected;
+			std::set_difference(b_keys.begin(), b_keys.end(), a_keys.begin(), a_keys.end(), std::back_inserter(expected));
+			Assert::AreEqual(expected.size(), par.size());
+			Assert::IsTrue(std::equal(par.begin(), par.end(), expected.begin()));
+		}
+		TEST_METHOD(SetAlgebraReusesCallerPool)
+		{
+			std::vector<int> a_keys;
+			std::vector<int> b_keys;
+			for (int i = 0; i < 100'000; ++i)
+			{
+				a_keys.push_back(i * 2);
+				b_keys.push_back(i * 3);
+			}
+
+			ForkJoinPool pool(4);
+			for (int round = 0; round < 3; ++round)
+			{
+				RBTree<int> seq(a_keys.begin(), a_keys.end());
+				RBTree<int> seq_other(b_keys.begin(), b_keys.end());
+				RBTree<int> par;
+				par.insert_bulk(a_keys.begin(), a_keys.end(), pool);
+				RBTree<int> par_other(b_keys.begin(), b_keys.end());
+				seq.union_with(seq_other);
+				par.union_with(par_other, pool);
+				Assert::IsTrue(par.validate());
+				Assert::IsTrue(seq == par);
+
+				RBTree<int> par_b(b_keys.begin(), b_keys.end());
+				par.intersect(par_b, pool);
+				Assert::AreEqual(b_keys.size(), par.size());
+
+				RBTree<int> par_a(a_keys.begin(), a_keys.end());
+				par.difference(par_a, pool);
+				Assert::IsTrue(par.validate());
+				std::vector<int> expected;
+				std::set_difference(b_keys.begin(), b_keys.end(), a_keys.begin(), a_keys.end(), std::back_inserter(expected));
+				Assert::AreEqual(expected.size(), par.size());
+				Assert::IsTrue(std::equal(par.begin(), par.end(), expected.begin()));
+			}
+		}
+		TEST_METHOD(ClearReleasesEveryNode)
+		{
+			static_assert(std::is_trivially_destructible_v<NodeRBT<int>>);
+			{
+				RBTree<LiveCounted> tree;
+				for (int i = 0; i < 10000; ++i)
+					tree.insert(LiveCounted((i * 7919) % 10007));
+				Assert::AreEqual(10000, LiveCounted::live);
+
+				tree.clear();
+				Assert::AreEqual(0, LiveCounted::live);
+				Assert::IsTrue(tree.empty());
+
+				for (int i = 0; i < 100; ++i)
+					tree.insert(LiveCounted(i));
+				Assert::IsTrue(tree.validate());
+			}
+			Assert::AreEqual(0, LiveCounted::live);
+		}
+		TEST_METHOD(HintedInsertPatterns)
+		{
+			std::mt19937 rng(5);
+			for (int pattern = 0; pattern < 4; ++pattern)
+			{
+				RBTree<int> tree;
+				std::set<int> reference;
+				auto hint = tree.end();
+				for (int i = 0; i < 3000; ++i)
+				{
+					int value = pattern == 0 ? i
+						: pattern == 1 ? -i
+						: pattern == 2 ? i * 4 + static_cast<int>(rng() % 16)
+						: static_cast<int>(rng() % 5000);
+					hint = tree.insert(hint, value);
+					reference.insert(value);
+					Assert::AreEqual(value, *hint);
+				}
+
+				Assert::IsTrue(tree.validate());
+				Assert::AreEqual(reference.size(), tree.size());
+				Assert::IsTrue(std::equal(reference.begin(), reference.end(), tree.begin()));
+			}
+		}
+		TEST_METHOD(HintedInsertDuplicateAndEndHint)
+		{
+			RBTree<int> tree{ 10, 20, 30 };
+
+			auto it = tree.insert(tree.find(20), 20);
+			Assert::AreEqual(20, *it);
+			Assert::AreEqual(static_cast<size_t>(3), tree.size());
+			Assert::AreEqual(30, *tree.insert(tree.find(10), 30));
+			Assert::AreEqual(static_cast<size_t>(3), tree.size());
+
+			Assert::AreEqual(40, *tree.insert(tree.end(), 40));
+			Assert::AreEqual(5, *tree.insert(tree.end(), 5));
+			Assert::AreEqual(25, *tree.insert(tree.begin(), 25));
+			Assert::IsTrue(tree.validate());
+			Assert::AreEqual(static_cast<size_t>(6), tree.size());
+
+			Assert::IsFalse(tree.insert_it(25).second);
+			Assert::AreEqual(static_cast<size_t>(6), tree.size());
+		}
+		TEST_METHOD(HintedFind)
+		{
+			RBTree<int> tree;
+			for (int i = 0; i < 1000; ++i)
+				tree.insert(i * 2);
+
+			auto hint = tree.find(500);
+			for (int value = -3; value < 2003; ++value)
+			{
+				auto it = tree.find(hint, value);
+				if (value >= 0 && value < 2000 && value % 2 == 0)
+					Assert::AreEqual(value, *it);
+				else
+					Assert::IsTrue(it == tree.end());
+			}
+			Assert::AreEqual(0, *tree.find(tree.end(), 0));
+			const RBTree<int>& constant = tree;
+			Assert::AreEqual(1998, *constant.find(constant.begin(), 1998));
+		}
+		TEST_METHOD(SerializeRoundTrip)
+		{
+			RBTree<int> tree;
+			std::mt19937 rng(11);
+			for (int i = 0; i < 5000; ++i)
+				tree.insert(static_cast<int>(rng()));
+			tree.insert(std::numeric_limits<int>::min());
+			tree.insert(std::numeric_limits<int>::max());
+
+			std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+			tree.serialize(stream);
+			Assert::IsTrue(stream.str().size() < tree.size() * sizeof(int));
+
+			RBTree<int> loaded = RBTree<int>::deserialize(stream);
+			Assert::IsTrue(loaded == tree);
+			Assert::AreEqual(tree.size(), loaded.size());
+			Assert::IsTrue(loaded.validate());
+
+			std::stringstream doubles(std::ios::in | std::ios::out | std::ios::binary);
+			RBTree<double> reals = { -1.5, 0.25, 3.0 };
+			reals.serialize(doubles);
+			Assert::IsTrue(RBTree<double>::deserialize(doubles) == reals);
+
+			std::stringstream empty(std::ios::in | std::ios::out | std::ios::binary);
+			RBTree<unsigned long long>().serialize(empty);
+			Assert::IsTrue(RBTree<unsigned long long>::deserialize(empty).empty());
+		}
+		TEST_METHOD(DeserializeRejectsBadStreams)
+		{
+			RBTree<int> tree = { 1, 2, 3 };
+			std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+			tree.serialize(stream);
+			std::string bytes = stream.str();
+
+			std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+			Assert::ExpectException<std::runtime_error>([&] { RBTree<int>::deserialize(truncated); });
+
+			std::istringstream other_type(bytes);
+			Assert::ExpectException<std::runtime_error>([&] { RBTree<short>::deserialize(other_type); });
+
+			std::istringstream garbage("not a tree");
+			Assert::ExpectException<std::runtime_error>([&] { RBTree<int>::deserialize(garbage); });
+		}
+		TEST_METHOD(SaveAndOpenMmap)
+		{
+			std::string path = (std::filesystem::temp_directory_path() / "ds_rbtree_save_test.bin").string();
+			RBTree<long long> tree;
+			for (long long i = 0; i < 3000; ++i)
+				tree.insert(i * 3 - 1000);
+			tree.save(path);
+
+			{
+				auto mapped = RBTree<long long>::open_mmap(path);
+				Assert::AreEqual(tree.size(), mapped.size());
+				Assert::IsTrue(std::equal(mapped.begin(), mapped.end(), tree.begin()));
+				for (long long value = -1005; value < 8005; ++value)
+				{
+					Assert::AreEqual(tree.contains(value), mapped.contains(value));
+					auto expected = tree.lower_bound(value);
+					auto actual = mapped.lower_bound(value);
+					if (expected == tree.end())
+						Assert::IsTrue(actual == mapped.end());
+					else
+						Assert::AreEqual(*expected, *actual);
+				}
+				Assert::ExpectException<std::runtime_error>([&] { RBTree<int>::open_mmap(path); });
+			}
+
+			std::filesystem::resize_file(path, 100);
+			Assert::ExpectException<std::runtime_error>([&] { RBTree<long long>::open_mmap(path); });
+			std::filesystem::remove(path);
+		}
+		TEST_METHOD(ExtractAndInsertNodeHandle)
+		{
+			RBTree<int> pending;
+			RBTree<int> active;
+			for (int i = 0; i < 200; ++i)
+			{
+				pending.insert(i);
+				if (i % 3 == 0)
+					active.insert(i);
+			}
+
+			for (int i = 0; i < 200; i += 2)
+			{
+				auto handle = pending.extract(i);
+				const int* address = &handle.value();
+				auto [it, inserted] = active.insert(std::move(handle));
+				Assert::AreEqual(i % 3 != 0, inserted);
+				Assert::AreEqual(i, *it);
+				if (inserted)
+				{
+					Assert::IsTrue(handle.empty());
+					Assert::IsTrue(address == &*it);
+				}
+				else
+				{
+					Assert::IsFalse(handle.empty());
+				}
+			}
+
+			Assert::IsTrue(pending.extract(0).empty());
+			Assert::IsTrue(pending.extract(pending.end()).empty());
+			auto handle = pending.extract(pending.begin());
+			handle.value() = 1000;
+			Assert::IsTrue(active.insert(std::move(handle)).second);
+
+			Assert::AreEqual(static_cast<size_t>(99), pending.size());
+			Assert::AreEqual(static_cast<size_t>(134), active.size());
+			Assert::IsTrue(pending.validate());
+			Assert::IsTrue(active.validate());
+			Assert::IsTrue(active.contains(1000));
+		}
+		TEST_METHOD(RangeVisitorMatchesBounds)
+		{
+			RBTree<int> tree;
+			for (int i = 0; i < 500; ++i)
+				tree.insert((i * 37) % 1000);
+
+			for (int lo = -5; lo < 1005; lo += 13)
+			{
+				for (int hi = lo - 2; hi < lo + 200; hi += 17)
+				{
+					std::vector<int> expected;
+					for (auto it = tree.lower_bound(lo); it != tree.end() && *it <= hi; ++it)
+						expected.push_back(*it);
+
+					std::vector<int> visited;
+					size_t count = tree.for_each_in_range(lo, hi, [&](const int& x) { visited.push_back(x); });
+
+					Assert::IsTrue(expected == visited);
+					Assert::AreEqual(expected.size(), count);
+					Assert::AreEqual(expected.size(), tree.count_in_range(lo, hi));
+				}
+			}
+			Assert::AreEqual(static_cast<size_t>(0), RBTree<int>().count_in_range(0, 10));
+		}
+		TEST_METHOD(RangeVisitorStopsEarly)
+		{
+			RBTree<int> tree;
+			for (int i = 0; i < 100; ++i)
+				tree.insert(i);
+
+			int sum = 0;
+			size_t visited = tree.for_each_in_range(10, 90, [&](int x)
+				{
+					sum += x;
+					return sum < 50;
+				});
+
+			Assert::AreEqual(static_cast<size_t>(5), visited);
+			Assert::AreEqual(10 + 11 + 12 + 13 + 14, sum);
+		}
+	};
+	TEST_CLASS(TestsForBTreeSet)
+	{
+	public:
+		TEST_METHOD(EmptySet)
+		{
+			BTreeSet<int> set;
+
+			Assert::AreEqual(static_cast<size_t>(0), set.size());
+			Assert::IsTrue(set.empty());
+			Assert::IsTrue(set.begin() == set.end());
+			Assert::IsTrue(set.find(10) == set.end());
+			Assert::IsTrue(set.lower_bound(10) == set.end());
+			Assert::IsFalse(set.erase(10));
+			Assert::IsTrue(set.validate());
+		}
+		TEST_METHOD(SequentialInsertIsSorted)
+		{
+			BTreeSet<int, 64> set;
+			for (int i = 1000; i >= 1; --i)
+			{
+				set.insert(i);
+			}
+			Assert::AreEqual(static_cast<size_t>(1000), set.size());
+			Assert::IsTrue(set.validate());
+
+			int i = 1;
+			for (auto x : set)
+			{
+				Assert::AreEqual(i++, x);
+			}
+		}
+		TEST_METHOD(DuplicateInsert)
+		{
+			BTreeSet<int> set = { 3, 1, 2 };
+
+			auto result = set.insert_it(2);
+
+			Assert::IsFalse(result.second);
+			Assert::AreEqual(2, *result.first);
+			Assert::AreEqual(static_cast<size_t>(3), set.size());
+		}
+		TEST_METHOD(RandomInsertEraseMatchesStdSet)
+		{
+			BTreeSet<int, 64> set;
+			std::set<int> expected;
+			std::mt19937 gen(42);
+
+			for (int i = 0; i < 20'000; ++i)
+			{
+				int v = gen() % 5000;
+				if (gen() % 3 == 0)
+				{
+					Assert::AreEqual(expected.erase(v) == 1, set.erase(v));
+				}
+				else
+				{
+					set.insert(v);
+					expected.insert(v);
+				}
+			}
+
+			Assert::IsTrue(set.validate());
+			Assert::AreEqual(expected.size(), set.size());
+			Assert::IsTrue(std::equal(set.begin(), set.end(), expected.begin()));
+		}
+		TEST_METHOD(EraseAll)
+		{
+			BTreeSet<int, 64> set;
+			for (int i = 1; i <= 1000; ++i) set.insert(i);
+			for (int i = 1; i <= 1000; ++i)
+			{
+				Assert::IsTrue(set.erase(i));
+				Assert::IsTrue(set.validate());
+			}
+			Assert::IsTrue(set.empty());
+		}
+		TEST_METHOD(LowerUpperEqual)
+		{
+			BTreeSet<int, 64> set;
+			for (int i = 0; i < 1000; ++i)
+			{
+				set.insert(i * 2);
+			}
+
+			Assert::AreEqual(10, *set.lower_bound(10));
+			Assert::AreEqual(12, *set.lower_bound(11));
+			Assert::AreEqual(12, *set.upper_bound(10));
+			Assert::IsTrue(set.upper_bound(1998) == set.end());
+			auto range = set.equal_range(10);
+			Assert::IsTrue(range.first == set.find(10));
+			Assert::IsTrue(range.second == set.find(12));
+		}
+		TEST_METHOD(BidirectionalIterators)
+		{
+			BTreeSet<int, 64> set;
+			for (int i = 0; i < 500; ++i)
+			{
+				set.insert(i);
+			}
+
+			auto it = set.end();
+			for (int i = 499; i >= 0; --i)
+			{
+				--it;
+				Assert::AreEqual(i, *it);
+			}
+			Assert::IsTrue(it == set.begin());
+
+			auto next = set.erase(set.find(250));
+			Assert::AreEqual(251, *next);
+			Assert::IsTrue(set.validate());
+		}
+		TEST_METHOD(CopyAndMove)
+		{
+			BTreeSet<int, 64> set;
+			for (int i = 0; i < 1000; ++i)
+			{
+				set.insert(i);
+			}
+
+			BTreeSet<int, 64> copy = set;
+			Assert::IsTrue(copy == set);
+
+			BTreeSet<int, 64> moved = std::move(copy);
+			Assert::IsTrue(copy.empty());
+			Assert::IsTrue(moved.validate());
+			Assert::IsTrue(moved == set);
+		}
+		TEST_METHOD(SimdKeySearchMatchesStdBounds)
+		{
+			auto check = []<class T>()
+			{
+				std::mt19937 gen(42);
+				for (size_t count = 0; count < 200; ++count)
+				{
+					std::vector<T> keys;
+					for (size_t i = 0; i < count; ++i)
+					{
+						keys.push_back(static_cast<T>(static_cast<int>(gen() % 1000) - 500));
+					}
+					std::sort(keys.begin(), keys.end());
+					keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+					for (T v = -502; v <= 502; v += 3)
+					{
+						size_t lower = std::lower_bound(keys.begin(), keys.end(), v) - keys.begin();
+						size_t upper = std::upper_bound(keys.begin(), keys.end(), v) - keys.begin();
+						Assert::AreEqual(lower, SimdKeySearch<T>::lower_bound(keys.data(), keys.size(), v));
+						Assert::AreEqual(upper, SimdKeySearch<T>::upper_bound(keys.data(), keys.size(), v));
+					}
+				}
+			};
+			check.template operator()<int64_t>();
+			check.template operator()<int32_t>();
+#if defined(DS_EXPECT_AVX2)
+			// Сборка ds_tests_avx2: проверки выше прошли через векторную ветвь.
+			Assert::IsTrue(SimdKeySearch<int64_t>::vectorized);
+			Assert::IsTrue(SimdKeySearch<int32_t>::vectorized);
+#endif
+		}
+		TEST_METHOD(SimdBTreeSetMatchesStdSet)
+		{
+			SimdBTreeSet<int64_t, 4096> set;
+			std::set<int64_t> expected;
+			std::mt19937_64 gen(42);
+
+			for (int i = 0; i < 50'000; ++i)
+			{
+				int64_t v = static_cast<int64_t>(gen() % 100'000) - 50'000;
+				set.insert(v);
+				expected.insert(v);
+			}
+			for (int i = 0; i < 10'000; ++i)
+			{
+				int64_t v = static_cast<int64_t>(gen() % 100'000) - 50'000;
+				Assert::AreEqual(expected.erase(v) == 1, set.erase(v));
+			}
+
+			Assert::IsTrue(set.validate());
+			Assert::AreEqual(expected.size(), set.size());
+			for (int64_t v = -50'001; v <= 50'001; v += 7)
+			{
+				auto it = set.lower_bound(v);
+				auto expected_it = expected.lower_bound(v);
+				Assert::AreEqual(expected_it == expected.end(), it == set.end());
+				if (it != set.end())
+				{
+					Assert::AreEqual(*expected_it, *it);
+				}
+				Assert::AreEqual(expected.count(v) == 1, set.contains(v));
+			}
+		}
+		TEST_METHOD(SimdBTreeSetFloatingPoint)
+		{
+			SimdBTreeSet<double> set;
+			for (int i = 0; i < 1000; ++i)
+			{
+				set.insert(i * 0.5);
+			}
+
+			Assert::IsTrue(set.validate());
+			Assert::AreEqual(10.0, *set.lower_bound(9.9));
+			Assert::AreEqual(10.5, *set.upper_bound(10.0));
+			Assert::IsTrue(set.find(10.25) == set.end());
+		}
+	};
+	TEST_CLASS(TestsForFrozenSet)
+	{
+	public:
+		TEST_METHOD(EmptySet)
+		{
+			FrozenSet<int> set;
+
+			Assert::IsTrue(set.empty());
+			Assert::IsTrue(set.begin() == set.end());
+			Assert::IsTrue(set.lower_bound(0) == set.end());
+			Assert::IsFalse(set.contains(0));
+		}
+		TEST_METHOD(FreezeKeepsOrderForAllShapes)
+		{
+			for (int n = 0; n < 70; ++n)
+			{
+				RBTree<int> tree;
+				for (int i = n - 1; i >= 0; --i)
+					tree.insert(i * 3);
+
+				FrozenSet<int> set = tree.freeze();
+				Assert::AreEqual(static_cast<size_t>(n), set.size());
+				Assert::IsTrue(set.validate());
+				Assert::AreEqual(static_cast<size_t>(n), tree.size());
+
+				int expected = 0;
+				for (int x : set)
+				{
+					Assert::AreEqual(expected, x);
+					expected += 3;
+				}
+				for (auto it = set.end(); it != set.begin();)
+				{
+					--it;
+					expected -= 3;
+					Assert::AreEqual(expected, *it);
+				}
+			}
+		}
+		TEST_METHOD(BoundsMatchStdSet)
+		{
+			std::mt19937 rng(7);
+			std::set<int> reference;
+			for (int i = 0; i < 5000; ++i)
+				reference.insert(static_cast<int>(rng() % 20000));
+			FrozenSet<int> set(reference.begin(), reference.end());
+
+			for (int q = -5; q < 20005; q += 3)
+			{
+				auto expected_lower = reference.lower_bound(q);
+				auto expected_upper = reference.upper_bound(q);
+				auto lower = set.lower_bound(q);
+				auto upper = set.upper_bound(q);
+
+				Assert::AreEqual(expected_lower == reference.end(), lower == set.end());
+				if (lower != set.end())
+					Assert::AreEqual(*expected_lower, *lower);
+				Assert::AreEqual(expected_upper == reference.end(), upper == set.end());
+				if (upper != set.end())
+					Assert::AreEqual(*expected_upper, *upper);
+				Assert::AreEqual(reference.count(q) == 1, set.contains(q));
+			}
+		}
+		TEST_METHOD(UnsortedRangeWithDuplicates)
+		{
+			std::vector<int> values{ 5, 1, 4, 1, 5, 9, 2, 6, 5, 3 };
+			FrozenSet<int> set(values.begin(), values.end());
+
+			Assert::AreEqual(static_cast<size_t>(7), set.size());
+			Assert::IsTrue(set.validate());
+			Assert::AreEqual(1, *set.begin());
+			Assert::AreEqual(9, *--set.end());
+			auto range = set.equal_range(5);
+			Assert::AreEqual(5, *range.first);
+			Assert::AreEqual(6, *range.second);
+		}
+	};
+	TEST_CLASS(TestsForPersistentRBTree)
+	{
+	public:
+		TEST_METHOD(RandomInsertEraseMatchesStdSet)
+		{
+			std::mt19937 rng(11);
+			PersistentRBTree<int> tree;
+			std::set<int> reference;
+			for (int step = 0; step < 20000; ++step)
+			{
+				int value = static_cast<int>(rng() % 2000);
+				if (rng() % 3 == 0)
+					Assert::AreEqual(reference.erase(value) == 1, tree.erase(value));
+				else
+				{
+					reference.insert(value);
+					tree.insert(value);
+				}
+			}
+
+			Assert::IsTrue(tree.validate());
+			Assert::AreEqual(reference.size(), tree.size());
+			Assert::IsTrue(std::equal(reference.begin(), reference.end(), tree.begin(), tree.end()));
+			Assert::IsTrue(std::equal(reference.rbegin(), reference.rend(), std::make_reverse_iterator(tree.end()), std::make_reverse_iterator(tree.begin())));
+			Assert::AreEqual(*reference.lower_bound(1000), *tree.lower_bound(1000));
+			Assert::AreEqual(*reference.upper_bound(1000), *tree.upper_bound(1000));
+		}
+		TEST_METHOD(SnapshotIsIsolated)
+		{
+			PersistentRBTree<int> tree{ 1, 2, 3, 4, 5 };
+			PersistentRBTree<int> snapshot = tree.snapshot();
+
+			tree.insert(6);
+			tree.erase(1);
+			snapshot.insert(0);
+
+			Assert::IsTrue(tree.validate());
+			Assert::IsTrue(snapshot.validate());
+			Assert::IsTrue(tree == PersistentRBTree<int>{ 2, 3, 4, 5, 6 });
+			Assert::IsTrue(snapshot == PersistentRBTree<int>{ 0, 1, 2, 3, 4, 5 });
+		}
+		TEST_METHOD(EveryVersionStaysIntact)
+		{
+			std::mt19937 rng(3);
+			PersistentRBTree<int> tree;
+			std::set<int> reference;
+			std::vector<PersistentRBTree<int>> versions;
+			std::vector<std::set<int>> expected;
+			for (int step = 0; step < 600; ++step)
+			{
+				int value = static_cast<int>(rng() % 300);
+				if (rng() % 2)
+				{
+					tree.insert(value);
+					reference.insert(value);
+				}
+				else
+				{
+					tree.erase(value);
+					reference.erase(value);
+				}
+				versions.push_back(tree.snapshot());
+				expected.push_back(reference);
+			}
+
+			for (size_t i = 0; i < versions.size(); ++i)
+			{
+				Assert::IsTrue(versions[i].validate());
+				Assert::AreEqual(expected[i].size(), versions[i].size());
+				Assert::IsTrue(std::equal(expected[i].begin(), expected[i].end(), versions[i].begin(), versions[i].end()));
+			}
+		}
+		TEST_METHOD(OldVersionsAreReclaimed)
+		{
+			{
+				PersistentRBTree<LiveCounted> tree;
+				for (int i = 0; i < 1000; ++i)
+					tree.insert(LiveCounted(i));
+				Assert::AreEqual(1000, LiveCounted::live);
+
+				{
+					PersistentRBTree<LiveCounted> snapshot = tree.snapshot();
+					Assert::AreEqual(1000, LiveCounted::live);
+
+					tree.erase(LiveCounted(500));
+					Assert::IsTrue(LiveCounted::live > 1000);
+					Assert::IsTrue(LiveCounted::live < 1000 + 64);
+				}
+				Assert::AreEqual(999, LiveCounted::live);
+
+				std::vector<PersistentRBTree<LiveCounted>> versions;
+				for (int i = 0; i < 100; ++i)
+				{
+					versions.push_back(tree.snapshot());
+					tree.insert(LiveCounted(1000 + i));
+				}
+				versions.clear();
+				Assert::AreEqual(1099, LiveCounted::live);
+				Assert::IsTrue(tree.validate());
+			}
+			Assert::AreEqual(0, LiveCounted::live);
+		}
+		TEST_METHOD(BuildFromRBTree)
+		{
+			for (int n = 0; n < 70; ++n)
+			{
+				RBTree<int> source;
+				for (int i = 0; i < n; ++i)
+					source.insert(i * 2);
+
+				PersistentRBTree<int> tree(source.cbegin(), source.cend());
+				Assert::IsTrue(tree.validate());
+				Assert::AreEqual(source.size(), tree.size());
+				Assert::IsTrue(std::equal(tree.begin(), tree.end(), source.cbegin()));
+
+				tree.insert(-1);
+				tree.erase(0);
+				Assert::IsTrue(tree.validate());
+			}
+		}
+	};
+	TEST_CLASS(TestsForConcurrentRBTree)
+	{
+	public:
+		TEST_METHOD(SingleThreadedOperations)
+		{
+			ConcurrentRBTree<int> set{ 10, 20, 30 };
+
+			Assert::IsTrue(set.insert(25));
+			Assert::IsFalse(set.insert(25));
+			Assert::IsTrue(set.erase(10));
+			Assert::IsFalse(set.erase(10));
+			Assert::AreEqual(static_cast<size_t>(3), set.size());
+			Assert::AreEqual(25, *set.find(25));
+			Assert::IsFalse(set.find(26).has_value());
+			Assert::AreEqual(25, *set.lower_bound(21));
+			Assert::AreEqual(30, *set.upper_bound(25));
+			Assert::IsFalse(set.upper_bound(30).has_value());
+
+			PersistentRBTree<int> snapshot = set.snapshot();
+			set.clear();
+			Assert::IsTrue(set.empty());
+			Assert::IsTrue(snapshot == PersistentRBTree<int>{ 20, 25, 30 });
+		}
+		TEST_METHOD(ReadersSeeWholeUpdates)
+		{
+			ConcurrentRBTree<int> set;
+			std::atomic<bool> done{ false };
+			std::atomic<int> violations{ 0 };
+
+			std::vector<std::thread> readers;
+			for (int r = 0; r < 3; ++r)
+				readers.emplace_back([&]
+					{
+						while (!done.load())
+						{
+							PersistentRBTree<int> snapshot = set.snapshot();
+							if (snapshot.size() % 2 != 0 || !snapshot.validate())
+								++violations;
+							for (int x : snapshot)
+								if (x < 100000 && !snapshot.contains(x + 100000))
+									++violations;
+							if (auto low = set.lower_bound(0); low && !set.contains(*low))
+								++violations;
+						}
+					});
+
+			for (int i = 0; i < 2000; ++i)
+			{
+				set.update([i](PersistentRBTree<int>& tree)
+					{
+						tree.insert(i);
+						tree.insert(i + 100000);
+					});
+				if (i % 3 == 0)
+					set.update([i](PersistentRBTree<int>& tree)
+						{
+							tree.erase(i / 2);
+							tree.erase(i / 2 + 100000);
+						});
+			}
+			done.store(true);
+			for (auto& reader : readers)
+				reader.join();
+
+			Assert::AreEqual(0, violations.load());
+			Assert::IsTrue(set.snapshot().validate());
+		}
+		TEST_METHOD(OldVersionsAreReclaimed)
+		{
+			{
+				ConcurrentRBTree<LiveCounted> set;
+				for (int i = 0; i < 500; ++i)
+					set.insert(LiveCounted(i));
+				for (int i = 0; i < 500; i += 2)
+					set.erase(LiveCounted(i));
+
+				EpochReclaimer::instance().synchronize();
+				Assert::AreEqual(static_cast<size_t>(0), EpochReclaimer::instance().pending());
+				Assert::AreEqual(250, LiveCounted::live);
+			}
+			Assert::AreEqual(0, LiveCounted::live);
+		}
+	};
+	TEST_CLASS(TestsForConcurrentSkipListSet)
+	{
+	public:
+		TEST_METHOD(MatchesStdSetSingleThreaded)
+		{
+			std::mt19937 rng(21);
+			ConcurrentSkipListSet<int> set;
+			std::set<int> reference;
+			for (int step = 0; step < 20000; ++step)
+			{
+				int value = static_cast<int>(rng() % 3000);
+				if (rng() % 3 == 0)
+					Assert::AreEqual(reference.erase(value) == 1, set.erase(value));
+				else
+					Assert::AreEqual(reference.insert(value).second, set.insert(value));
+			}
+
+			Assert::AreEqual(reference.size(), set.size());
+			Assert::IsTrue(std::equal(reference.begin(), reference.end(), set.begin(), set.end()));
+			for (int q = -1; q < 3001; q += 7)
+			{
+				auto lower = reference.lower_bound(q);
+				auto upper = reference.upper_bound(q);
+				Assert::AreEqual(lower == reference.end(), !set.lower_bound(q).has_value());
+				if (lower != reference.end())
+					Assert::AreEqual(*lower, *set.lower_bound(q));
+				Assert::AreEqual(upper == reference.end(), !set.upper_bound(q).has_value());
+				if (upper != reference.end())
+					Assert::AreEqual(*upper, *set.upper_bound(q));
+				Assert::AreEqual(reference.count(q) == 1, set.contains(q));
+			}
+		}
+		TEST_METHOD(ConcurrentInsertErase)
+		{
+			ConcurrentSkipListSet<int> set;
+			const int threads = 4;
+			const int per_thread = 5000;
+
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; ++t)
+				workers.emplace_back([&, t]
+					{
+						for (int i = 0; i < per_thread; ++i)
+							set.insert(i * threads + t);
+						for (int i = 0; i < per_thread; i += 2)
+							set.erase(i * threads + t);
+						for (int i = 0; i < per_thread; ++i)
+							set.insert((i % 100) * threads + t);
+					});
+			for (auto& worker : workers)
+				worker.join();
+
+			std::set<int> expected;
+			for (int t = 0; t < threads; ++t)
+			{
+				for (int i = 1; i < per_thread; i += 2)
+					expected.insert(i * threads + t);
+				for (int i = 0; i < 100; ++i)
+					expected.insert(i * threads + t);
+			}
+			Assert::AreEqual(expected.size(), set.size());
+			Assert::IsTrue(std::equal(expected.begin(), expected.end(), set.begin(), set.end()));
+		}
+		TEST_METHOD(ContendedKeysStayConsistent)
+		{
+			ConcurrentSkipListSet<int> set;
+			std::atomic<int> balance{ 0 };
+
+			std::vector<std::thread> workers;
+			for (int t = 0; t < 4; ++t)
+				workers.emplace_back([&, t]
+					{
+						std::mt19937 rng(t);
+						for (int i = 0; i < 20000; ++i)
+						{
+							int key = static_cast<int>(rng() % 64);
+							if (rng() % 2)
+								balance += set.insert(key) ? 1 : 0;
+							else
+								balance -= set.erase(key) ? 1 : 0;
+						}
+					});
+			for (auto& worker : workers)
+				worker.join();
+
+			size_t counted = 0;
+			int previous = -1;
+			for (int x : set)
+			{
+				Assert::IsTrue(previous < x);
+				previous = x;
+				++counted;
+			}
+			Assert::AreEqual(static_cast<size_t>(balance.load()), counted);
+			Assert::AreEqual(counted, set.size());
+			Assert::IsTrue(set.validate());
+		}
+		TEST_METHOD(InsertLinkingErasedNodeDoesNotLeaveItReachable)
+		{
+			using Key = DestroyedCheckedKey;
+			Key::dead_touched = false;
+			ConcurrentSkipListSet<Key> set;
+			for (int k = 0; k < 64; k += 2)
+				set.insert(Key(k));
+			SkipListRace::stage = 0;
+
+			int raced = -1;
+			std::thread inserter([&]
+				{
+					// Высота узла случайна: вставляем, пока не попадётся узел выше одного уровня.
+					for (int k = 1; k < 64 && raced < 0; k += 2)
+					{
+						SkipListRace::role = 1;
+						set.insert(Key(k));
+						SkipListRace::role = 0;
+						if (SkipListRace::stage.load() != 0)
+							raced = k;
+						else
+							set.erase(Key(k));
+					}
+					SkipListRace::stage = 3;
+				});
+			std::thread eraser([&]
+				{
+					while (SkipListRace::stage.load() == 0)
+						std::this_thread::yield();
+					if (SkipListRace::stage.load() != 1)
+						return;
+					SkipListRace::role = 2;
+					for (int k = 1; k < 64; k += 2)
+						if (set.contains(Key(k)))
+						{
+							set.erase(Key(k));
+							break;
+						}
+					SkipListRace::role = 0;
+				});
+			inserter.join();
+			eraser.join();
+			Assert::IsTrue(raced > 0);
+			// Узел, освобождаемый после synchronize, не должен оставаться связанным ни на одном уровне.
+			Assert::IsTrue(set.validate());
+
+			EpochReclaimer::instance().synchronize();
+			for (int k = 0; k < 64; ++k)
+			{
+				Assert::AreEqual(k % 2 == 0, set.contains(Key(k)));
+				set.insert(Key(k));
+			}
+			Assert::IsFalse(Key::dead_touched.load());
+			Assert::AreEqual(static_cast<size_t>(64), set.size());
+		}
+		TEST_METHOD(ErasedNodesAreReclaimed)
+		{
+			{
+				ConcurrentSkipListSet<LiveCounted> set;
+				for (int i = 0; i < 1000; ++i)
+					set.insert(LiveCounted(i));
+				for (int i = 0; i < 1000; i += 2)
+					set.erase(LiveCounted(i));
+
+				EpochReclaimer::instance().synchronize();
+				Assert::AreEqual(500, LiveCounted::live);
+			}
+			Assert::AreEqual(0, LiveCounted::live);
+		}
 	};
 	TEST_CLASS(TestsForHashTableChaining)
 	{
@@ -797,6 +2040,123 @@ namespace TestsForDataStructures
 					--it;
 				});
 		}
+		TEST_METHOD(ExtractAndInsertNodeHandle)
+		{
+			HashMapChaining<int, CopyCounted> pending;
+			HashMapChaining<int, CopyCounted> active;
+			for (int i = 0; i < 100; ++i)
+				pending[i].value = i * 10;
+			active[5].value = -1;
+
+			CopyCounted::copies = 0;
+			for (int i = 0; i < 100; ++i)
+			{
+				auto handle = pending.extract(i);
+				Assert::IsFalse(handle.empty());
+				auto [it, inserted] = active.insert(std::move(handle));
+				Assert::AreEqual(i != 5, inserted);
+				Assert::AreEqual(i, (*it).first);
+			}
+			Assert::AreEqual(0, CopyCounted::copies);
+
+			Assert::IsTrue(pending.empty());
+			Assert::AreEqual(static_cast<size_t>(100), active.size());
+			Assert::AreEqual(-1, active.at(5).value);
+			Assert::AreEqual(990, active.at(99).value);
+			Assert::IsTrue(active.extract(1000).empty());
+
+			auto handle = active.extract(active.begin());
+			handle.key() = 1000;
+			Assert::IsTrue(active.insert(std::move(handle)).second);
+			Assert::AreEqual(static_cast<size_t>(100), active.size());
+		}
+		TEST_METHOD(SaveAndOpenMmap)
+		{
+			std::string path = (std::filesystem::temp_directory_path() / "ds_hash_save_test.bin").string();
+			HashMapChaining<int, double> table;
+			for (int i = 0; i < 10000; ++i)
+				table.emplace(i * 7, i * 0.5);
+			table.save(path);
+
+			{
+				auto mapped = HashMapChaining<int, double>::open_mmap(path);
+				Assert::AreEqual(table.size(), mapped.size());
+				for (int key = -7; key < 70007; ++key)
+				{
+					double expected = 0;
+					double actual = 0;
+					bool found = table.find(key, expected);
+					Assert::AreEqual(found, mapped.find(key, actual));
+					if (found)
+						Assert::AreEqual(expected, actual);
+				}
+				Assert::AreEqual(2.5, mapped.at(35));
+				Assert::ExpectException<std::out_of_range>([&] { mapped.at(1); });
+
+				size_t visited = 0;
+				for (const auto& entry : mapped)
+				{
+					Assert::AreEqual(entry.first / 7 * 0.5, entry.second);
+					++visited;
+				}
+				Assert::AreEqual(table.size(), visited);
+
+				Assert::ExpectException<std::runtime_error>([&] { HashMapChaining<int, int>::open_mmap(path); });
+			}
+
+			HashMapChaining<int, double>().save(path);
+			Assert::IsTrue(HashMapChaining<int, double>::open_mmap(path).empty());
+
+			std::filesystem::resize_file(path, 16);
+			Assert::ExpectException<std::runtime_error>([&] { HashMapChaining<int, double>::open_mmap(path); });
+			std::filesystem::remove(path);
+			Assert::ExpectException<std::runtime_error>([&] { HashMapChaining<int, double>::open_mmap(path); });
+		}
+		TEST_METHOD(OpenMmapRejectsCorruptedOffsets)
+		{
+			std::string path = (std::filesystem::temp_directory_path() / "ds_hash_corrupt_test.bin").string();
+			HashMapChaining<int, double> table;
+			for (int i = 0; i < 1000; ++i)
+				table.emplace(i, i * 0.5);
+
+			HashFileHeader header;
+			auto save = [&]
+				{
+					table.save(path);
+					std::ifstream file(path, std::ios::binary);
+					file.read(reinterpret_cast<char*>(&header), sizeof(header));
+				};
+			auto patch = [&](uint64_t position, uint64_t value)
+				{
+					std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+					file.seekp(static_cast<std::streamoff>(position));
+					file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+				};
+			auto offset_of_bucket = [&](uint64_t bucket) { return header.offsets_offset + bucket * sizeof(uint64_t); };
+			auto rejected = [&]
+				{
+					Assert::ExpectException<std::runtime_error>([&] { HashMapChaining<int, double>::open_mmap(path); });
+				};
+
+			save();
+			Assert::AreEqual(table.size(), HashMapChaining<int, double>::open_mmap(path).size());
+
+			// (bucket_count + 1) * 8 и size * sizeof(Entry) переполняются до малых чисел.
+			patch(offsetof(HashFileHeader, bucket_count), 1ull << 61);
+			rejected();
+			save();
+			patch(offsetof(HashFileHeader, size), 1ull << 60);
+			rejected();
+
+			// Внутреннее смещение за пределами записей, затем убывающие смещения.
+			save();
+			patch(offset_of_bucket(1), 1'000'000);
+			rejected();
+			save();
+			patch(offset_of_bucket(1), table.size());
+			rejected();
+			std::filesystem::remove(path);
+		}
 		TEST_METHOD(Iterator_DecrementEnd_EmptyTable_ShouldThrow)
 		{
 			HashMapChaining<int, int> table;
@@ -809,4 +2169,563 @@ namespace TestsForDataStructures
 				});
 		}
 	};
+	TEST_CLASS(TestsForExternalSorter)
+	{
+	public:
+		TEST_METHOD(SpilledRunsMergeInOrder)
+		{
+			std::filesystem::path directory = std::filesystem::temp_directory_path() / "ds_extsort_test";
+			std::filesystem::create_directories(directory);
+
+			std::vector<int> values(20000);
+			std::mt19937 rng(5);
+			for (int& value : values)
+				value = static_cast<int>(rng() % 5000);
+			{
+				ExternalSorter<int> sorter(1024, directory);
+				sorter.push(values.begin(), values.end());
+				Assert::IsTrue(sorter.run_count() > 1);
+				Assert::AreEqual(static_cast<uint64_t>(values.size()), sorter.size());
+
+				std::vector<int> sorted;
+				sorter.copy_to(std::back_inserter(sorted));
+				std::sort(values.begin(), values.end());
+				Assert::IsTrue(values == sorted);
+				Assert::ExpectException<std::logic_error>([&] { sorter.push(1); });
+			}
+			Assert::IsTrue(std::filesystem::is_empty(directory));
+			std::filesystem::remove(directory);
+		}
+		TEST_METHOD(InMemoryAndCustomOrder)
+		{
+			ExternalSorter<int, std::greater<int>> sorter(1 << 20);
+			for (int i = 0; i < 1000; ++i)
+				sorter.push((i * 37) % 1000);
+			Assert::AreEqual(static_cast<size_t>(0), sorter.run_count());
+
+			List<int> list = sorter.to_list();
+			Assert::AreEqual(static_cast<size_t>(1000), list.size());
+			int expected = 999;
+			for (int x : list)
+				Assert::AreEqual(expected--, x);
+
+			ExternalSorter<double> empty(64);
+			Assert::IsTrue(empty.begin() == empty.end());
+			Assert::IsTrue(empty.to_list().empty());
+		}
+		TEST_METHOD(SingleRunAndManyRuns)
+		{
+			for (size_t budget : { sizeof(long long) * 64, size_t(4000), size_t(1) << 20 })
+			{
+				ExternalSorter<long long> sorter(budget);
+				for (long long i = 1000; i > 0; --i)
+					sorter.push(i);
+
+				long long expected = 1;
+				for (auto it = sorter.begin(); it != sorter.end(); ++it)
+					Assert::AreEqual(expected++, *it);
+				Assert::AreEqual(1001LL, expected);
+			}
+		}
+		TEST_METHOD(FailedSpillThrows)
+		{
+			std::filesystem::path directory = std::filesystem::temp_directory_path() / "ds_extsort_missing";
+			std::filesystem::remove_all(directory);
+
+			ExternalSorter<int> sorter(sizeof(int) * 16, directory);
+			Assert::ExpectException<std::runtime_error>([&]
+				{
+					for (int i = 0; i < 100; ++i)
+						sorter.push(i);
+				});
+			Assert::AreEqual(static_cast<size_t>(0), sorter.run_count());
+			Assert::IsFalse(std::filesystem::exists(directory));
+		}
+	};
+	TEST_CLASS(TestsForBenchmarkReport)
+	{
+	public:
+		TEST_METHOD(CsvRoundTrip)
+		{
+			BenchmarkStats stats;
+			stats.samples = { 12.5, 10.25, 11 };
+			stats.median = 11;
+			stats.mean = 11.25;
+			stats.min = 10.25;
+			stats.iterations = 40;
+			stats.repetitions = 3;
+
+			BenchmarkReporter reporter;
+			reporter.add("tree", benchmark_type_name<BTreeSet<int, 64>>(), "insert \"quoted\"", 1000, stats);
+			reporter.add("list", "List<int>", "sort", 10, BenchmarkStats{});
+			std::stringstream csv;
+			reporter.write_csv(csv);
+
+			std::vector<BenchmarkRecord> records = BenchmarkReporter::load_csv(csv);
+			Assert::AreEqual(static_cast<size_t>(2), records.size());
+			Assert::IsTrue(records[0].key() == reporter.records()[0].key());
+			Assert::IsTrue(records[0].container.find(',') != std::string::npos);
+			Assert::IsTrue(records[0].stats.samples == stats.samples);
+			Assert::AreEqual(static_cast<size_t>(40), records[0].stats.iterations);
+			Assert::AreEqual(reporter.environment().compiler, records[0].environment.compiler);
+			Assert::IsTrue(records[1].stats.samples.empty());
+
+			std::stringstream bad("name,value\n1,2\n");
+			Assert::ExpectException<std::runtime_error>([&] { BenchmarkReporter::load_csv(bad); });
+		}
+		TEST_METHOD(CompareFlagsOnlySignificantRegressions)
+		{
+			auto record = [](const std::string& scenario, std::vector<double> samples)
+				{
+					BenchmarkRecord result;
+					result.suite = "map";
+					result.container = "HashMapChaining<int, int>";
+					result.scenario = scenario;
+					result.n = 100;
+					std::vector<double> sorted = samples;
+					std::sort(sorted.begin(), sorted.end());
+					result.stats.median = sorted[sorted.size() / 2];
+					result.stats.samples = samples;
+					return result;
+				};
+			std::vector<BenchmarkRecord> baseline = {
+				record("slower", { 10, 11, 10.5, 10.2, 10.8 }),
+				record("noisy", { 10, 30, 12, 25, 11 }),
+				record("faster", { 10, 11, 10.5, 10.2, 10.8 }) };
+			std::vector<BenchmarkRecord> current = {
+				record("slower", { 13, 13.5, 12.8, 14, 13.2 }),
+				record("noisy", { 9, 31, 14, 26, 10 }),
+				record("faster", { 8, 8.2, 8.1, 7.9, 8.3 }),
+				record("new", { 1, 2, 3 }) };
+
+			std::vector<BenchmarkComparison> comparisons = compare_with_baseline(baseline, current);
+			Assert::AreEqual(static_cast<size_t>(3), comparisons.size());
+			Assert::IsTrue(comparisons[0].regression);
+			Assert::IsTrue(comparisons[0].p_value < 0.01);
+			Assert::IsFalse(comparisons[1].regression);
+			Assert::IsFalse(comparisons[2].regression);
+			Assert::IsTrue(comparisons[2].change < 0);
+
+			BenchmarkCompareOptions lenient;
+			lenient.threshold = 0.5;
+			Assert::IsFalse(compare_with_baseline(baseline, current, lenient)[0].regression);
+		}
+		TEST_METHOD(HardwareCountersCountOrFallBack)
+		{
+			PerfCounters counters;
+			Assert::IsFalse(counters.status().empty());
+
+			BenchmarkOptions options;
+			options.warmup = std::chrono::nanoseconds(0);
+			options.min_sample_time = std::chrono::nanoseconds(0);
+			options.repetitions = 2;
+			std::vector<int> values(10000, 1);
+			BenchmarkStats stats = BenchmarkRunner(options).measure([&]
+				{
+					long long sum = 0;
+					for (int value : values)
+						sum += value;
+					do_not_optimize(sum);
+				}, values.size());
+
+			if (counters.available())
+			{
+				Assert::IsTrue(stats.counters.available());
+				if (!std::isnan(stats.counters.instructions))
+					Assert::IsTrue(stats.counters.instructions > 0);
+			}
+			else
+				Assert::IsFalse(stats.counters.available());
+
+			options.hardware_counters = false;
+			Assert::IsFalse(BenchmarkRunner(options).measure([] {}, 1).counters.available());
+
+			BenchmarkReporter reporter;
+			stats.counters.cycles = 2.5;
+			stats.counters.dtlb_misses = PerfCounterValues::unavailable;
+			reporter.add("list", "List<int>", "sum", values.size(), stats);
+			std::stringstream csv;
+			reporter.write_csv(csv);
+			BenchmarkRecord record = BenchmarkReporter::load_csv(csv).front();
+			Assert::AreEqual(2.5, record.stats.counters.cycles);
+			Assert::IsTrue(std::isnan(record.stats.counters.dtlb_misses));
+		}
+		TEST_METHOD(AllocationsAreAccounted)
+		{
+			Assert::IsTrue(AllocationTracker::installed());
+
+			BenchmarkOptions options;
+			options.warmup = std::chrono::nanoseconds(0);
+			options.min_sample_time = std::chrono::nanoseconds(0);
+			options.repetitions = 1;
+			options.hardware_counters = false;
+			BenchmarkRunner runner(options);
+
+			BenchmarkStats insert = runner.measure_fresh<RBTree<int>>([](RBTree<int>&) {}, [](RBTree<int>& tree)
+				{
+					for (int i = 0; i < 100; ++i)
+						tree.insert(i);
+				}, 100);
+			Assert::IsTrue(insert.memory.tracked);
+			Assert::AreEqual(static_cast<size_t>(100), insert.memory.allocations);
+			Assert::AreEqual(static_cast<size_t>(0), insert.memory.deallocations);
+			Assert::AreEqual(100 * sizeof(NodeRBT<int>), insert.memory.bytes_allocated);
+			Assert::AreEqual(100 * sizeof(NodeRBT<int>), insert.memory.peak_bytes);
+			Assert::AreEqual(100 * sizeof(NodeRBT<int>), insert.memory.footprint_bytes);
+
+			BenchmarkStats temporary = runner.measure([]
+				{
+					std::vector<int> values(1000);
+					do_not_optimize(values.data());
+				}, 1);
+			Assert::AreEqual(static_cast<size_t>(1), temporary.memory.allocations);
+			Assert::AreEqual(static_cast<size_t>(1), temporary.memory.deallocations);
+			Assert::AreEqual(1000 * sizeof(int), temporary.memory.peak_bytes);
+			Assert::IsFalse(temporary.memory.footprint_measured);
+
+			AllocationTracker::Snapshot prepared_from = AllocationTracker::snapshot();
+			RBTree<int> prebuilt;
+			for (int i = 0; i < 100; ++i)
+				prebuilt.insert(i);
+			BenchmarkStats lookup = runner.measure([&] { do_not_optimize(prebuilt.find(50)); }, 1, prepared_from);
+			Assert::IsTrue(lookup.memory.footprint_measured);
+			Assert::AreEqual(100 * sizeof(NodeRBT<int>), lookup.memory.footprint_bytes);
+			Assert::AreEqual(static_cast<size_t>(0), lookup.memory.allocations);
+
+			BenchmarkReporter reporter;
+			reporter.add("tree", "RBTree<int>", "temporary", 1, temporary);
+			reporter.add("tree", "RBTree<int>", "find", 1, lookup);
+			std::stringstream csv;
+			reporter.write_csv(csv);
+			std::vector<BenchmarkRecord> records = BenchmarkReporter::load_csv(csv);
+			Assert::IsFalse(records[0].stats.memory.footprint_measured);
+			Assert::IsTrue(records[1].stats.memory.footprint_measured);
+			Assert::AreEqual(lookup.memory.footprint_bytes, records[1].stats.memory.footprint_bytes);
+
+			struct alignas(64) Aligned
+			{
+				char data[64];
+			};
+			AllocationTracker::Snapshot before = AllocationTracker::snapshot();
+			delete new Aligned;
+			AllocationTracker::Snapshot after = AllocationTracker::snapshot();
+			Assert::AreEqual(before.live_bytes, after.live_bytes);
+			Assert::AreEqual(before.allocations + 1, after.allocations);
+
+			// Размер, который вместе с заголовком блока не помещается в size_t, отклоняется, а не усекается.
+			volatile size_t huge = std::numeric_limits<size_t>::max() - 8;
+			Assert::ExpectException<std::bad_alloc>([&] { ::operator delete(::operator new(huge)); });
+			Assert::ExpectException<std::bad_alloc>([&]
+				{
+					::operator delete(::operator new(huge, std::align_val_t(64)), std::align_val_t(64));
+				});
+			Assert::AreEqual(after.allocations, AllocationTracker::snapshot().allocations);
+		}
+		TEST_METHOD(LatencyHistogramPercentiles)
+		{
+			LatencyHistogram histogram;
+			for (uint64_t value = 1; value <= 100000; ++value)
+				histogram.record(value);
+			Assert::AreEqual(static_cast<uint64_t>(100000), histogram.count());
+			Assert::AreEqual(static_cast<uint64_t>(1), histogram.min());
+			Assert::AreEqual(static_cast<uint64_t>(100000), histogram.max());
+			for (double p : { 50.0, 90.0, 99.0, 99.9 })
+			{
+				double exact = p * 1000;
+				Assert::IsTrue(std::abs(histogram.percentile(p) - exact) <= exact / 128);
+			}
+
+			LatencyHistogram small;
+			small.record(7, 3);
+			Assert::AreEqual(static_cast<uint64_t>(7), small.percentile(50));
+			small.record(1ull << 40);
+			histogram.merge(small);
+			Assert::AreEqual(static_cast<uint64_t>(100004), histogram.count());
+			Assert::AreEqual(static_cast<uint64_t>(1ull << 40), histogram.percentile(100));
+
+			BenchmarkOptions options;
+			options.repetitions = 2;
+			options.hardware_counters = false;
+			LatencyStats stats = BenchmarkRunner(options).measure_latency<std::vector<int>>([](std::vector<int>&) {},
+				[](std::vector<int>& values, size_t i) { values.push_back(static_cast<int>(i)); }, 1000, 10);
+			Assert::AreEqual(static_cast<uint64_t>(2000), stats.count);
+			Assert::AreEqual(static_cast<size_t>(10), stats.batch);
+			Assert::IsTrue(stats.p50 <= stats.p99 && stats.p99 <= stats.max);
+			Assert::IsTrue(stats.timer_overhead >= 0);
+		}
+		TEST_METHOD(VariantTableComparesBuilds)
+		{
+			auto record = [](const std::string& container, const std::string& scenario, double median)
+				{
+					BenchmarkRecord result;
+					result.suite = "tree";
+					result.container = container;
+					result.scenario = scenario;
+					result.n = 1000;
+					result.stats.median = median;
+					return result;
+				};
+			std::vector<BenchmarkVariant> variants = {
+				{ "O2", { record("RBTree<int>", "find", 40), record("RBTree<int>", "insert", 100) } },
+				{ "O3", { record("RBTree<int>", "insert", 50), record("RBTree<int>", "find", 20) } },
+				{ "O3-pgo", { record("RBTree<int>", "find", 30), record("List<int>", "find", 7) } } };
+
+			std::vector<VariantComparisonRow> rows = compare_variants(variants);
+			Assert::AreEqual(static_cast<size_t>(3), rows.size());
+			Assert::AreEqual(std::string("find"), rows[0].scenario);
+			Assert::AreEqual(20.0, rows[0].medians[1]);
+			Assert::AreEqual(static_cast<size_t>(1), rows[0].best);
+			Assert::AreEqual(std::string("insert"), rows[1].scenario);
+			Assert::IsTrue(std::isnan(rows[1].medians[2]));
+			Assert::AreEqual(std::string("List<int>"), rows[2].container);
+			Assert::AreEqual(static_cast<size_t>(2), rows[2].best);
+
+			std::ostringstream table;
+			print_variant_table(table, variants);
+			Assert::IsTrue(table.str().find("x2.000") != std::string::npos);
+			Assert::IsTrue(table.str().find("x1.33") != std::string::npos);
+		}
+	};
+	TEST_CLASS(TestsForWorkload)
+	{
+	public:
+		TEST_METHOD(GeneratorsFollowSpec)
+		{
+			ZipfianGenerator zipfian(1000);
+			std::mt19937_64 rng(7);
+			std::vector<int> hits(1000);
+			for (int i = 0; i < 200000; ++i)
+				++hits[zipfian(rng)];
+			Assert::IsTrue(hits[0] > hits[1] && hits[1] > hits[10] && hits[10] > hits[500]);
+			Assert::IsTrue(std::abs(hits[0] / static_cast<double>(hits[9]) - 10) < 1.5);
+
+			Workload d = Workload::generate(WorkloadSpec::ycsb('D'), 1000, 20000);
+			size_t inserts = 0;
+			uint64_t next_id = 1000;
+			for (const WorkloadOp& op : d.ops)
+			{
+				if (op.type == WorkloadOpType::insert)
+				{
+					Assert::AreEqual(next_id++, op.id);
+					++inserts;
+				}
+				else
+				{
+					Assert::IsTrue(op.type == WorkloadOpType::read);
+					Assert::IsTrue(op.id < next_id);
+				}
+			}
+			Assert::IsTrue(inserts > 800 && inserts < 1200);
+
+			WorkloadSpec hot;
+			hot.distribution = KeyDistribution::hot_set;
+			hot.hot_set_fraction = 0.1;
+			hot.hot_operation_fraction = 0.9;
+			Workload h = Workload::generate(hot, 1000, 10000);
+			size_t in_hot_set = std::count_if(h.ops.begin(), h.ops.end(), [](const WorkloadOp& op) { return op.id < 100; });
+			Assert::IsTrue(in_hot_set > 8700 && in_hot_set < 9300);
+
+			std::set<int> keys;
+			for (uint64_t id = 0; id < 10000; ++id)
+				keys.insert(workload_key<int>(id));
+			Assert::AreEqual(static_cast<size_t>(10000), keys.size());
+			Assert::AreEqual(static_cast<size_t>(24), make_string_key(5).size());
+			Assert::ExpectException<std::invalid_argument>([] { WorkloadSpec::ycsb('G'); });
+		}
+		TEST_METHOD(TraceRoundTripAndReplay)
+		{
+			WorkloadSpec spec;
+			spec.read = 2;
+			spec.insert = 1;
+			spec.erase = 1;
+			spec.scan = 1;
+			spec.read_modify_write = 1;
+			spec.distribution = KeyDistribution::uniform;
+			Workload workload = Workload::generate(spec, 500, 3000);
+
+			std::string path = (std::filesystem::temp_directory_path() / "ds_workload_trace.txt").string();
+			workload.save_trace(path);
+			Workload loaded = Workload::load_trace(path);
+			std::filesystem::remove(path);
+			Assert::AreEqual(workload.records, loaded.records);
+			Assert::AreEqual(workload.ops.size(), loaded.ops.size());
+			for (size_t i = 0; i < workload.ops.size(); ++i)
+			{
+				Assert::IsTrue(workload.ops[i].type == loaded.ops[i].type);
+				Assert::AreEqual(workload.ops[i].id, loaded.ops[i].id);
+				Assert::AreEqual(workload.ops[i].scan_length, loaded.ops[i].scan_length);
+			}
+
+			RBTree<int> tree;
+			std::set<int> expected_set;
+			HashMapChaining<int, int> map;
+			std::unordered_map<int, int> expected_map;
+			std::map<int, int> ordered_map;
+			preload_workload<int>(tree, loaded.records);
+			preload_workload<int>(expected_set, loaded.records);
+			preload_workload<int>(map, loaded.records);
+			preload_workload<int>(expected_map, loaded.records);
+			preload_workload<int>(ordered_map, loaded.records);
+			for (const WorkloadOp& op : loaded.ops)
+			{
+				size_t expected = apply_workload_op<int>(expected_set, op);
+				Assert::AreEqual(expected, apply_workload_op<int>(tree, op));
+				// Упорядоченное отображение сканирует так же, как множество, а не точечными чтениями.
+				Assert::AreEqual(expected, apply_workload_op<int>(ordered_map, op));
+				if (op.type != WorkloadOpType::scan)
+					Assert::AreEqual(apply_workload_op<int>(expected_map, op), apply_workload_op<int>(map, op));
+			}
+			Assert::AreEqual(expected_set.size(), tree.size());
+			Assert::AreEqual(expected_map.size(), map.size());
+			Assert::AreEqual(expected_set.size(), ordered_map.size());
+		}
+	};
+	TEST_CLASS(TestsForConcurrentBenchmark)
+	{
+	public:
+		struct Recorded
+		{
+			static inline std::atomic<size_t> destroyed_items{ 0 };
+			std::vector<size_t> items;
+
+			~Recorded() { destroyed_items += items.size(); }
+		};
+
+		TEST_METHOD(EveryThreadRunsItsOperations)
+		{
+			ConcurrentOptions options;
+			options.ops_per_thread = 2000;
+			options.repetitions = 2;
+			ConcurrentBenchmark<Recorded, MutexPolicy> benchmark(options);
+			for (ContainerSharing sharing : { ContainerSharing::shared, ContainerSharing::per_thread })
+			{
+				Recorded::destroyed_items = 0;
+				ConcurrentStats stats = benchmark.run(3, sharing, [](Recorded& recorded) { recorded.items.reserve(16); },
+					[](auto& access, size_t thread, size_t i)
+					{
+						access.write([&](Recorded& recorded) { recorded.items.push_back(thread * 1'000'000 + i); });
+					});
+
+				Assert::AreEqual(static_cast<size_t>(2 * 3 * 2000), Recorded::destroyed_items.load());
+				Assert::AreEqual(static_cast<size_t>(3), stats.per_thread.size());
+				Assert::AreEqual(static_cast<uint64_t>(2 * 3 * 2000), stats.latency.count);
+				Assert::AreEqual(static_cast<size_t>(2), stats.per_op.samples.size());
+				Assert::IsTrue(stats.throughput > 0);
+				for (const ConcurrentThreadStats& thread : stats.per_thread)
+				{
+					Assert::AreEqual(static_cast<size_t>(4000), thread.operations);
+					Assert::AreEqual(static_cast<uint64_t>(4000), thread.latency.count);
+				}
+			}
+
+			Assert::IsTrue(ConcurrentBenchmark<Recorded>::thread_counts(6) == std::vector<size_t>{ 1, 2, 4, 6 });
+			Assert::IsTrue(ConcurrentBenchmark<Recorded>::thread_counts(1) == std::vector<size_t>{ 1 });
+		}
+	};
+	TEST_CLASS(TestsForBenchmarkRegistry)
+	{
+	public:
+		TEST_METHOD(CommandLineSizesAndErrors)
+		{
+			const char* sweep[] = { "bench", "--sweep", "1K:100M", "--suite", "tree", "--repetitions", "2" };
+			BenchmarkCommandLine command_line = BenchmarkCommandLine::parse(7, sweep);
+			Assert::IsTrue(command_line.sizes == std::vector<size_t>{ 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000 });
+			Assert::AreEqual(std::string("tree"), command_line.filter.suite);
+			Assert::AreEqual(static_cast<size_t>(2), command_line.options.repetitions);
+			Assert::IsTrue(command_line.forwarded == std::vector<std::string>{ "--repetitions", "2" });
+
+			const char* list[] = { "bench", "--n", "1K,2M,300", "--isolate" };
+			command_line = BenchmarkCommandLine::parse(4, list);
+			Assert::IsTrue(command_line.sizes == std::vector<size_t>{ 1'000, 2'000'000, 300 });
+			Assert::IsTrue(command_line.isolate);
+			Assert::IsTrue(BenchmarkCommandLine::geometric_sizes(1, 10, 2) == std::vector<size_t>{ 1, 2, 4, 8 });
+
+			const char* unknown[] = { "bench", "--frobnicate" };
+			Assert::ExpectException<std::invalid_argument>([&] { BenchmarkCommandLine::parse(2, unknown); });
+			const char* missing[] = { "bench", "--n" };
+			Assert::ExpectException<std::invalid_argument>([&] { BenchmarkCommandLine::parse(2, missing); });
+			Assert::ExpectException<std::invalid_argument>([] { BenchmarkCommandLine::parse_size("10X"); });
+			std::string largest = std::to_string(std::numeric_limits<size_t>::max() / 1000);
+			Assert::AreEqual(std::numeric_limits<size_t>::max() / 1000 * 1000, BenchmarkCommandLine::parse_size(largest + "K"));
+			Assert::ExpectException<std::out_of_range>([&]
+				{
+					BenchmarkCommandLine::parse_size(std::to_string(std::numeric_limits<size_t>::max() / 1000 + 1) + "K");
+				});
+		}
+		TEST_METHOD(RegisteredSuitesRunSelectedContainers)
+		{
+			BenchmarkRegistry registry;
+			size_t added = register_benchmark_suite<RBTreeBenchmark, RBTree<int>, std::set<int>, BTreeSet<int, 64>>("tree", registry);
+			Assert::AreEqual(added, registry.entries().size());
+			Assert::AreEqual(static_cast<size_t>(3), registry.select({ "^tree$", "^find$", "" }).size());
+			Assert::AreEqual(static_cast<size_t>(1), registry.select({ "", "^find$", "^BTreeSet" }).size());
+			Assert::AreEqual(static_cast<size_t>(0), registry.select({ "map", "", "" }).size());
+
+			BenchmarkCase benchmark = registry.make_case(registry.select({ "", "^insert$", "^RBTree" }).front(), 123, {});
+			Assert::AreEqual(static_cast<size_t>(123), benchmark.n);
+
+			const char* args[] = { "bench", "--scenario", "^(find|erase)$", "--container", "^(RBTree|std::set)", "--n", "500,1K",
+				"--repetitions", "2", "--min-time-ms", "1", "--warmup-ms", "0", "--no-counters" };
+			BenchmarkDriver driver(BenchmarkCommandLine::parse(14, args), "bench", registry);
+			Assert::AreEqual(0, driver.run());
+			const std::vector<BenchmarkRecord>& records = driver.reporter().records();
+			Assert::AreEqual(static_cast<size_t>(8), records.size());
+			Assert::AreEqual(std::string("erase"), records[0].scenario);
+			Assert::AreEqual(static_cast<size_t>(500), records[0].n);
+			Assert::AreEqual(std::string("std::set<int>"), records[1].container);
+			Assert::AreEqual(static_cast<size_t>(1000), records[2].n);
+			Assert::AreEqual(std::string("find"), records[4].scenario);
+
+			// Ошибки сохранения отчёта и чтения базовой линии — код 2, а не исключение из run().
+			const char* unsaved[] = { "bench", "--scenario", "^find$", "--container", "^RBTree", "--n", "100",
+				"--min-time-ms", "0", "--warmup-ms", "0", "--no-counters", "--csv", "results.txt" };
+			Assert::AreEqual(2, BenchmarkDriver(BenchmarkCommandLine::parse(14, unsaved), "bench", registry).run());
+			std::string missing = (std::filesystem::temp_directory_path() / "ds_missing_baseline.csv").string();
+			const char* no_baseline[] = { "bench", "--scenario", "^find$", "--container", "^RBTree", "--n", "100",
+				"--min-time-ms", "0", "--warmup-ms", "0", "--no-counters", "--baseline", missing.c_str() };
+			Assert::AreEqual(2, BenchmarkDriver(BenchmarkCommandLine::parse(14, no_baseline), "bench", registry).run());
+		}
+		TEST_METHOD(ModesRunSelectedPairs)
+		{
+			BenchmarkRegistry registry;
+			std::vector<BenchmarkModeArgs> seen;
+			auto record = [&](const BenchmarkModeArgs& args, BenchmarkReporter&) { seen.push_back(args); };
+			registry.add_mode({ "concurrent", "tree", "ConcurrentSkipListSet<int> vs RBTree<int>", true, record });
+			registry.add_mode({ "concurrent", "map", "HashMapChaining<int, int> vs std::unordered_map<int, int>", true, record });
+			registry.add_mode({ "external-sort", "external_sort", "ExternalSorter<uint64_t>", false, record });
+			register_benchmark_mode<MapBenchmark, HashMapChaining<int, int>, std::unordered_map<int, int>>("latency", "map",
+				[](auto& benchmark, const BenchmarkModeArgs&) { benchmark.run_latency(); }, registry);
+
+			const char* concurrent[] = { "bench", "--mode", "concurrent", "--container", "SkipList", "--threads", "64", "--n", "1K,2K" };
+			Assert::AreEqual(0, BenchmarkDriver(BenchmarkCommandLine::parse(9, concurrent), "bench", registry).run());
+			Assert::AreEqual(static_cast<size_t>(2), seen.size());
+			Assert::AreEqual(static_cast<size_t>(64), seen[0].threads);
+			Assert::AreEqual(static_cast<size_t>(1000), seen[0].n);
+			Assert::AreEqual(static_cast<size_t>(2000), seen[1].n);
+
+			seen.clear();
+			const char* sort[] = { "bench", "--mode", "external-sort", "--bytes", "1G,100G", "--n", "1K,2K",
+				"--budget", "16M", "--temp-dir", "runs" };
+			Assert::AreEqual(0, BenchmarkDriver(BenchmarkCommandLine::parse(11, sort), "bench", registry).run());
+			Assert::AreEqual(static_cast<size_t>(1), seen.size());
+			Assert::IsTrue(seen[0].bytes == std::vector<uint64_t>{ 1'000'000'000, 100'000'000'000 });
+			Assert::AreEqual(static_cast<size_t>(16'000'000), seen[0].budget);
+			Assert::AreEqual(std::string("runs"), seen[0].temp_directory);
+			Assert::IsTrue(BenchmarkCommandLine::parse(1, sort).budget < BenchmarkCommandLine::parse(1, sort).bytes.front());
+			const char* no_budget[] = { "bench", "--budget", "0" };
+			Assert::ExpectException<std::invalid_argument>([&] { BenchmarkCommandLine::parse(3, no_budget); });
+
+			const char* latency[] = { "bench", "--mode", "latency", "--n", "200", "--repetitions", "1" };
+			BenchmarkDriver driver(BenchmarkCommandLine::parse(7, latency), "bench", registry);
+			Assert::AreEqual(0, driver.run());
+			Assert::AreEqual(static_cast<size_t>(4), driver.reporter().latency_records().size());
+
+			const char* unknown[] = { "bench", "--mode", "bogus" };
+			Assert::AreEqual(2, BenchmarkDriver(BenchmarkCommandLine::parse(3, unknown), "bench", registry).run());
+			const char* unmatched[] = { "bench", "--mode", "concurrent", "--suite", "^list$" };
+			Assert::AreEqual(2, BenchmarkDriver(BenchmarkCommandLine::parse(5, unmatched), "bench", registry).run());
+			const char* no_trace[] = { "bench", "--mode", "trace" };
+			Assert::ExpectException<std::invalid_argument>([&] { BenchmarkCommandLine::parse(3, no_trace); });
+		}
+	};
 }
@@ -0,0 +1,114 @@
+# Матрица вариантов сборки ds_bench: собирает каждый вариант в отдельном каталоге, запускает на нём одни и те же
+# бенчмарки и печатает одну таблицу сравнения (ds_bench --variant).
+#
+#   cmake -P cmake/BenchVariants.cmake                      # из корня репозитория
+#   cmake --build build --target ds_bench_variants          # то же из настроенной сборки
+#
+# Варианты добавляют флаги по одному, поэтому столбец таблицы показывает вклад очередного флага:
+#   O2                 -O2
+#   O3                 -O3
+#   O3-native          -O3 -march=native
+#   O3-native-lto      -O3 -march=native, LTO
+#   O3-native-lto-pgo  то же с PGO: инструментированная сборка, прогон DS_PGO_TRAINING_ARGS, сборка с профилем
+#
+# Параметры (-D...):
+#   DS_SOURCE_DIR          корень репозитория (по умолчанию — родитель каталога скрипта);
+#   DS_VARIANTS_DIR        каталог сборок, CSV и таблицы (по умолчанию ./bench-variants);
+#   DS_VARIANTS            подмножество вариантов (список через ';'), первый — база для ускорений;
+#   DS_VARIANT_ARGS        аргументы ds_bench для замеров (по умолчанию наборы list/tree/map для List, RBTree
+#                          и HashMapChaining);
+#   DS_PGO_TRAINING_ARGS   аргументы обучающего прогона PGO (по умолчанию DS_VARIANT_ARGS с одним повтором);
+#   CMAKE_CXX_COMPILER, DS_VARIANT_GENERATOR — компилятор и генератор вложенных сборок.
+# Результат: DS_VARIANTS_DIR/<вариант>.csv и таблица DS_VARIANTS_DIR/variants.txt. Вывод вложенных сборок, включая
+# предупреждения компилятора, печатается как есть.
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT DS_SOURCE_DIR)
+	get_filename_component(DS_SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+endif()
+if(NOT DS_VARIANTS_DIR)
+	set(DS_VARIANTS_DIR "${CMAKE_BINARY_DIR}/bench-variants")
+endif()
+get_filename_component(DS_VARIANTS_DIR "${DS_VARIANTS_DIR}" ABSOLUTE)
+set(ds_all_variants O2 O3 O3-native O3-native-lto O3-native-lto-pgo)
+if(NOT DS_VARIANTS)
+	set(DS_VARIANTS ${ds_all_variants})
+endif()
+if(NOT DS_VARIANT_ARGS)
+	set(DS_VARIANT_ARGS --suite "^(list|tree|map)$" --container "^(List|RBTree|HashMapChaining)<")
+endif()
+if(NOT DS_PGO_TRAINING_ARGS)
+	set(DS_PGO_TRAINING_ARGS ${DS_VARIANT_ARGS} --repetitions 1 --no-counters)
+endif()
+
+set(ds_configure_args -DCMAKE_BUILD_TYPE=Release -DDS_BUILD_TESTS=OFF)
+if(CMAKE_CXX_COMPILER)
+	list(APPEND ds_configure_args "-DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}")
+endif()
+if(DS_VARIANT_GENERATOR)
+	list(APPEND ds_configure_args -G "${DS_VARIANT_GENERATOR}")
+endif()
+
+function(ds_check result what)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "${what} failed (${result})")
+	endif()
+endfunction()
+
+# Настраивает и собирает ds_bench в DS_VARIANTS_DIR/<name>; путь к программе — в <name>_program.
+function(ds_build_variant name)
+	set(dir "${DS_VARIANTS_DIR}/${name}")
+	message(STATUS "Building variant ${name}: ${ARGN}")
+	execute_process(COMMAND "${CMAKE_COMMAND}" -S "${DS_SOURCE_DIR}" -B "${dir}" ${ds_configure_args} ${ARGN}
+		RESULT_VARIABLE result)
+	ds_check("${result}" "configuring ${name}")
+	execute_process(COMMAND "${CMAKE_COMMAND}" --build "${dir}" --config Release --target ds_bench --parallel
+		RESULT_VARIABLE result)
+	ds_check("${result}" "building ${name}")
+	foreach(candidate "${dir}/ds_bench" "${dir}/ds_bench.exe" "${dir}/Release/ds_bench.exe")
+		if(EXISTS "${candidate}")
+			set(${name}_program "${candidate}" PARENT_SCOPE)
+			return()
+		endif()
+	endforeach()
+	message(FATAL_ERROR "ds_bench of variant ${name} not found in ${dir}")
+endfunction()
+
+file(MAKE_DIRECTORY "${DS_VARIANTS_DIR}")
+set(ds_variant_table_args)
+foreach(variant IN LISTS DS_VARIANTS)
+	if(variant STREQUAL "O2")
+		ds_build_variant(${variant} -DDS_BENCH_OPTIMIZATION=O2 -DDS_MARCH= -DDS_LTO=OFF -DDS_PGO=OFF)
+	elseif(variant STREQUAL "O3")
+		ds_build_variant(${variant} -DDS_BENCH_OPTIMIZATION=O3 -DDS_MARCH= -DDS_LTO=OFF -DDS_PGO=OFF)
+	elseif(variant STREQUAL "O3-native")
+		ds_build_variant(${variant} -DDS_BENCH_OPTIMIZATION=O3 -DDS_MARCH=native -DDS_LTO=OFF -DDS_PGO=OFF)
+	elseif(variant STREQUAL "O3-native-lto")
+		ds_build_variant(${variant} -DDS_BENCH_OPTIMIZATION=O3 -DDS_MARCH=native -DDS_LTO=ON -DDS_PGO=OFF)
+	elseif(variant STREQUAL "O3-native-lto-pgo")
+		# Старый профиль другой сборки дал бы несогласованные счётчики.
+		set(profile "${DS_VARIANTS_DIR}/pgo-profile")
+		file(REMOVE_RECURSE "${profile}")
+		set(pgo_flags -DDS_BENCH_OPTIMIZATION=O3 -DDS_MARCH=native -DDS_LTO=ON "-DDS_PGO_DIR=${profile}")
+		ds_build_variant(${variant}-generate ${pgo_flags} -DDS_PGO=GENERATE)
+		message(STATUS "Training run of ${variant}: ${DS_PGO_TRAINING_ARGS}")
+		execute_process(COMMAND "${${variant}-generate_program}" ${DS_PGO_TRAINING_ARGS} OUTPUT_QUIET RESULT_VARIABLE result)
+		ds_check("${result}" "PGO training run")
+		ds_build_variant(${variant} ${pgo_flags} -DDS_PGO=USE)
+	else()
+		message(FATAL_ERROR "unknown variant '${variant}', expected one of: ${ds_all_variants}")
+	endif()
+
+	set(csv "${DS_VARIANTS_DIR}/${variant}.csv")
+	message(STATUS "Running variant ${variant}: ${DS_VARIANT_ARGS}")
+	execute_process(COMMAND "${${variant}_program}" ${DS_VARIANT_ARGS} --csv "${csv}" OUTPUT_QUIET RESULT_VARIABLE result)
+	ds_check("${result}" "benchmarks of ${variant}")
+	list(APPEND ds_variant_table_args --variant "${variant}=${csv}")
+endforeach()
+
+list(GET DS_VARIANTS 0 base)
+execute_process(COMMAND "${${base}_program}" ${ds_variant_table_args} OUTPUT_VARIABLE table RESULT_VARIABLE result)
+ds_check("${result}" "variant table")
+file(WRITE "${DS_VARIANTS_DIR}/variants.txt" "${table}")
+message("${table}")
+message(STATUS "Variant table written to ${DS_VARIANTS_DIR}/variants.txt")